@@ -138,6 +138,10 @@ Note: All current deprecated methods will be removed in the next version. So mak
 update your uses and use a VSTGUI::CMultiFrameBitmap instead.
 - If you compile with VSTGUI_ENABLE_DEPRECATED_METHODS=0 you need to update your multi frame bitmaps
 to use VSTGUI::CMultiFrameBitmap.
+- In 4.12.3 the children of CViewContainer are stored in a VSTGUI::ChildViewList, which
+CViewContainer::getChildViews returns. CViewContainer::getChildren still returns a
+const CViewContainer::ViewList&, but builds it from the child view list when the children have
+changed, so prefer getChildViews.
 - In 4.12.2 the following constructors have lost their offset parameter:
 	- CKickButton
 	- CAnimKnob
@@ -3,12 +3,18 @@
 // distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
 
 #include "cbitmap.h"
+#include "cbitmapfilter.h"
 #include "cdrawcontext.h"
+#include "coffscreencontext.h"
 #include "ccolor.h"
 #include "algorithm.h"
 #include "platform/iplatformbitmap.h"
 #include "platform/platformfactory.h"
+#include "workerpool.h"
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <list>
 
 namespace VSTGUI {
 
@@ -76,6 +82,14 @@ CBitmap::CBitmap (const PlatformBitmapPtr& platformBitmap)
 	bitmaps.emplace_back (platformBitmap);
 }
 
+//-----------------------------------------------------------------------------
+CBitmap::CBitmap (const CResourceDescription& desc, const PlatformBitmapPtr& platformBitmap)
+: resourceDesc (desc)
+{
+	if (platformBitmap)
+		bitmaps.emplace_back (platformBitmap);
+}
+
 //-----------------------------------------------------------------------------
 void CBitmap::draw (CDrawContext* context, const CRect& rect, const CPoint& offset, float alpha)
 {
@@ -123,6 +137,7 @@ auto CBitmap::getPlatformBitmap () const -> PlatformBitmapPtr
 //-----------------------------------------------------------------------------
 void CBitmap::setPlatformBitmap (const PlatformBitmapPtr& bitmap)
 {
+	clearScaledVariants ();
 	if (bitmaps.empty ())
 		bitmaps.emplace_back (bitmap);
 	else
@@ -151,6 +166,7 @@ bool CBitmap::addBitmap (const PlatformBitmapPtr& platformBitmap)
 		}
 	}
 	bitmaps.emplace_back (platformBitmap);
+	clearScaledVariants ();
 	return true;
 }
 
@@ -171,10 +187,147 @@ auto CBitmap::getBestPlatformBitmapForScaleFactor (double scaleFactor) const ->
 			bestDiff = std::abs (scaleFactor - bitmap->getScaleFactor ());
 		}
 	}
+	if (isScaledVariantsEnabled ())
+	{
+		// nearby scale factors share one variant, so that zooming does not create one per step
+		auto variantScaleFactor = std::round (scaleFactor / kScaledVariantStep) * kScaledVariantStep;
+		for (const auto& bitmap : bitmaps)
+		{
+			if (bitmap->getScaleFactor () == variantScaleFactor)
+				return bitmap;
+		}
+		if (variantScaleFactor > 0.)
+		{
+			if (auto variant = getScaledVariant (variantScaleFactor))
+				return variant;
+		}
+	}
 
 	return bestBitmap;
 }
 
+//-----------------------------------------------------------------------------
+static std::atomic<uint32_t> gScaledVariantsGeneration {0};
+
+//-----------------------------------------------------------------------------
+static std::atomic<bool> gScaledVariantsEnabled {false};
+
+//-----------------------------------------------------------------------------
+void CBitmap::setScaledVariantsEnabled (bool state)
+{
+	gScaledVariantsEnabled = state;
+}
+
+//-----------------------------------------------------------------------------
+bool CBitmap::isScaledVariantsEnabled ()
+{
+	return gScaledVariantsEnabled;
+}
+
+//-----------------------------------------------------------------------------
+auto CBitmap::getScaledVariant (double scaleFactor) const -> PlatformBitmapPtr
+{
+	uint32_t version;
+	{
+		std::lock_guard<std::mutex> guard (scaledVariantsMutex);
+		if (scaledVariantsGeneration != gScaledVariantsGeneration)
+		{
+			scaledVariants.clear ();
+			scaledVariantsGeneration = gScaledVariantsGeneration;
+			++scaledVariantsVersion;
+		}
+		for (const auto& variant : scaledVariants)
+		{
+			if (variant->getScaleFactor () == scaleFactor)
+				return variant;
+		}
+		version = scaledVariantsVersion;
+	}
+
+	// the mutex is not held while the variant is created, so that other threads drawing this
+	// bitmap with a cached variant do not wait
+	auto variant = createScaledVariant (scaleFactor);
+	if (!variant)
+		return nullptr;
+
+	std::lock_guard<std::mutex> guard (scaledVariantsMutex);
+	// the variants were cleared in the meantime, so the new one may be outdated already
+	if (version != scaledVariantsVersion || scaledVariantsGeneration != gScaledVariantsGeneration)
+		return variant;
+	for (const auto& other : scaledVariants)
+	{
+		if (other->getScaleFactor () == scaleFactor)
+			return other;
+	}
+	if (scaledVariants.size () >= kMaxScaledVariants)
+		scaledVariants.erase (scaledVariants.begin ());
+	scaledVariants.emplace_back (variant);
+	return variant;
+}
+
+//-----------------------------------------------------------------------------
+auto CBitmap::createScaledVariant (double scaleFactor) const -> PlatformBitmapPtr
+{
+	// downscaling from the next larger bitmap keeps the most details
+	auto source = bitmaps[0];
+	for (const auto& bitmap : bitmaps)
+	{
+		auto bitmapScaleFactor = bitmap->getScaleFactor ();
+		if (source->getScaleFactor () < scaleFactor)
+		{
+			if (bitmapScaleFactor > source->getScaleFactor ())
+				source = bitmap;
+		}
+		else if (bitmapScaleFactor >= scaleFactor && bitmapScaleFactor < source->getScaleFactor ())
+			source = bitmap;
+	}
+
+	auto size = getSize ();
+	CRect outputRect (0., 0., std::round (size.x * scaleFactor), std::round (size.y * scaleFactor));
+	if (outputRect.isEmpty ())
+		return nullptr;
+	// area averaging does not alias when downscaling
+	auto filter = owned (BitmapFilter::Factory::getInstance ().createFilter (
+		source->getScaleFactor () > scaleFactor ? BitmapFilter::Standard::kScaleAreaAverage
+												: BitmapFilter::Standard::kScaleBilinear));
+	if (!filter)
+		return nullptr;
+	// the source may be drawn on other threads at the same time, so its pixels must not be locked.
+	// Drawing it into a private copy only reads them.
+	auto input = renderBitmapOffscreen (size, source->getScaleFactor (),
+										[&] (CDrawContext& context) {
+											auto sourceBitmap = makeOwned<CBitmap> (source);
+											context.drawBitmap (sourceBitmap, CRect (CPoint (0, 0), size));
+										});
+	if (!input)
+		return nullptr;
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, input.get ());
+	filter->setProperty (BitmapFilter::Standard::Property::kOutputRect, outputRect);
+	if (!filter->run ())
+		return nullptr;
+	auto output = dynamic_cast<CBitmap*> (
+		filter->getProperty (BitmapFilter::Standard::Property::kOutputBitmap).getObject ());
+	if (!output || !output->getPlatformBitmap ())
+		return nullptr;
+	auto variant = output->getPlatformBitmap ();
+	variant->setScaleFactor (scaleFactor);
+	return variant;
+}
+
+//-----------------------------------------------------------------------------
+void CBitmap::clearScaledVariants ()
+{
+	std::lock_guard<std::mutex> guard (scaledVariantsMutex);
+	scaledVariants.clear ();
+	++scaledVariantsVersion;
+}
+
+//-----------------------------------------------------------------------------
+void CBitmap::clearAllScaledVariants ()
+{
+	++gScaledVariantsGeneration;
+}
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -184,6 +337,14 @@ CMultiFrameBitmap::CMultiFrameBitmap (const CResourceDescription& desc,
 {
 }
 
+//-----------------------------------------------------------------------------
+CMultiFrameBitmap::CMultiFrameBitmap (const CResourceDescription& desc,
+									  const PlatformBitmapPtr& platformBitmap,
+									  CMultiFrameBitmapDescription multiFrameDesc)
+: CBitmap (desc, platformBitmap), description (multiFrameDesc)
+{
+}
+
 //-----------------------------------------------------------------------------
 bool CMultiFrameBitmap::setMultiFrameDesc (CMultiFrameBitmapDescription desc)
 {
@@ -288,12 +449,235 @@ CNinePartTiledBitmap::CNinePartTiledBitmap (const PlatformBitmapPtr& platformBit
 {
 }
 
+//-----------------------------------------------------------------------------
+CNinePartTiledBitmap::CNinePartTiledBitmap (const CResourceDescription& desc, const PlatformBitmapPtr& platformBitmap, const CNinePartTiledDescription& offsets)
+: CBitmap (desc, platformBitmap)
+, offsets (offsets)
+{
+}
+
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+/** the composed bitmaps of all nine-part tiled bitmaps sharing one pixel budget */
+struct NinePartRenderCache
+{
+	using Owner = const CNinePartTiledBitmap*;
+
+	static NinePartRenderCache& instance ()
+	{
+		static NinePartRenderCache gInstance;
+		return gInstance;
+	}
+
+	/** @param stamp	is set to the state of the cache, which must be passed to insert */
+	SharedPointer<CBitmap> find (Owner owner, const CPoint& size, double scaleFactor,
+								 uint64_t& stamp)
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		checkGeneration ();
+		stamp = removals;
+		auto it = std::find_if (entries.begin (), entries.end (), [&] (const Entry& entry) {
+			return entry.owner == owner && entry.size == size && entry.scaleFactor == scaleFactor;
+		});
+		if (it == entries.end ())
+			return nullptr;
+		entries.splice (entries.end (), entries, it);
+		return it->bitmap;
+	}
+
+	void insert (Owner owner, const CPoint& size, double scaleFactor,
+				 const SharedPointer<CBitmap>& bitmap, uint64_t stamp)
+	{
+		auto entryPixels = size.x * size.y * scaleFactor * scaleFactor;
+		std::lock_guard<std::mutex> guard (mutex);
+		checkGeneration ();
+		// a cache was cleared while the bitmap was rendered, it may be outdated
+		if (stamp != removals)
+			return;
+		// another thread may have rendered the same size in the meantime
+		for (const auto& entry : entries)
+		{
+			if (entry.owner == owner && entry.size == size && entry.scaleFactor == scaleFactor)
+				return;
+		}
+		entries.push_back ({owner, size, scaleFactor, entryPixels, bitmap});
+		numPixels += entryPixels;
+		evict ();
+	}
+
+	void remove (Owner owner)
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		++removals;
+		for (auto it = entries.begin (); it != entries.end ();)
+		{
+			if (it->owner == owner)
+			{
+				numPixels -= it->numPixels;
+				it = entries.erase (it);
+			}
+			else
+				++it;
+		}
+	}
+
+	void setBudget (CCoord numPixels)
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		budget = numPixels;
+		evict ();
+	}
+
+	CCoord getBudget ()
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		return budget;
+	}
+
+	CCoord getNumPixels ()
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		checkGeneration ();
+		return numPixels;
+	}
+
+private:
+	struct Entry
+	{
+		Owner owner;
+		CPoint size;
+		double scaleFactor;
+		CCoord numPixels;
+		SharedPointer<CBitmap> bitmap;
+	};
+
+	void checkGeneration ()
+	{
+		if (generation == gScaledVariantsGeneration)
+			return;
+		entries.clear ();
+		numPixels = 0.;
+		++removals;
+		generation = gScaledVariantsGeneration;
+	}
+
+	void evict ()
+	{
+		while (!entries.empty () && numPixels > budget)
+		{
+			numPixels -= entries.front ().numPixels;
+			entries.pop_front ();
+		}
+	}
+
+	std::mutex mutex;
+	/** the most recently used entry is at the end */
+	std::list<Entry> entries;
+	CCoord numPixels {0.};
+	CCoord budget {8192. * 1024.};
+	uint32_t generation {0};
+	uint64_t removals {0};
+};
+
+static std::atomic<bool> gNinePartRenderCacheEnabled {true};
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
+//-----------------------------------------------------------------------------
+CNinePartTiledBitmap::~CNinePartTiledBitmap () noexcept
+{
+	NinePartRenderCache::instance ().remove (this);
+}
+
+//-----------------------------------------------------------------------------
+void CNinePartTiledBitmap::setRenderCacheEnabled (bool state)
+{
+	gNinePartRenderCacheEnabled = state;
+}
+
+//-----------------------------------------------------------------------------
+bool CNinePartTiledBitmap::isRenderCacheEnabled ()
+{
+	return gNinePartRenderCacheEnabled;
+}
+
+//-----------------------------------------------------------------------------
+void CNinePartTiledBitmap::setRenderCachePixelBudget (CCoord numPixels)
+{
+	NinePartRenderCache::instance ().setBudget (numPixels);
+}
+
+//-----------------------------------------------------------------------------
+CCoord CNinePartTiledBitmap::getRenderCachePixelBudget ()
+{
+	return NinePartRenderCache::instance ().getBudget ();
+}
+
+//-----------------------------------------------------------------------------
+CCoord CNinePartTiledBitmap::getRenderCachePixelCount ()
+{
+	return NinePartRenderCache::instance ().getNumPixels ();
+}
+
 //-----------------------------------------------------------------------------
 void CNinePartTiledBitmap::draw (CDrawContext* inContext, const CRect& inDestRect, const CPoint& offset, float inAlpha)
 {
+	if (isRenderCacheEnabled ())
+	{
+		if (auto rendered = getRenderedBitmap (inContext, inDestRect))
+		{
+			inContext->drawBitmap (rendered, inDestRect, CPoint (0, 0), inAlpha);
+			return;
+		}
+	}
 	inContext->drawBitmapNinePartTiled (this, inDestRect, offsets, inAlpha);
 }
 
+//-----------------------------------------------------------------------------
+auto CNinePartTiledBitmap::getRenderedBitmap (CDrawContext* context, const CRect& rect)
+	-> SharedPointer<CBitmap>
+{
+	// the composed bitmap is only identical to the drawn parts if its pixels match the device
+	// pixels of the context
+	const auto& transform = context->getCurrentTransform ();
+	if (transform.m11 != 1. || transform.m22 != 1. || transform.m12 != 0. || transform.m21 != 0.)
+		return nullptr;
+	auto scaleFactor = context->getScaleFactor ();
+	CRect deviceRect (rect);
+	transform.transform (deviceRect);
+	for (auto value : {deviceRect.left, deviceRect.top, rect.getWidth (), rect.getHeight ()})
+	{
+		value *= scaleFactor;
+		if (std::abs (value - std::round (value)) > 0.001)
+			return nullptr;
+	}
+	CPoint size = rect.getSize ();
+	auto numPixels = size.x * size.y * scaleFactor * scaleFactor;
+	auto& cache = NinePartRenderCache::instance ();
+	if (size.x < 1. || size.y < 1. || numPixels > cache.getBudget () / 4.)
+		return nullptr;
+
+	uint64_t stamp;
+	if (auto bitmap = cache.find (this, size, scaleFactor, stamp))
+		return bitmap;
+	auto bitmap = renderBitmapOffscreen (size, scaleFactor, [&] (CDrawContext& offscreen) {
+		offscreen.drawBitmapNinePartTiled (this, CRect (CPoint (0, 0), size), offsets);
+	});
+	if (bitmap)
+		cache.insert (this, size, scaleFactor, bitmap, stamp);
+	return bitmap;
+}
+
+//-----------------------------------------------------------------------------
+void CNinePartTiledBitmap::clearScaledVariants ()
+{
+	CBitmap::clearScaledVariants ();
+	NinePartRenderCache::instance ().remove (this);
+}
+
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
@@ -303,6 +687,7 @@ CBitmapPixelAccess::CBitmapPixelAccess ()
 , currentPos (nullptr)
 , address (nullptr)
 , bytesPerRow (0)
+, channelPositions {0, 1, 2, 3}
 , maxX (0)
 , maxY (0)
 , x (0)
@@ -317,9 +702,36 @@ void CBitmapPixelAccess::init (CBitmap* _bitmap, IPlatformBitmapPixelAccess* _pi
 	pixelAccess = _pixelAccess;
 	address = currentPos = pixelAccess->getAddress ();
 	bytesPerRow = pixelAccess->getBytesPerRow ();
+	switch (pixelAccess->getPixelFormat ())
+	{
+		case IPlatformBitmapPixelAccess::kARGB: channelPositions = {1, 2, 3, 0}; break;
+		case IPlatformBitmapPixelAccess::kRGBA: channelPositions = {0, 1, 2, 3}; break;
+		case IPlatformBitmapPixelAccess::kABGR: channelPositions = {3, 2, 1, 0}; break;
+		case IPlatformBitmapPixelAccess::kBGRA: channelPositions = {2, 1, 0, 3}; break;
+	}
 	auto size = bitmap->getPlatformBitmap ()->getSize ();
 	maxX = static_cast<uint32_t> (size.x) - 1;
 	maxY = static_cast<uint32_t> (size.y) - 1;
+	pixelAccess->prepareRows (0, 1);
+}
+
+//------------------------------------------------------------------------
+void CBitmapPixelAccess::forEachRow (const RowProc& proc, bool parallel) const
+{
+	auto width = getBitmapWidth ();
+	auto height = getBitmapHeight ();
+	auto& pool = WorkerPool::instance ();
+	uint32_t numBands = 1;
+	if (parallel)
+		numBands = std::min (pool.numJobsForPixels (static_cast<uint64_t> (width) * height), height);
+	pool.perform (numBands, [&] (uint32_t band) {
+		auto firstRow = static_cast<uint32_t> (static_cast<uint64_t> (height) * band / numBands);
+		auto endRow = static_cast<uint32_t> (static_cast<uint64_t> (height) * (band + 1) / numBands);
+		// converts the rows of the band at once instead of row by row in getRow
+		pixelAccess->prepareRows (firstRow, endRow);
+		for (auto row = firstRow; row < endRow; ++row)
+			proc (getRow (row));
+	});
 }
 
 /// @cond ignore
@@ -348,11 +760,16 @@ public:
 /// @endcond
 
 //------------------------------------------------------------------------
-CBitmapPixelAccess* CBitmapPixelAccess::create (CBitmap* bitmap, bool alphaPremultiplied)
+CBitmapPixelAccess* CBitmapPixelAccess::create (CBitmap* bitmap, bool alphaPremultiplied,
+												bool convertRowsOnDemand)
 {
 	if (bitmap == nullptr || bitmap->getPlatformBitmap () == nullptr)
 		return nullptr;
-	auto pixelAccess = bitmap->getPlatformBitmap ()->lockPixels (alphaPremultiplied);
+	// the pixels may be changed
+	bitmap->clearScaledVariants ();
+	auto platformBitmap = bitmap->getPlatformBitmap ();
+	auto pixelAccess = convertRowsOnDemand ? platformBitmap->lockPixelsOnDemand (alphaPremultiplied)
+										   : platformBitmap->lockPixels (alphaPremultiplied);
 	if (pixelAccess == nullptr)
 		return nullptr;
 	CBitmapPixelAccess* result = nullptr;
@@ -5,11 +5,13 @@
 #pragma once
 
 #include "vstguifwd.h"
+#include "ccolor.h"
 #include "cpoint.h"
 #include "crect.h"
 #include "cresourcedescription.h"
 #include "pixelbuffer.h"
 #include "platform/iplatformbitmap.h"
+#include <mutex>
 #include <vector>
 
 namespace VSTGUI {
@@ -31,6 +33,8 @@ public:
 	/** Create an image with a given size and scale factor */
 	CBitmap (CPoint size, double scaleFactor = 1.);
 	explicit CBitmap (const PlatformBitmapPtr& platformBitmap);
+	/** Create an image from a resource identifier with an already decoded platform bitmap */
+	CBitmap (const CResourceDescription& desc, const PlatformBitmapPtr& platformBitmap);
 	~CBitmap () noexcept override = default;
 
 	//-----------------------------------------------------------------------------
@@ -55,18 +59,49 @@ public:
 	void setPlatformBitmap (const PlatformBitmapPtr& bitmap);
 
 	bool addBitmap (const PlatformBitmapPtr& platformBitmap);
+	/** returns the platform bitmap with the scale factor nearest to scaleFactor
+	 *
+	 *	If scaled variants are enabled, scaleFactor is rounded to a multiple of kScaledVariantStep.
+	 *	If no platform bitmap has exactly this scale factor, a variant is scaled once from the
+	 *	nearest larger one and returned instead.
+	 */
 	PlatformBitmapPtr getBestPlatformBitmapForScaleFactor (double scaleFactor) const;
 
+	/** remove the scaled variants after the pixels of the bitmap have changed.
+	 *	CBitmapPixelAccess and offscreen contexts do this automatically. */
+	virtual void clearScaledVariants ();
+	/** remove the scaled variants of all bitmaps, done when the scale factor of a frame changes */
+	static void clearAllScaledVariants ();
+
 	const_iterator begin () const { return bitmaps.begin (); }
 	const_iterator end () const { return bitmaps.end (); }
 	//@}
 
+	/** create scaled variants for scale factors without a platform bitmap, so that these are
+	 *	not rescaled every time they are drawn. Default is false. */
+	static void setScaledVariantsEnabled (bool state);
+	static bool isScaledVariantsEnabled ();
+
+	/** the maximum number of scaled variants per bitmap */
+	static constexpr size_t kMaxScaledVariants = 4;
+	/** scaled variants are only created for multiples of this step, other scale factors use the
+	 *	nearest one */
+	static constexpr double kScaledVariantStep = 0.25;
+
 //-----------------------------------------------------------------------------
 protected:
 	CBitmap ();
 
+	PlatformBitmapPtr getScaledVariant (double scaleFactor) const;
+	PlatformBitmapPtr createScaledVariant (double scaleFactor) const;
+
 	CResourceDescription resourceDesc;
 	BitmapVector bitmaps;
+
+	mutable std::mutex scaledVariantsMutex;
+	mutable BitmapVector scaledVariants;
+	mutable uint32_t scaledVariantsGeneration {0};
+	mutable uint32_t scaledVariantsVersion {0};
 };
 
 //-----------------------------------------------------------------------------
@@ -104,6 +139,8 @@ public:
 
 	CMultiFrameBitmap (const CResourceDescription& desc,
 					   CMultiFrameBitmapDescription multiFrameDesc);
+	CMultiFrameBitmap (const CResourceDescription& desc, const PlatformBitmapPtr& platformBitmap,
+					   CMultiFrameBitmapDescription multiFrameDesc);
 
 	/** set the multi frame description
 	 *
@@ -312,20 +349,42 @@ class CNinePartTiledBitmap : public CBitmap
 public:
 	CNinePartTiledBitmap (const CResourceDescription& desc, const CNinePartTiledDescription& offsets);
 	CNinePartTiledBitmap (const PlatformBitmapPtr& platformBitmap, const CNinePartTiledDescription& offsets);
-	~CNinePartTiledBitmap () noexcept override = default;
+	CNinePartTiledBitmap (const CResourceDescription& desc, const PlatformBitmapPtr& platformBitmap, const CNinePartTiledDescription& offsets);
+	~CNinePartTiledBitmap () noexcept override;
 	
 	//-----------------------------------------------------------------------------
 	/// @name Part Offsets
 	//-----------------------------------------------------------------------------
 	//@{
-	void setPartOffsets (const CNinePartTiledDescription& partOffsets) { offsets = partOffsets; }
+	void setPartOffsets (const CNinePartTiledDescription& partOffsets)
+	{
+		offsets = partOffsets;
+		clearScaledVariants ();
+	}
 	const CNinePartTiledDescription& getPartOffsets () const { return offsets; }
 	//@}
 
 	void draw (CDrawContext* context, const CRect& rect, const CPoint& offset = CPoint (0, 0), float alpha = 1.f) override;
+	void clearScaledVariants () override;
+
+	/** keep the composed bitmap of the last drawn sizes, so that it is drawn with one bitmap
+	 *	draw instead of drawing all parts every time. Only used when the destination is aligned to
+	 *	device pixels and the context is not scaled or rotated. Default is true. */
+	static void setRenderCacheEnabled (bool state);
+	static bool isRenderCacheEnabled ();
+
+	/** the maximum number of pixels kept in the render caches of all nine-part tiled bitmaps.
+	 *	If exceeded, the least recently used composed bitmaps are evicted. A single size is only
+	 *	cached if it needs at most a quarter of the budget. */
+	static void setRenderCachePixelBudget (CCoord numPixels);
+	static CCoord getRenderCachePixelBudget ();
+	/** the number of pixels currently kept in the render caches of all nine-part tiled bitmaps */
+	static CCoord getRenderCachePixelCount ();
 
 //-----------------------------------------------------------------------------
 protected:
+	SharedPointer<CBitmap> getRenderedBitmap (CDrawContext* context, const CRect& rect);
+
 	CNinePartTiledDescription offsets;
 };
 
@@ -379,10 +438,62 @@ public:
 	inline uint32_t getBitmapHeight () const { return maxY+1; }
 
 	inline IPlatformBitmapPixelAccess* getPlatformBitmapPixelAccess () const { return pixelAccess; }
+
+	/** the byte positions of the channels in a pixel */
+	struct ChannelPositions
+	{
+		uint32_t red;
+		uint32_t green;
+		uint32_t blue;
+		uint32_t alpha;
+	};
+
+	/** a row of packed 32 bit pixels in the pixel format of the accessor */
+	class Row
+	{
+	public:
+		Row (uint8_t* address, uint32_t width, uint32_t y, const ChannelPositions& positions)
+		: address (address), width (width), y (y), positions (positions)
+		{
+		}
+
+		uint32_t* begin () const { return reinterpret_cast<uint32_t*> (address); }
+		uint32_t* end () const { return begin () + width; }
+		uint8_t* getAddress () const { return address; }
+		uint32_t getWidth () const { return width; }
+		uint32_t getY () const { return y; }
+
+		/** get the color of the pixel at x without a virtual call */
+		inline void getColor (uint32_t x, CColor& c) const;
+		/** set the color of the pixel at x without a virtual call */
+		inline void setColor (uint32_t x, const CColor& c) const;
+
+	private:
+		uint8_t* address;
+		uint32_t width;
+		uint32_t y;
+		ChannelPositions positions;
+	};
+	using RowProc = std::function<void (const Row& row)>;
+
+	/** the pixel format of the pixels, the channel positions follow from it */
+	IPlatformBitmapPixelAccess::PixelFormat getPixelFormat () const { return pixelAccess->getPixelFormat (); }
+	const ChannelPositions& getChannelPositions () const { return channelPositions; }
+	uint32_t getBytesPerRow () const { return bytesPerRow; }
+	/** the row at y, which must be smaller than the height of the bitmap */
+	inline Row getRow (uint32_t y) const;
+	/** call proc for every row. if parallel is true, the rows of large bitmaps are processed in
+	 *	bands on the worker pool, so proc must be thread safe then. */
+	void forEachRow (const RowProc& proc, bool parallel = true) const;
+
 	/** create an accessor.
 		can return 0 if platform implementation does not support this.
-		result needs to be forgotten before the CBitmap reflects the change to the pixels */
-	static CBitmapPixelAccess* create (CBitmap* bitmap, bool alphaPremultiplied = true);
+		result needs to be forgotten before the CBitmap reflects the change to the pixels.
+		if convertRowsOnDemand is true, the platform may only convert the rows reached via the
+		position, getRow or forEachRow, the address of getPlatformBitmapPixelAccess must not be
+		used directly then */
+	static CBitmapPixelAccess* create (CBitmap* bitmap, bool alphaPremultiplied = true,
+									  bool convertRowsOnDemand = false);
 //-----------------------------------------------------------------------------
 protected:
 	CBitmapPixelAccess ();
@@ -394,6 +505,7 @@ protected:
 	uint8_t* currentPos;
 	uint8_t* address;
 	uint32_t bytesPerRow;
+	ChannelPositions channelPositions;
 	uint32_t maxX;
 	uint32_t maxY;
 	uint32_t x;
@@ -414,6 +526,7 @@ inline bool CBitmapPixelAccess::operator++ ()
 		y++;
 		x = 0;
 		currentPos = address + y * bytesPerRow;
+		pixelAccess->prepareRows (y, y + 1);
 		return true;
 	}
 	return false;
@@ -424,12 +537,41 @@ inline bool CBitmapPixelAccess::setPosition (uint32_t _x, uint32_t _y)
 {
 	if (_x > maxX || _y > maxY)
 		return false;
+	if (_y != y)
+		pixelAccess->prepareRows (_y, _y + 1);
 	x = _x;
 	y = _y;
 	currentPos = address + y * bytesPerRow + x * 4;
 	return true;
 }
 
+//------------------------------------------------------------------------
+inline CBitmapPixelAccess::Row CBitmapPixelAccess::getRow (uint32_t _y) const
+{
+	pixelAccess->prepareRows (_y, _y + 1);
+	return Row (address + static_cast<size_t> (_y) * bytesPerRow, maxX + 1, _y, channelPositions);
+}
+
+//------------------------------------------------------------------------
+inline void CBitmapPixelAccess::Row::getColor (uint32_t x, CColor& c) const
+{
+	auto pixel = address + x * 4;
+	c.red = pixel[positions.red];
+	c.green = pixel[positions.green];
+	c.blue = pixel[positions.blue];
+	c.alpha = pixel[positions.alpha];
+}
+
+//------------------------------------------------------------------------
+inline void CBitmapPixelAccess::Row::setColor (uint32_t x, const CColor& c) const
+{
+	auto pixel = address + x * 4;
+	pixel[positions.red] = c.red;
+	pixel[positions.green] = c.green;
+	pixel[positions.blue] = c.blue;
+	pixel[positions.alpha] = c.alpha;
+}
+
 //------------------------------------------------------------------------
 inline void CBitmapPixelAccess::getValue (uint32_t& value)
 {
@@ -9,10 +9,21 @@
 #include "cgraphicspath.h"
 #include "cgraphicstransform.h"
 #include "malloc.h"
+#include "workerpool.h"
 #include <cassert>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <climits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VSTGUI_BITMAPFILTER_SSE2 1
+#include <emmintrin.h>
+#endif
 
 namespace VSTGUI {
 
@@ -392,37 +403,266 @@ namespace Standard {
 //----------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------
-class BoxBlur : public FilterBase
+/** call job for the indices [0, numJobs) on the worker pool, or on the calling thread only if an
+ *	image with numPixels pixels is too small to be split */
+static void performJobs (uint64_t numPixels, uint32_t numJobs, const WorkerPool::Job& job)
+{
+	auto& pool = WorkerPool::instance ();
+	if (pool.numJobsForPixels (numPixels) > 1)
+	{
+		pool.perform (numJobs, job);
+		return;
+	}
+	for (auto i = 0u; i < numJobs; ++i)
+		job (i);
+}
+
+//----------------------------------------------------------------------------------------------------
+/** box blurs of a plane of 8 bit values with the edge values repeated
+ *
+ *	Only columns are blurred, as the sums of neighbouring columns can be updated together with
+ *	SIMD. The rows are blurred as columns of the transposed plane.
+ */
+class PlaneBlur
 {
 public:
-	static IFilter* CreateFunction (IdStringPtr _name)
+	PlaneBlur (uint32_t width, uint32_t height) : width (width), height (height)
 	{
-		return new BoxBlur ();
+		auto size = static_cast<size_t> (width) * height;
+		buffer1.allocate (size);
+		buffer2.allocate (size);
+	}
+
+	/** first blur the rows with all radii, then the columns with all radii */
+	void run (uint8_t* plane, const std::vector<uint32_t>& radii)
+	{
+		transpose (plane, buffer1.data (), width, height);
+		auto result = blurColumns (buffer1.data (), buffer2.data (), height, width, radii);
+		transpose (result, plane, height, width);
+		result = blurColumns (plane, buffer1.data (), width, height, radii);
+		if (result != plane)
+			std::memcpy (plane, result, buffer1.size ());
 	}
 
 private:
-	BoxBlur ()
-	: FilterBase ("A Box Blur Filter")
+	/** returns the buffer with the result, which is either plane or other */
+	uint8_t* blurColumns (uint8_t* plane, uint8_t* other, uint32_t planeWidth,
+						  uint32_t planeHeight, const std::vector<uint32_t>& radii)
+	{
+		static constexpr uint32_t kColumnAlignment = 64;
+		auto numPixels = static_cast<uint64_t> (planeWidth) * planeHeight;
+		auto numJobs = WorkerPool::instance ().numJobsForPixels (numPixels);
+		auto columnsPerJob = (planeWidth + numJobs - 1) / numJobs;
+		columnsPerJob = (columnsPerJob + kColumnAlignment - 1) / kColumnAlignment * kColumnAlignment;
+		numJobs = (planeWidth + columnsPerJob - 1) / columnsPerJob;
+		for (auto radius : radii)
+		{
+			performJobs (numPixels, numJobs, [&] (uint32_t index) {
+				auto firstColumn = index * columnsPerJob;
+				auto numColumns = std::min (columnsPerJob, planeWidth - firstColumn);
+				blurColumns (plane + firstColumn, other + firstColumn, planeWidth, numColumns,
+							 planeHeight, radius);
+			});
+			std::swap (plane, other);
+		}
+		return plane;
+	}
+
+	static void blurColumns (const uint8_t* src, uint8_t* dst, uint32_t stride,
+							 uint32_t numColumns, uint32_t numRows, uint32_t radius)
+	{
+		Buffer<int32_t> sums (numColumns);
+		std::fill (sums.begin (), sums.end (), 0);
+		auto lastRow = static_cast<int32_t> (numRows) - 1;
+		auto r = static_cast<int32_t> (radius);
+		auto row = [&] (int32_t y) { return src + std::min (std::max (y, 0), lastRow) * stride; };
+		for (auto y = -r; y <= r; ++y)
+		{
+			auto input = row (y);
+			for (auto x = 0u; x < numColumns; ++x)
+				sums[x] += input[x];
+		}
+		// floor (sum / divisor) of integers, exact as long as the divisor is below 2^14
+		auto scale = 1.f / static_cast<float> (radius * 2 + 1);
+		for (auto y = 0; y <= lastRow; ++y, dst += stride)
+		{
+			auto add = row (y + r + 1);
+			auto sub = row (y - r);
+			uint32_t x = 0;
+#if VSTGUI_BITMAPFILTER_SSE2
+			x = blurColumnsSSE2 (sums.data (), add, sub, dst, numColumns, scale);
+#endif
+			for (; x < numColumns; ++x)
+			{
+				dst[x] = static_cast<uint8_t> ((static_cast<float> (sums[x]) + 0.5f) * scale);
+				sums[x] += add[x] - sub[x];
+			}
+		}
+	}
+
+#if VSTGUI_BITMAPFILTER_SSE2
+	/** the output and sum update of 16 columns at once, returns the number of columns done */
+	static uint32_t blurColumnsSSE2 (int32_t* sums, const uint8_t* add, const uint8_t* sub,
+									 uint8_t* dst, uint32_t numColumns, float scale)
+	{
+		auto zero = _mm_setzero_si128 ();
+		auto half = _mm_set1_ps (0.5f);
+		auto scaleVector = _mm_set1_ps (scale);
+		uint32_t x = 0;
+		for (; x + 16 <= numColumns; x += 16, sums += 16)
+		{
+			__m128i s[4];
+			__m128i values[4];
+			for (auto i = 0; i < 4; ++i)
+			{
+				s[i] = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (sums + i * 4));
+				auto value = _mm_mul_ps (_mm_add_ps (_mm_cvtepi32_ps (s[i]), half), scaleVector);
+				values[i] = _mm_cvttps_epi32 (value);
+			}
+			auto output = _mm_packus_epi16 (_mm_packs_epi32 (values[0], values[1]),
+											_mm_packs_epi32 (values[2], values[3]));
+			_mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + x), output);
+
+			auto a = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (add + x));
+			auto b = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (sub + x));
+			// the differences as 16 bit and then sign extended to 32 bit
+			__m128i diff[2] = {_mm_sub_epi16 (_mm_unpacklo_epi8 (a, zero), _mm_unpacklo_epi8 (b, zero)),
+							   _mm_sub_epi16 (_mm_unpackhi_epi8 (a, zero), _mm_unpackhi_epi8 (b, zero))};
+			for (auto i = 0; i < 4; ++i)
+			{
+				auto d = diff[i / 2];
+				auto d32 = (i % 2) == 0 ? _mm_unpacklo_epi16 (d, d) : _mm_unpackhi_epi16 (d, d);
+				d32 = _mm_srai_epi32 (d32, 16);
+				_mm_storeu_si128 (reinterpret_cast<__m128i*> (sums + i * 4),
+								  _mm_add_epi32 (s[i], d32));
+			}
+		}
+		return x;
+	}
+#endif
+
+	/** transpose in tiles, so that the rows and columns of a tile stay in the cache */
+	void transpose (const uint8_t* src, uint8_t* dst, uint32_t srcWidth, uint32_t srcHeight)
+	{
+		static constexpr uint32_t kTileSize = 32;
+		auto numTileRows = (srcHeight + kTileSize - 1) / kTileSize;
+		performJobs (static_cast<uint64_t> (srcWidth) * srcHeight, numTileRows, [&] (uint32_t tileRow) {
+			auto y0 = tileRow * kTileSize;
+			auto y1 = std::min (y0 + kTileSize, srcHeight);
+			for (auto x0 = 0u; x0 < srcWidth; x0 += kTileSize)
+			{
+				auto x1 = std::min (x0 + kTileSize, srcWidth);
+				for (auto y = y0; y < y1; ++y)
+				{
+					auto input = src + static_cast<size_t> (y) * srcWidth;
+					for (auto x = x0; x < x1; ++x)
+						dst[static_cast<size_t> (x) * srcHeight + y] = input[x];
+				}
+			}
+		});
+	}
+
+	uint32_t width;
+	uint32_t height;
+	Buffer<uint8_t> buffer1;
+	Buffer<uint8_t> buffer2;
+};
+
+//----------------------------------------------------------------------------------------------------
+/** blur the channels of the pixels of input into output with box blurs of radii */
+void blurPixels (CBitmapPixelAccess& inputAccessor, CBitmapPixelAccess& outputAccessor,
+				 const std::vector<uint32_t>& radii, bool alphaChannelOnly)
+{
+	auto inputPbpa = inputAccessor.getPlatformBitmapPixelAccess ();
+	auto outputPbpa = outputAccessor.getPlatformBitmapPixelAccess ();
+	auto width = inputAccessor.getBitmapWidth ();
+	auto height = std::min (inputAccessor.getBitmapHeight (), outputAccessor.getBitmapHeight ());
+	width = std::min (width, outputAccessor.getBitmapWidth ());
+	auto inputBytesPerRow = inputPbpa->getBytesPerRow ();
+	auto outputBytesPerRow = outputPbpa->getBytesPerRow ();
+
+	std::vector<uint32_t> channels;
+	if (alphaChannelOnly)
+	{
+		switch (inputPbpa->getPixelFormat ())
+		{
+			case IPlatformBitmapPixelAccess::kARGB:
+			case IPlatformBitmapPixelAccess::kABGR:
+				channels = {0};
+				break;
+			case IPlatformBitmapPixelAccess::kRGBA:
+			case IPlatformBitmapPixelAccess::kBGRA:
+				channels = {3};
+				break;
+		}
+	}
+	else
+		channels = {0, 1, 2, 3};
+
+	PlaneBlur planeBlur (width, height);
+	Buffer<uint8_t> plane (static_cast<size_t> (width) * height);
+	for (auto channel : channels)
+	{
+		auto input = inputPbpa->getAddress () + channel;
+		for (auto y = 0u; y < height; ++y, input += inputBytesPerRow)
+		{
+			auto planeRow = plane.data () + static_cast<size_t> (y) * width;
+			for (auto x = 0u; x < width; ++x)
+				planeRow[x] = input[x * 4];
+		}
+		planeBlur.run (plane.data (), radii);
+		auto output = outputPbpa->getAddress () + channel;
+		for (auto y = 0u; y < height; ++y, output += outputBytesPerRow)
+		{
+			auto planeRow = plane.data () + static_cast<size_t> (y) * width;
+			for (auto x = 0u; x < width; ++x)
+				output[x * 4] = planeRow[x];
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------
+/** the box sizes which approximate a gaussian blur with the standard deviation sigma */
+template <size_t numBoxes>
+static std::array<int32_t, numBoxes> boxesForGauss (double sigma)
+{
+	std::array<int32_t, numBoxes> boxes;
+	double ideal = std::sqrt ((12 * sigma * sigma / numBoxes) + 1);
+	uint16_t l = static_cast<uint16_t> (std::floor (ideal));
+	if (l % 2 == 0)
+		l--;
+	int32_t u = l + 2;
+	ideal = ((12. * sigma * sigma) - (numBoxes * l * l) - (4. * numBoxes * l) - (3. * numBoxes)) / ((-4. * l) - 4.);
+	int32_t m = static_cast<int32_t> (std::floor (ideal));
+	for (int32_t i = 0; i < static_cast<int32_t> (numBoxes); ++i)
+		boxes[i] = (i < m ? l : u);
+	return boxes;
+}
+
+//----------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------
+class BlurBase : public FilterBase
+{
+protected:
+	BlurBase (UTF8StringPtr description) : FilterBase (description)
 	{
 		registerProperty (Property::kInputBitmap, BitmapFilter::Property (BitmapFilter::Property::kObject));
-		registerProperty (Property::kRadius, BitmapFilter::Property ((int32_t)2));
 		registerProperty (Property::kAlphaChannelOnly, BitmapFilter::Property ((int32_t)0));
 	}
 
+	/** the radii of the box blurs in pixels for the scale factor of the input bitmap */
+	virtual bool getRadii (CBitmap* inputBitmap, std::vector<uint32_t>& radii) const = 0;
+
 	bool run (bool replace) override
 	{
 		CBitmap* inputBitmap = getInputBitmap ();
-		if (inputBitmap == nullptr)
-			return false;
-		const auto& radiusProp = getProperty (Property::kRadius);
-		if (radiusProp.getType () != BitmapFilter::Property::kInteger)
+		if (inputBitmap == nullptr || inputBitmap->getPlatformBitmap () == nullptr)
 			return false;
-		uint32_t radius =
-		    static_cast<uint32_t> (static_cast<double> (radiusProp.getInteger ()) *
-		                           inputBitmap->getPlatformBitmap ()->getScaleFactor ());
-		if (radius == UINT_MAX)
+		std::vector<uint32_t> radii;
+		if (!getRadii (inputBitmap, radii))
 			return false;
-		if (radius < 2)
+		if (radii.empty ())
 		{
 			if (replace)
 				return true;
@@ -437,10 +677,10 @@ private:
 			SharedPointer<CBitmapPixelAccess> inputAccessor = owned (CBitmapPixelAccess::create (inputBitmap));
 			if (inputAccessor == nullptr)
 				return false;
-			run (*inputAccessor, *inputAccessor, radius, alphaChannelOnly);
+			blurPixels (*inputAccessor, *inputAccessor, radii, alphaChannelOnly);
 			return registerProperty (Property::kOutputBitmap, BitmapFilter::Property (inputBitmap));
 		}
-		SharedPointer<CBitmap> outputBitmap = owned (new CBitmap (inputBitmap->getWidth (), inputBitmap->getHeight ()));
+		SharedPointer<CBitmap> outputBitmap = owned (new CBitmap (inputBitmap->getSize (), inputBitmap->getPlatformBitmap ()->getScaleFactor ()));
 		if (outputBitmap)
 		{
 			SharedPointer<CBitmapPixelAccess> inputAccessor = owned (CBitmapPixelAccess::create (inputBitmap));
@@ -448,231 +688,125 @@ private:
 			if (inputAccessor == nullptr || outputAccessor == nullptr)
 				return false;
 
-			run (*inputAccessor, *outputAccessor, radius, alphaChannelOnly);
+			blurPixels (*inputAccessor, *outputAccessor, radii, alphaChannelOnly);
 			return registerProperty (Property::kOutputBitmap, BitmapFilter::Property (outputBitmap));
 		}
 		return false;
 	}
 
-	void run (CBitmapPixelAccess& inputAccessor, CBitmapPixelAccess& outputAccessor, uint32_t radius, bool alphaChannelOnly)
+	/** the radius of a box blur of size pixels, zero if the blur does not change anything */
+	static uint32_t radiusForBoxSize (double size)
 	{
-		auto inputPbpa = inputAccessor.getPlatformBitmapPixelAccess ();
-		auto outputPbpa = outputAccessor.getPlatformBitmapPixelAccess ();
-		auto inputAddressPtr = inputPbpa->getAddress ();
-		auto outputAddressPtr = outputPbpa->getAddress ();
-		auto width = inputPbpa->getBytesPerRow () / 4;
-		auto height = inputAccessor.getBitmapHeight ();
-		if (alphaChannelOnly)
-		{
-			switch (inputPbpa->getPixelFormat ())
-			{
-				case IPlatformBitmapPixelAccess::kARGB:
-				case IPlatformBitmapPixelAccess::kABGR:
-				{
-					algo<true, false, false, false> (inputAddressPtr, outputAddressPtr, width, height, static_cast<int32_t> (radius / 2));
-					break;
-				}
-				case IPlatformBitmapPixelAccess::kRGBA:
-				case IPlatformBitmapPixelAccess::kBGRA:
-				{
-					algo<false, false, false, true> (inputAddressPtr, outputAddressPtr, width, height, static_cast<int32_t> (radius / 2));
-					break;
-				}
-			}
-		
-		}
-		else
-		{
-			algo<true, true, true, true> (inputAddressPtr, outputAddressPtr, width, height, static_cast<int32_t> (radius / 2));
-		}
+		if (size >= static_cast<double> (UINT_MAX) || size < 2.)
+			return 0;
+		return static_cast<uint32_t> (size) / 2;
 	}
+};
 
-	Buffer<uint8_t> pc0;
-	Buffer<uint8_t> pc1;
-	Buffer<uint8_t> pc2;
-	Buffer<uint8_t> pc3;
-	Buffer<int32_t> vMin;
-	Buffer<int32_t> vMax;
-	Buffer<uint8_t> dv;
-
-	template<bool plane0, bool plane1, bool plane2, bool plane3>
-	void algo (uint8_t* inPixel, uint8_t* outPixel, int32_t width, int32_t height, int32_t radius)
-	{
-		vstgui_assert (radius > 0);
-
-		constexpr int32_t pos0 = 0;
-		constexpr int32_t pos1 = 1;
-		constexpr int32_t pos2 = 2;
-		constexpr int32_t pos3 = 3;
-		constexpr int32_t numComponents = 4;
-
-		int32_t wm = width - 1;
-		int32_t hm = height - 1;
-		int32_t areaSize = width * height;
-		int32_t div = radius + radius + 1;
-		
-		if (plane0)
-			pc0.allocate (areaSize);
-		if (plane1)
-			pc1.allocate (areaSize);
-		if (plane2)
-			pc2.allocate (areaSize);
-		if (plane3)
-			pc3.allocate (areaSize);
-		vMin.allocate (std::max (width, height));
-		vMax.allocate (std::max (width, height));
-		dv.allocate (256 * div);
-
-		for (auto i = 0u; i < dv.size (); ++i)
-			dv[i] = (i / div);
-
-		int32_t sum0, sum1, sum2, sum3;
-		for (auto y = 0, yw = 0, yi = 0; y < height; ++y, yw += width)
-		{
-			sum0 = sum1 = sum2 = sum3 = 0;
-			for (auto i = -radius; i <= radius; i++)
-			{
-				auto p = (yi + std::min (wm, std::max (i, 0))) * numComponents;
-				if (plane0)
-					sum0 += inPixel[p + pos0];
-				if (plane1)
-					sum1 += inPixel[p + pos1];
-				if (plane2)
-					sum2 += inPixel[p + pos2];
-				if (plane3)
-					sum3 += inPixel[p + pos3];
-			}
-			if (y == 0)
-			{
-				for (auto x = 0; x < width; ++x, ++yi)
-				{
-					if (plane0)
-						pc0[yi] = dv[sum0];
-					if (plane1)
-						pc1[yi] = dv[sum1];
-					if (plane2)
-						pc2[yi] = dv[sum2];
-					if (plane3)
-						pc3[yi] = dv[sum3];
-					vMin[x] = std::min (x + radius + 1, wm);
-					vMax[x] = std::max (x - radius, 0);
-					auto p1 = (yw + vMin[x]) * numComponents;
-					auto p2 = (yw + vMax[x]) * numComponents;
-					if (plane0)
-						sum0 += inPixel[p1 + pos0] - inPixel[p2 + pos0];
-					if (plane1)
-						sum1 += inPixel[p1 + pos1] - inPixel[p2 + pos1];
-					if (plane2)
-						sum2 += inPixel[p1 + pos2] - inPixel[p2 + pos2];
-					if (plane3)
-						sum3 += inPixel[p1 + pos3] - inPixel[p2 + pos3];
-				}
-			}
-			else
-			{
-				for (auto x = 0; x < width; ++x, ++yi)
-				{
-					if (plane0)
-						pc0[yi] = dv[sum0];
-					if (plane1)
-						pc1[yi] = dv[sum1];
-					if (plane2)
-						pc2[yi] = dv[sum2];
-					if (plane3)
-						pc3[yi] = dv[sum3];
-					auto p1 = (yw + vMin[x]) * numComponents;
-					auto p2 = (yw + vMax[x]) * numComponents;
-					if (plane0)
-						sum0 += inPixel[p1 + pos0] - inPixel[p2 + pos0];
-					if (plane1)
-						sum1 += inPixel[p1 + pos1] - inPixel[p2 + pos1];
-					if (plane2)
-						sum2 += inPixel[p1 + pos2] - inPixel[p2 + pos2];
-					if (plane3)
-						sum3 += inPixel[p1 + pos3] - inPixel[p2 + pos3];
-				}
-			}
-		}
+//----------------------------------------------------------------------------------------------------
+class BoxBlur : public BlurBase
+{
+public:
+	static IFilter* CreateFunction (IdStringPtr _name)
+	{
+		return new BoxBlur ();
+	}
 
-		sum0 = sum1 = sum2 = sum3 = 0;
-		for (auto i = -radius, yp = -radius * width; i <= radius; ++i, yp += width)
-		{
-			auto yi = std::max (0, yp);
-			if (plane0)
-				sum0 += pc0[yi];
-			if (plane1)
-				sum1 += pc1[yi];
-			if (plane2)
-				sum2 += pc2[yi];
-			if (plane3)
-				sum3 += pc3[yi];
-		}
-		for (auto y = 0, yi = 0; y < height; ++y, yi += width)
-		{
-			auto pos = yi * numComponents;
-			if (plane0)
-				outPixel[pos + pos0] = dv[sum0];
-			if (plane1)
-				outPixel[pos + pos1] = dv[sum1];
-			if (plane2)
-				outPixel[pos + pos2] = dv[sum2];
-			if (plane3)
-				outPixel[pos + pos3] = dv[sum3];
-			vMin[y] = std::min (y + radius + 1, hm) * width;
-			vMax[y] = std::max (y - radius, 0) * width;
-			auto p1 = vMin[y];
-			auto p2 = vMax[y];
-			if (plane0)
-				sum0 += pc0[p1] - pc0[p2];
-			if (plane1)
-				sum1 += pc1[p1] - pc1[p2];
-			if (plane2)
-				sum2 += pc2[p1] - pc2[p2];
-			if (plane3)
-				sum3 += pc3[p1] - pc3[p2];
-		}
+private:
+	BoxBlur ()
+	: BlurBase ("A Box Blur Filter")
+	{
+		registerProperty (Property::kRadius, BitmapFilter::Property ((int32_t)2));
+	}
 
-		for (auto x = 1; x < width; ++x)
+	bool getRadii (CBitmap* inputBitmap, std::vector<uint32_t>& radii) const override
+	{
+		const auto& radiusProp = getProperty (Property::kRadius);
+		if (radiusProp.getType () != BitmapFilter::Property::kInteger)
+			return false;
+		auto size = static_cast<double> (radiusProp.getInteger ()) *
+					inputBitmap->getPlatformBitmap ()->getScaleFactor ();
+		if (auto radius = radiusForBoxSize (size))
+			radii.push_back (radius);
+		return true;
+	}
+};
+
+//----------------------------------------------------------------------------------------------------
+class GaussianBlur : public BlurBase
+{
+public:
+	static IFilter* CreateFunction (IdStringPtr _name)
+	{
+		return new GaussianBlur ();
+	}
+
+private:
+	GaussianBlur ()
+	: BlurBase ("A Gaussian Blur Filter")
+	{
+		registerProperty (Property::kStandardDeviation, BitmapFilter::Property (2.));
+	}
+
+	bool getRadii (CBitmap* inputBitmap, std::vector<uint32_t>& radii) const override
+	{
+		const auto& sigmaProp = getProperty (Property::kStandardDeviation);
+		if (sigmaProp.getType () != BitmapFilter::Property::kFloat)
+			return false;
+		auto scaleFactor = inputBitmap->getPlatformBitmap ()->getScaleFactor ();
+		for (auto boxSize : boxesForGauss<3> (sigmaProp.getFloat ()))
 		{
-			sum0 = sum1 = sum2 = sum3 = 0;
-			for (auto i = -radius, yp = -radius * width; i <= radius; ++i, yp += width)
-			{
-				auto yi = std::max (0, yp) + x;
-				if (plane0)
-					sum0 += pc0[yi];
-				if (plane1)
-					sum1 += pc1[yi];
-				if (plane2)
-					sum2 += pc2[yi];
-				if (plane3)
-					sum3 += pc3[yi];
-			}
-			for (auto y = 0, yi = x; y < height; ++y, yi += width)
-			{
-				auto pos = yi * numComponents;
-				if (plane0)
-					outPixel[pos + pos0] = dv[sum0];
-				if (plane1)
-					outPixel[pos + pos1] = dv[sum1];
-				if (plane2)
-					outPixel[pos + pos2] = dv[sum2];
-				if (plane3)
-					outPixel[pos + pos3] = dv[sum3];
-				auto p1 = x + vMin[y];
-				auto p2 = x + vMax[y];
-				if (plane0)
-					sum0 += pc0[p1] - pc0[p2];
-				if (plane1)
-					sum1 += pc1[p1] - pc1[p2];
-				if (plane2)
-					sum2 += pc2[p1] - pc2[p2];
-				if (plane3)
-					sum3 += pc3[p1] - pc3[p2];
-			}
+			if (auto radius = radiusForBoxSize (static_cast<double> (boxSize) * scaleFactor))
+				radii.push_back (radius);
 		}
+		return true;
 	}
 };
 
+//----------------------------------------------------------------------------------------------------
+/** the number of bands of rows to process on the workers */
+static uint32_t getNumBands (uint32_t width, uint32_t height)
+{
+	return std::min (
+		WorkerPool::instance ().numJobsForPixels (static_cast<uint64_t> (width) * height), height);
+}
+
+//----------------------------------------------------------------------------------------------------
+/** call proc with the first and the end row of a band */
+template <typename Proc>
+static void forEachRowOfBand (uint32_t band, uint32_t numBands, uint32_t height, Proc proc)
+{
+	auto firstRow = static_cast<uint32_t> (static_cast<uint64_t> (height) * band / numBands);
+	auto endRow = static_cast<uint32_t> (static_cast<uint64_t> (height) * (band + 1) / numBands);
+	for (auto y = firstRow; y < endRow; ++y)
+		proc (y);
+}
+
+//----------------------------------------------------------------------------------------------------
+/** run the pixel filters one after the other on every pixel of the input and write the result to
+ *	the output, which may be the input. The rows are processed in bands on several threads. */
+static void processPixels (CBitmapPixelAccess& inputAccessor, CBitmapPixelAccess& outputAccessor,
+						   const std::vector<const IPixelFilter*>& filters)
+{
+	auto width = std::min (inputAccessor.getBitmapWidth (), outputAccessor.getBitmapWidth ());
+	auto height = std::min (inputAccessor.getBitmapHeight (), outputAccessor.getBitmapHeight ());
+	auto numBands = getNumBands (width, height);
+	WorkerPool::instance ().perform (numBands, [&] (uint32_t band) {
+		CColor color;
+		forEachRowOfBand (band, numBands, height, [&] (uint32_t y) {
+			auto inputRow = inputAccessor.getRow (y);
+			auto outputRow = outputAccessor.getRow (y);
+			for (auto x = 0u; x < width; ++x)
+			{
+				inputRow.getColor (x, color);
+				for (auto filter : filters)
+					filter->processPixel (color);
+				outputRow.setColor (x, color);
+			}
+		});
+	});
+}
+
 //----------------------------------------------------------------------------------------------------
 class ScaleBase : public FilterBase
 {
@@ -728,9 +862,6 @@ private:
 
 	void process (CBitmapPixelAccess& originalBitmap, CBitmapPixelAccess& copyBitmap) override
 	{
-		originalBitmap.setPosition (0, 0);
-		copyBitmap.setPosition (0, 0);
-		
 		uint32_t origWidth = (uint32_t)originalBitmap.getBitmapWidth ();
 		uint32_t origHeight = (uint32_t)originalBitmap.getBitmapHeight ();
 		uint32_t newWidth = (uint32_t)copyBitmap.getBitmapWidth ();
@@ -744,29 +875,29 @@ private:
 		uint32_t origBytesPerRow = originalBitmap.getPlatformBitmapPixelAccess ()->getBytesPerRow ();
 		uint32_t copyBytesPerRow = copyBitmap.getPlatformBitmapPixelAccess ()->getBytesPerRow ();
 
-		int32_t ix;
-		int32_t iy = -1;
-		int32_t* origPixel = nullptr;
-		float origY = 0;
-		float origX = 0;
-		for (uint32_t y = 0; y < newHeight; y++, origY += yRatio)
-		{
-			int32_t* copyPixel = (int32_t*)(copyAddress + y * copyBytesPerRow);
-			if (iy != (int32_t)origY)
-				iy = (int32_t)origY;
-			ix = -1;
-			origX = 0;
-			for (uint32_t x = 0; x < newWidth; x++, origX += xRatio, copyPixel++)
+		// the source positions are summed up like before the rows were processed in parallel
+		auto sourcePositions = [] (uint32_t newSize, uint32_t origSize, float ratio) {
+			std::vector<uint32_t> positions (newSize);
+			float origPos = 0;
+			for (auto& pos : positions)
 			{
-				if (ix != (int32_t)origX || origPixel == nullptr)
-				{
-					ix = (int32_t)origX;
-					vstgui_assert (iy >= 0);
-					origPixel = (int32_t*)(origAddress + static_cast<uint32_t> (iy) * origBytesPerRow + ix * 4);
-				}
-				*copyPixel = *origPixel;
+				pos = std::min (static_cast<uint32_t> (origPos), origSize - 1);
+				origPos += ratio;
 			}
-		}
+			return positions;
+		};
+		auto columns = sourcePositions (newWidth, origWidth, xRatio);
+		auto rows = sourcePositions (newHeight, origHeight, yRatio);
+
+		auto numBands = getNumBands (newWidth, newHeight);
+		WorkerPool::instance ().perform (numBands, [&] (uint32_t band) {
+			forEachRowOfBand (band, numBands, newHeight, [&] (uint32_t y) {
+				auto origPixels = reinterpret_cast<const uint32_t*> (origAddress + static_cast<size_t> (rows[y]) * origBytesPerRow);
+				auto copyPixel = reinterpret_cast<uint32_t*> (copyAddress + static_cast<size_t> (y) * copyBytesPerRow);
+				for (auto column : columns)
+					*copyPixel++ = origPixels[column];
+			});
+		});
 	}
 };
 
@@ -782,11 +913,15 @@ public:
 private:
 	ScaleBiliniear () : ScaleBase ("A Biliniear Scale Filter") {}
 
-	void process (CBitmapPixelAccess& originalBitmap, CBitmapPixelAccess& copyBitmap) override
+	struct SourcePosition
 	{
-		originalBitmap.setPosition (0, 0);
-		copyBitmap.setPosition (0, 0);
+		uint32_t pos;
+		uint32_t nextPos;
+		float diff;
+	};
 
+	void process (CBitmapPixelAccess& originalBitmap, CBitmapPixelAccess& copyBitmap) override
+	{
 		uint32_t origWidth = (uint32_t)originalBitmap.getBitmapWidth ();
 		uint32_t origHeight = (uint32_t)originalBitmap.getBitmapHeight ();
 		uint32_t newWidth = (uint32_t)copyBitmap.getBitmapWidth ();
@@ -794,50 +929,319 @@ private:
 
 		float xRatio = ((float)(origWidth-1)) / (float)newWidth;
 		float yRatio = ((float)(origHeight-1)) / (float)newHeight;
-		float xDiff, yDiff, r, g, b, a;
-		uint32_t x, y;
-		CColor color[4];
-		CColor result;
 
-		for (uint32_t i = 0; i < newHeight; i++)
+		const uint8_t* origAddress = originalBitmap.getPlatformBitmapPixelAccess ()->getAddress ();
+		uint8_t* copyAddress = copyBitmap.getPlatformBitmapPixelAccess ()->getAddress ();
+		uint32_t origBytesPerRow = originalBitmap.getPlatformBitmapPixelAccess ()->getBytesPerRow ();
+		uint32_t copyBytesPerRow = copyBitmap.getPlatformBitmapPixelAccess ()->getBytesPerRow ();
+
+		// the next pixel is the last pixel at the edge
+		auto sourcePositions = [] (uint32_t newSize, uint32_t origSize, float ratio) {
+			std::vector<SourcePosition> positions (newSize);
+			for (uint32_t i = 0; i < newSize; i++)
+			{
+				auto pos = static_cast<uint32_t> (ratio * i);
+				positions[i].pos = std::min (pos, origSize - 1);
+				positions[i].nextPos = std::min (pos + 1, origSize - 1);
+				positions[i].diff = (ratio * i) - pos;
+			}
+			return positions;
+		};
+		auto columns = sourcePositions (newWidth, origWidth, xRatio);
+		auto rows = sourcePositions (newHeight, origHeight, yRatio);
+
+		// all four channels are interpolated the same way, so the pixel format does not matter
+		auto numBands = getNumBands (newWidth, newHeight);
+		WorkerPool::instance ().perform (numBands, [&] (uint32_t band) {
+			forEachRowOfBand (band, numBands, newHeight, [&] (uint32_t i) {
+				const auto& row = rows[i];
+				auto yDiff = row.diff;
+				auto origRow = origAddress + static_cast<size_t> (row.pos) * origBytesPerRow;
+				auto origNextRow = origAddress + static_cast<size_t> (row.nextPos) * origBytesPerRow;
+				auto copyPixel = copyAddress + static_cast<size_t> (i) * copyBytesPerRow;
+				for (const auto& column : columns)
+				{
+					auto xDiff = column.diff;
+					auto color0 = origRow + column.pos * 4;
+					auto color1 = origRow + column.nextPos * 4;
+					auto color2 = origNextRow + column.pos * 4;
+					auto color3 = origNextRow + column.nextPos * 4;
+					for (auto c = 0u; c < 4; ++c, ++copyPixel)
+					{
+						float value = color0[c] * (1.f - xDiff) * (1.f - yDiff) + color1[c] * xDiff * (1.f - yDiff)
+						+ color2[c] * yDiff * (1.f - xDiff) + color3[c] * xDiff * yDiff;
+						*copyPixel = (uint8_t)value;
+					}
+				}
+			});
+		});
+	}
+};
+
+//----------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------
+/** the weights of the source pixels for every output pixel of one dimension
+ *
+ *	The source positions outside of the bitmap are clamped to the edge pixels.
+ */
+struct ResampleWeights
+{
+	/** the weight of a source pixel starting at sourcePos for the output pixel centered at center
+	 *	(in source coordinates) with ratio = sourceSize / outputSize */
+	using WeightFunction = std::function<double (double sourcePos, double center, double ratio)>;
+
+	ResampleWeights (uint32_t sourceSize, uint32_t outputSize, double support,
+					 const WeightFunction& weightFunction)
+	: first (outputSize), count (outputSize)
+	{
+		auto ratio = static_cast<double> (sourceSize) / outputSize;
+		auto lastIndex = static_cast<int64_t> (sourceSize) - 1;
+		stride = std::min<uint32_t> (static_cast<uint32_t> (std::ceil (support * 2.)) + 2, sourceSize);
+		weights.resize (static_cast<size_t> (outputSize) * stride);
+		for (auto i = 0u; i < outputSize; ++i)
 		{
-			y = static_cast<uint32_t> (yRatio * i);
-			yDiff = (yRatio * i) - y;
+			auto center = (i + 0.5) * ratio;
+			auto start = static_cast<int64_t> (std::floor (center - support));
+			auto end = static_cast<int64_t> (std::ceil (center + support));
+			first[i] = static_cast<uint32_t> (std::min (std::max<int64_t> (start, 0), lastIndex));
+			auto last = static_cast<uint32_t> (std::min (std::max<int64_t> (end - 1, 0), lastIndex));
+			count[i] = std::min (last - first[i] + 1, stride);
+			auto outputWeights = weights.data () + static_cast<size_t> (i) * stride;
+			double sum = 0.;
+			for (auto pos = start; pos < end; ++pos)
+			{
+				auto weight = weightFunction (static_cast<double> (pos), center, ratio);
+				auto index = std::min<int64_t> (std::max<int64_t> (pos, first[i]), first[i] + count[i] - 1);
+				outputWeights[index - first[i]] += static_cast<float> (weight);
+				sum += weight;
+			}
+			if (sum != 0.)
+			{
+				for (auto k = 0u; k < count[i]; ++k)
+					outputWeights[k] = static_cast<float> (outputWeights[k] / sum);
+			}
+		}
+	}
+
+	const float* getWeights (uint32_t index) const
+	{
+		return weights.data () + static_cast<size_t> (index) * stride;
+	}
+
+	std::vector<uint32_t> first;
+	std::vector<uint32_t> count;
+	uint32_t stride;
+	std::vector<float> weights;
+};
+
+//----------------------------------------------------------------------------------------------------
+/** separable resampling of the pixels, first the rows and then the columns
+ *
+ *	All four channels of a pixel are resampled the same way. The output rows are processed in
+ *	bands on several threads, every band resamples the source rows it needs into its own buffer.
+ */
+class Resampler
+{
+public:
+	Resampler (const ResampleWeights& columns, const ResampleWeights& rows)
+	: columns (columns), rows (rows)
+	{
+	}
+
+	/** resample the pixels, colors are limited to the alpha value at alphaIndex, as the pixels are
+	 *	premultiplied */
+	void run (const uint8_t* source, uint32_t sourceBytesPerRow, uint8_t* output,
+			  uint32_t outputBytesPerRow, uint32_t alphaIndex) const
+	{
+		auto outputWidth = static_cast<uint32_t> (columns.first.size ());
+		auto outputHeight = static_cast<uint32_t> (rows.first.size ());
+		auto numBands = (outputHeight + kRowsPerBand - 1) / kRowsPerBand;
+		performJobs (static_cast<uint64_t> (outputWidth) * outputHeight, numBands, [&] (uint32_t band) {
+			auto firstRow = band * kRowsPerBand;
+			auto endRow = std::min (firstRow + kRowsPerBand, outputHeight);
+			auto sourceFirstRow = rows.first[firstRow];
+			uint32_t sourceEndRow = 0;
+			for (auto y = firstRow; y < endRow; ++y)
+				sourceEndRow = std::max (sourceEndRow, rows.first[y] + rows.count[y]);
+			auto floatsPerRow = static_cast<size_t> (outputWidth) * 4;
+			std::vector<float> buffer ((sourceEndRow - sourceFirstRow) * floatsPerRow + floatsPerRow);
+			auto rowSum = buffer.data () + (sourceEndRow - sourceFirstRow) * floatsPerRow;
+			for (auto y = sourceFirstRow; y < sourceEndRow; ++y)
+			{
+				resampleRow (source + static_cast<size_t> (y) * sourceBytesPerRow,
+							 buffer.data () + (y - sourceFirstRow) * floatsPerRow);
+			}
+			for (auto y = firstRow; y < endRow; ++y)
+			{
+				std::fill (rowSum, rowSum + floatsPerRow, 0.f);
+				auto weights = rows.getWeights (y);
+				for (auto k = 0u; k < rows.count[y]; ++k)
+				{
+					addRow (rowSum, buffer.data () + (rows.first[y] + k - sourceFirstRow) * floatsPerRow,
+							weights[k], outputWidth);
+				}
+				auto outputRow = output + static_cast<size_t> (y) * outputBytesPerRow;
+				storeRow (rowSum, outputRow, outputWidth);
+				for (auto x = 0u; x < outputWidth; ++x, outputRow += 4)
+				{
+					for (auto c = 0u; c < 4; ++c)
+						outputRow[c] = std::min (outputRow[c], outputRow[alphaIndex]);
+				}
+			}
+		});
+	}
+
+private:
+	static constexpr uint32_t kRowsPerBand = 32;
 
-			for (uint32_t j = 0; j < newWidth; j++, ++copyBitmap)
+	void resampleRow (const uint8_t* sourceRow, float* outputRow) const
+	{
+		auto outputWidth = static_cast<uint32_t> (columns.first.size ());
+		for (auto x = 0u; x < outputWidth; ++x, outputRow += 4)
+		{
+			auto weights = columns.getWeights (x);
+			auto sourcePixel = sourceRow + static_cast<size_t> (columns.first[x]) * 4;
+#if VSTGUI_BITMAPFILTER_SSE2
+			auto zero = _mm_setzero_si128 ();
+			auto sum = _mm_setzero_ps ();
+			for (auto k = 0u; k < columns.count[x]; ++k, sourcePixel += 4)
+			{
+				int32_t pixel;
+				memcpy (&pixel, sourcePixel, 4);
+				auto values = _mm_unpacklo_epi16 (_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (pixel), zero), zero);
+				sum = _mm_add_ps (sum, _mm_mul_ps (_mm_cvtepi32_ps (values), _mm_set1_ps (weights[k])));
+			}
+			_mm_storeu_ps (outputRow, sum);
+#else
+			float sum[4] = {};
+			for (auto k = 0u; k < columns.count[x]; ++k, sourcePixel += 4)
 			{
-				x = static_cast<uint32_t> (xRatio * j);
-				xDiff = (xRatio * j) - x;
-				originalBitmap.setPosition (x, y);
-				originalBitmap.getColor (color[0]);
-				originalBitmap.setPosition (x+1, y);
-				originalBitmap.getColor (color[1]);
-				originalBitmap.setPosition (x, y+1);
-				originalBitmap.getColor (color[2]);
-				originalBitmap.setPosition (x+1, y+1);
-				originalBitmap.getColor (color[3]);
-				r = color[0].red * (1.f - xDiff) * (1.f - yDiff) + color[1].red * xDiff * (1.f - yDiff)
-				+ color[2].red * yDiff * (1.f - xDiff) + color[3].red * xDiff * yDiff;
-				g = color[0].green * (1.f - xDiff) * (1.f - yDiff) + color[1].green * xDiff * (1.f - yDiff)
-				+ color[2].green * yDiff * (1.f - xDiff) + color[3].green * xDiff * yDiff;
-				b = color[0].blue * (1.f - xDiff) * (1.f - yDiff) + color[1].blue * xDiff * (1.f - yDiff)
-				+ color[2].blue * yDiff * (1.f - xDiff) + color[3].blue * xDiff * yDiff;
-				a = color[0].alpha * (1.f - xDiff) * (1.f - yDiff) + color[1].alpha * xDiff * (1.f - yDiff)
-				+ color[2].alpha * yDiff * (1.f - xDiff) + color[3].alpha * xDiff * yDiff;
-				result = CColor ((uint8_t)r, (uint8_t)g, (uint8_t)b, (uint8_t)a);
-				copyBitmap.setColor (result);
+				for (auto c = 0u; c < 4; ++c)
+					sum[c] += sourcePixel[c] * weights[k];
 			}
+			std::copy (sum, sum + 4, outputRow);
+#endif
 		}
 	}
+
+	static void addRow (float* rowSum, const float* row, float weight, uint32_t width)
+	{
+#if VSTGUI_BITMAPFILTER_SSE2
+		auto weightVector = _mm_set1_ps (weight);
+		for (auto x = 0u; x < width; ++x, rowSum += 4, row += 4)
+			_mm_storeu_ps (rowSum, _mm_add_ps (_mm_loadu_ps (rowSum), _mm_mul_ps (_mm_loadu_ps (row), weightVector)));
+#else
+		for (auto i = 0u; i < width * 4; ++i)
+			rowSum[i] += row[i] * weight;
+#endif
+	}
+
+	static void storeRow (const float* rowSum, uint8_t* outputRow, uint32_t width)
+	{
+#if VSTGUI_BITMAPFILTER_SSE2
+		for (auto x = 0u; x < width; ++x, rowSum += 4, outputRow += 4)
+		{
+			auto values = _mm_cvtps_epi32 (_mm_loadu_ps (rowSum));
+			values = _mm_packus_epi16 (_mm_packs_epi32 (values, values), values);
+			auto pixel = _mm_cvtsi128_si32 (values);
+			memcpy (outputRow, &pixel, 4);
+		}
+#else
+		for (auto i = 0u; i < width * 4; ++i)
+			outputRow[i] = static_cast<uint8_t> (std::min (std::max (std::round (rowSum[i]), 0.f), 255.f));
+#endif
+	}
+
+	const ResampleWeights& columns;
+	const ResampleWeights& rows;
+};
+
+//----------------------------------------------------------------------------------------------------
+class ResampleBase : public ScaleBase
+{
+protected:
+	ResampleBase (UTF8StringPtr description) : ScaleBase (description) {}
+
+	virtual ResampleWeights createWeights (uint32_t sourceSize, uint32_t outputSize) const = 0;
+
+	void process (CBitmapPixelAccess& originalBitmap, CBitmapPixelAccess& copyBitmap) override
+	{
+		auto columns = createWeights (originalBitmap.getBitmapWidth (), copyBitmap.getBitmapWidth ());
+		auto rows = createWeights (originalBitmap.getBitmapHeight (), copyBitmap.getBitmapHeight ());
+		auto original = originalBitmap.getPlatformBitmapPixelAccess ();
+		auto copy = copyBitmap.getPlatformBitmapPixelAccess ();
+		Resampler (columns, rows)
+			.run (original->getAddress (), original->getBytesPerRow (), copy->getAddress (),
+				  copy->getBytesPerRow (), copyBitmap.getChannelPositions ().alpha);
+	}
+};
+
+//----------------------------------------------------------------------------------------------------
+class ScaleAreaAverage : public ResampleBase
+{
+public:
+	static IFilter* CreateFunction (IdStringPtr _name)
+	{
+		return new ScaleAreaAverage ();
+	}
+
+private:
+	ScaleAreaAverage () : ResampleBase ("An Area Average Scale Filter") {}
+
+	ResampleWeights createWeights (uint32_t sourceSize, uint32_t outputSize) const override
+	{
+		// the weight is the part of the source pixel which is covered by the output pixel
+		return ResampleWeights (sourceSize, outputSize, static_cast<double> (sourceSize) / outputSize / 2.,
+								[] (double sourcePos, double center, double ratio) {
+									auto start = std::max (sourcePos, center - ratio / 2.);
+									auto end = std::min (sourcePos + 1., center + ratio / 2.);
+									return std::max (end - start, 0.);
+								});
+	}
+};
+
+//----------------------------------------------------------------------------------------------------
+class ScaleLanczos : public ResampleBase
+{
+public:
+	static IFilter* CreateFunction (IdStringPtr _name)
+	{
+		return new ScaleLanczos ();
+	}
+
+private:
+	ScaleLanczos () : ResampleBase ("A Lanczos Scale Filter") {}
+
+	static double sinc (double x)
+	{
+		if (x == 0.)
+			return 1.;
+		x *= M_PI;
+		return std::sin (x) / x;
+	}
+
+	ResampleWeights createWeights (uint32_t sourceSize, uint32_t outputSize) const override
+	{
+		// when downscaling the kernel is stretched to the size of an output pixel
+		auto scale = std::max (static_cast<double> (sourceSize) / outputSize, 1.);
+		return ResampleWeights (sourceSize, outputSize, 3. * scale,
+								[scale] (double sourcePos, double center, double) {
+									auto x = (sourcePos + 0.5 - center) / scale;
+									if (std::abs (x) >= 3.)
+										return 0.;
+									return sinc (x) * sinc (x / 3.);
+								});
+	}
 };
 
 //----------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------
-using SimpleFilterProcessFunction = void (*) (CColor& color, FilterBase* self);
+using SimpleFilterProcessFunction = void (*) (CColor& color, const FilterBase* self);
 
 template<typename SimpleFilterProcessFunction>
-class SimpleFilter : public FilterBase
+class SimpleFilter : public FilterBase, public IPixelFilter
 {
 protected:
 	SimpleFilter (UTF8StringPtr description, SimpleFilterProcessFunction function)
@@ -847,22 +1251,30 @@ protected:
 		registerProperty (Property::kInputBitmap, BitmapFilter::Property (BitmapFilter::Property::kObject));
 	}
 
+	bool preparePixelProcessing () override { return true; }
+
+	void processPixel (CColor& color) const override { processFunction (color, this); }
+	bool isAlphaPremultiplied () const override { return alphaPremultiplied; }
+
 	bool run (bool replace) override
 	{
+		if (!preparePixelProcessing ())
+			return false;
 		SharedPointer<CBitmap> inputBitmap = getInputBitmap ();
 		if (inputBitmap == nullptr)
 			return false;
-		SharedPointer<CBitmapPixelAccess> inputAccessor = owned (CBitmapPixelAccess::create (inputBitmap));
+		// processPixels reaches every row via getRow, so the rows can be converted on demand
+		SharedPointer<CBitmapPixelAccess> inputAccessor = owned (CBitmapPixelAccess::create (inputBitmap, alphaPremultiplied, true));
 		if (inputAccessor == nullptr)
 			return false;
 		SharedPointer<CBitmap> outputBitmap;
 		SharedPointer<CBitmapPixelAccess> outputAccessor;
 		if (replace == false)
 		{
-			outputBitmap = owned (new CBitmap (inputBitmap->getWidth (), inputBitmap->getHeight ()));
+			outputBitmap = owned (new CBitmap (inputBitmap->getSize (), inputBitmap->getPlatformBitmap ()->getScaleFactor ()));
 			if (outputBitmap == nullptr)
 				return false;
-			outputAccessor = owned (CBitmapPixelAccess::create (outputBitmap));
+			outputAccessor = owned (CBitmapPixelAccess::create (outputBitmap, alphaPremultiplied, true));
 			if (outputAccessor == nullptr)
 				return false;
 		}
@@ -871,39 +1283,13 @@ protected:
 			outputBitmap = inputBitmap;
 			outputAccessor = inputAccessor;
 		}
-		run (*inputAccessor, *outputAccessor);
+		processPixels (*inputAccessor, *outputAccessor, {this});
 		return registerProperty (Property::kOutputBitmap, BitmapFilter::Property (outputBitmap));
 	}
 
-	void run (CBitmapPixelAccess& inputAccessor, CBitmapPixelAccess& outputAccessor)
-	{
-		inputAccessor.setPosition (0, 0);
-		outputAccessor.setPosition (0, 0);
-		CColor color;
-		if (&inputAccessor == &outputAccessor)
-		{
-			do
-			{
-				inputAccessor.getColor (color);
-				processFunction (color, this);
-				outputAccessor.setColor (color);
-			}
-			while (++inputAccessor);
-		}
-		else
-		{
-			do
-			{
-				inputAccessor.getColor (color);
-				processFunction (color, this);
-				outputAccessor.setColor (color);
-				++outputAccessor;
-			}
-			while (++inputAccessor);
-		}
-	}
-
 	SimpleFilterProcessFunction processFunction;
+	/** filters which compare or replace colors need the pixels with straight alpha */
+	bool alphaPremultiplied {true};
 };
 
 //----------------------------------------------------------------------------------------------------
@@ -921,22 +1307,24 @@ private:
 	SetColor ()
 	: SimpleFilter<SimpleFilterProcessFunction> ("A Set Color Filter", processSetColor)
 	{
+		alphaPremultiplied = false;
 		registerProperty (Property::kIgnoreAlphaColorValue, BitmapFilter::Property ((int32_t)1));
 		registerProperty (Property::kInputColor, BitmapFilter::Property (kWhiteCColor));
 	}
 
-	static void processSetColor (CColor& color, FilterBase* obj)
+	static void processSetColor (CColor& color, const FilterBase* obj)
 	{
-		SetColor* filter = static_cast<SetColor*> (obj);
-		if (filter->ignoreAlpha)
-			filter->inputColor.alpha = color.alpha;
+		auto filter = static_cast<const SetColor*> (obj);
+		auto alpha = color.alpha;
 		color = filter->inputColor;
+		if (filter->ignoreAlpha)
+			color.alpha = alpha;
 	}
 
 	bool ignoreAlpha;
 	CColor inputColor;
 
-	bool run (bool replace) override
+	bool preparePixelProcessing () override
 	{
 		const auto& inputColorProp = getProperty (Property::kInputColor);
 		const auto& ignoreAlphaProp = getProperty (Property::kIgnoreAlphaColorValue);
@@ -945,7 +1333,7 @@ private:
 			return false;
 		inputColor = inputColorProp.getColor ();
 		ignoreAlpha = ignoreAlphaProp.getInteger () > 0;
-		return SimpleFilter<SimpleFilterProcessFunction>::run (replace);
+		return true;
 	}
 };
 
@@ -966,7 +1354,7 @@ private:
 	{
 	}
 
-	static void processGrayscale (CColor& color, FilterBase* obj)
+	static void processGrayscale (CColor& color, const FilterBase* obj)
 	{
 		color.red = color.green = color.blue = color.getLuma ();
 	}
@@ -988,13 +1376,14 @@ private:
 	ReplaceColor ()
 	: SimpleFilter<SimpleFilterProcessFunction> ("A Replace Color Filter", processReplace)
 	{
+		alphaPremultiplied = false;
 		registerProperty (Property::kInputColor, BitmapFilter::Property (kWhiteCColor));
 		registerProperty (Property::kOutputColor, BitmapFilter::Property (kTransparentCColor));
 	}
 
-	static void processReplace (CColor& color, FilterBase* obj)
+	static void processReplace (CColor& color, const FilterBase* obj)
 	{
-		ReplaceColor* filter = static_cast<ReplaceColor*> (obj);
+		auto filter = static_cast<const ReplaceColor*> (obj);
 		if (color == filter->inputColor)
 			color = filter->outputColor;
 	}
@@ -1002,7 +1391,7 @@ private:
 	CColor inputColor;
 	CColor outputColor;
 
-	bool run (bool replace) override
+	bool preparePixelProcessing () override
 	{
 		const auto& inputColorProp = getProperty (Property::kInputColor);
 		const auto& outputColorProp = getProperty (Property::kOutputColor);
@@ -1011,7 +1400,7 @@ private:
 			return false;
 		inputColor = inputColorProp.getColor ();
 		outputColor = outputColorProp.getColor ();
-		return SimpleFilter<SimpleFilterProcessFunction>::run (replace);
+		return true;
 	}
 };
 
@@ -1021,15 +1410,88 @@ private:
 void registerStandardFilters (Factory& factory)
 {
 	factory.registerFilter (kBoxBlur, BoxBlur::CreateFunction);
+	factory.registerFilter (kGaussianBlur, GaussianBlur::CreateFunction);
 	factory.registerFilter (kSetColor, SetColor::CreateFunction);
 	factory.registerFilter (kGrayscale, Grayscale::CreateFunction);
 	factory.registerFilter (kReplaceColor, ReplaceColor::CreateFunction);
 	factory.registerFilter (kScaleBilinear, ScaleBiliniear::CreateFunction);
 	factory.registerFilter (kScaleLinear, ScaleLinear::CreateFunction);
+	factory.registerFilter (kScaleAreaAverage, ScaleAreaAverage::CreateFunction);
+	factory.registerFilter (kScaleLanczos, ScaleLanczos::CreateFunction);
 }
 
 } // Standard
 
 ///@endcond
 
+//----------------------------------------------------------------------------------------------------
+void Pipeline::addFilter (IFilter* filter)
+{
+	if (filter)
+		filters.emplace_back (filter);
+}
+
+//----------------------------------------------------------------------------------------------------
+SharedPointer<CBitmap> Pipeline::run (CBitmap* inputBitmap) const
+{
+	SharedPointer<CBitmap> result;
+	CBitmap* currentBitmap = inputBitmap;
+	std::vector<const IPixelFilter*> pixelFilters;
+	auto runPixelFilters = [&] () {
+		if (pixelFilters.empty ())
+			return;
+		auto alphaPremultiplied = pixelFilters.front ()->isAlphaPremultiplied ();
+		SharedPointer<CBitmapPixelAccess> inputAccessor = owned (CBitmapPixelAccess::create (currentBitmap, alphaPremultiplied, true));
+		if (inputAccessor)
+		{
+			if (result)
+			{
+				Standard::processPixels (*inputAccessor, *inputAccessor, pixelFilters);
+			}
+			else
+			{
+				auto outputBitmap = owned (new CBitmap (currentBitmap->getSize (), currentBitmap->getPlatformBitmap ()->getScaleFactor ()));
+				SharedPointer<CBitmapPixelAccess> outputAccessor = owned (CBitmapPixelAccess::create (outputBitmap, alphaPremultiplied, true));
+				if (outputAccessor)
+				{
+					Standard::processPixels (*inputAccessor, *outputAccessor, pixelFilters);
+					result = outputBitmap;
+				}
+			}
+		}
+		currentBitmap = result ? result.get () : inputBitmap;
+		pixelFilters.clear ();
+	};
+	for (const auto& filter : filters)
+	{
+		if (auto pixelFilter = dynamic_cast<IPixelFilter*> (filter.get ()))
+		{
+			if (pixelFilter->preparePixelProcessing ())
+			{
+				// the filters of one pass see the pixels with the same alpha mode
+				if (!pixelFilters.empty () &&
+					pixelFilters.front ()->isAlphaPremultiplied () != pixelFilter->isAlphaPremultiplied ())
+					runPixelFilters ();
+				pixelFilters.push_back (pixelFilter);
+			}
+			continue;
+		}
+		runPixelFilters ();
+		filter->setProperty (Standard::Property::kInputBitmap, currentBitmap);
+		// the blurs can work in place on a bitmap which was created by the pipeline
+		bool inPlace = result && dynamic_cast<Standard::BlurBase*> (filter.get ());
+		if (filter->run (inPlace))
+		{
+			auto obj = filter->getProperty (Standard::Property::kOutputBitmap).getObject ();
+			if (auto outputBitmap = dynamic_cast<CBitmap*> (obj))
+			{
+				result = outputBitmap;
+				currentBitmap = outputBitmap;
+			}
+		}
+	}
+	runPixelFilters ();
+	return result;
+}
+
 }} // namespaces
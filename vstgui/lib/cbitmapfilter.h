@@ -85,6 +85,44 @@ public:
 	using CreateFunction = IFilter* (*) (IdStringPtr name);
 };
 
+//----------------------------------------------------------------------------------------------------
+/// @brief Interface for filters which change every pixel independently of the other pixels
+/// @details A Pipeline runs consecutive pixel filters together in one pass over the pixels.
+//----------------------------------------------------------------------------------------------------
+class IPixelFilter
+{
+public:
+	virtual ~IPixelFilter () noexcept = default;
+
+	/** read the properties of the filter before processPixel is called. returns false if a property is invalid */
+	virtual bool preparePixelProcessing () = 0;
+	/** process one pixel. called concurrently for different pixels after preparePixelProcessing */
+	virtual void processPixel (CColor& color) const = 0;
+	/** whether processPixel gets the colors with premultiplied or straight alpha */
+	virtual bool isAlphaPremultiplied () const { return true; }
+};
+
+//----------------------------------------------------------------------------------------------------
+/// @brief Runs a list of filters one after the other on a bitmap
+/// @details Consecutive filters which implement IPixelFilter and use the same alpha mode are run
+/// together in one pass over the pixels, the other filters are run with IFilter::run. Bitmaps are only created for the output and
+/// where a filter can not work in place. The pixel filters do not set Property::kOutputBitmap.
+//----------------------------------------------------------------------------------------------------
+class Pipeline
+{
+public:
+	void addFilter (IFilter* filter);
+	bool empty () const { return filters.empty (); }
+
+	/** run the filters on the input bitmap, filters which fail are skipped.
+		The input bitmap is not changed.
+		@return the resulting bitmap or nullptr if no filter succeeded */
+	SharedPointer<CBitmap> run (CBitmap* inputBitmap) const;
+
+private:
+	std::vector<SharedPointer<IFilter>> filters;
+};
+
 //----------------------------------------------------------------------------------------------------
 /// @brief Bitmap Filter Factory.
 /// @ingroup new_in_4_1
@@ -121,6 +159,19 @@ namespace Standard {
 	*/
 	static const IdStringPtr kBoxBlur = "Box Blur";
 
+	/** Gaussian Blur Filter Name.
+
+		Applies an approximated gaussian blur with three box blurs on the input bitmap. This is
+		faster than running the box blur filter three times.
+
+		Properties:
+			- Property::kInputBitmap
+			- Property::kStandardDeviation
+			- Property::kAlphaChannelOnly
+			- Property::kOutputBitmap
+	*/
+	static const IdStringPtr kGaussianBlur = "Gaussian Blur";
+
 	/** Grayscale Filter Name.
 	 
 		Produces a grayscale version of the input bitmap.
@@ -181,6 +232,32 @@ namespace Standard {
 	 */
 	static const IdStringPtr kScaleLinear = "Scale Linear";
 
+	/** Scale Area Average Filter Name.
+
+		Creates a scaled bitmap of the input bitmap where every pixel is the average of the input
+		pixels it covers. Does not alias when downscaling by large factors.
+		Does not work inplace.
+
+		Properties:
+			- Property::kInputBitmap
+			- Property::kOutputRect
+			- Property::kOutputBitmap
+	 */
+	static const IdStringPtr kScaleAreaAverage = "Scale Area Average";
+
+	/** Scale Lanczos Filter Name.
+
+		Creates a scaled bitmap of the input bitmap with a Lanczos-3 filter, which keeps edges
+		sharper than the other scale filters.
+		Does not work inplace.
+
+		Properties:
+			- Property::kInputBitmap
+			- Property::kOutputRect
+			- Property::kOutputBitmap
+	 */
+	static const IdStringPtr kScaleLanczos = "Scale Lanczos";
+
 	/** @brief Standard Bitmap Property Names */
 	namespace Property
 	{
@@ -200,6 +277,8 @@ namespace Standard {
 		static const IdStringPtr kIgnoreAlphaColorValue = "IgnoreAlphaColorValue";
 		/** [Property::kInteger] */
 		static const IdStringPtr kAlphaChannelOnly = "AlphaChannelOnly";
+		/** [Property::kFloat] */
+		static const IdStringPtr kStandardDeviation = "StandardDeviation";
 	} // Property
 
 } // Standard
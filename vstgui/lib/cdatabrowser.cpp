@@ -302,7 +302,7 @@ void CDataBrowser::recalculateLayout (bool rememberSelection)
 
 	if (style & kDrawHeader)
 	{
-		for (const auto& pV : getChildren ())
+		for (const auto& pV : getChildViews ())
 		{
 			CRect viewSize = pV->getViewSize ();
 			if (pV != dbHeaderContainer && viewSize.top < headerHeight+lineWidth)
@@ -156,6 +156,48 @@ void CDrawContext::resetClipRect ()
 	currentState.clipRect = surfaceRect;
 }
 
+//-----------------------------------------------------------------------------
+void CDrawContext::setDrawRegion (const RectList& rects)
+{
+	drawRegion.clear ();
+	drawRegion.reserve (rects.size ());
+	for (auto r : rects)
+	{
+		getCurrentTransform ().transform (r);
+		r.normalize ();
+		drawRegion.emplace_back (r);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void CDrawContext::clearDrawRegion ()
+{
+	drawRegion.clear ();
+}
+
+//-----------------------------------------------------------------------------
+CRect CDrawContext::boundToDrawRegion (const CRect& rect) const
+{
+	if (drawRegion.empty ())
+		return rect;
+	CRect absRect (rect);
+	getCurrentTransform ().transform (absRect);
+	absRect.normalize ();
+	CRect result;
+	for (auto part : drawRegion)
+	{
+		part.bound (absRect);
+		if (part.isEmpty ())
+			continue;
+		if (result.isEmpty ())
+			result = part;
+		else
+			result.unite (part);
+	}
+	getCurrentTransform ().inverse ().transform (result);
+	return result.normalize ();
+}
+
 //-----------------------------------------------------------------------------
 void CDrawContext::setFillColor (const CColor& color)
 {
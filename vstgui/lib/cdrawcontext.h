@@ -119,6 +119,36 @@ public:
 	virtual void resetClipRect ();
 	//@}
 
+	//-----------------------------------------------------------------------------
+	/// @name Draw Region
+	//-----------------------------------------------------------------------------
+	//@{
+	using RectList = std::vector<CRect>;
+	/** set the dirty rectangles which are drawn in one pass.
+	 *
+	 *	The rectangles must not overlap and are expected in the current coordinate system.
+	 *	Views can use the draw region to skip drawing outside of the dirty rectangles.
+	 */
+	void setDrawRegion (const RectList& rects);
+	/** remove the draw region */
+	void clearDrawRegion ();
+	/** returns true if a draw region is set */
+	bool hasDrawRegion () const { return !drawRegion.empty (); }
+	/** returns the bounding box of all parts of the draw region intersecting rect.
+	 *
+	 *	If no draw region is set rect is returned. The result is empty if rect does not intersect
+	 *	the draw region.
+	 */
+	CRect boundToDrawRegion (const CRect& rect) const;
+	/** call proc for each part of the draw region intersecting rect, with the clip set to it.
+	 *
+	 *	If no draw region is set, proc is called once with rect. rect is expected to be already
+	 *	bound to the current clip, the clip is restored afterwards.
+	 */
+	template<typename Proc>
+	void forEachDrawRegionPart (const CRect& rect, Proc proc);
+	//@}
+
 	//-----------------------------------------------------------------------------
 	/// @name Color
 	//-----------------------------------------------------------------------------
@@ -277,8 +307,37 @@ private:
 
 	std::stack<CDrawContextState> globalStatesStack;
 	std::stack<CGraphicsTransform> transformStack;
+	RectList drawRegion;
 };
 
+//-----------------------------------------------------------------------------
+template<typename Proc>
+inline void CDrawContext::forEachDrawRegionPart (const CRect& rect, Proc proc)
+{
+	CRect origClip;
+	getClipRect (origClip);
+	if (drawRegion.empty ())
+	{
+		setClipRect (rect);
+		proc (rect);
+	}
+	else
+	{
+		auto inverse = getCurrentTransform ().inverse ();
+		for (auto part : drawRegion)
+		{
+			inverse.transform (part);
+			part.normalize ();
+			part.bound (rect);
+			if (part.isEmpty ())
+				continue;
+			setClipRect (part);
+			proc (part);
+		}
+	}
+	setClipRect (origClip);
+}
+
 //-----------------------------------------------------------------------------
 struct ConcatClip
 {
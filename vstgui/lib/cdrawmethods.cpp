@@ -7,55 +7,112 @@
 #include "cstring.h"
 #include "cdrawcontext.h"
 #include "platform/iplatformfont.h"
+#include <vector>
 
 namespace VSTGUI {
 
 namespace CDrawMethods {
 
 //------------------------------------------------------------------------
-UTF8String createTruncatedText (TextTruncateMode mode, const UTF8String& text, CFontRef font,
-                                CCoord maxWidth, const CPoint& textInset, uint32_t flags)
+namespace {
+
+//------------------------------------------------------------------------
+/** creates the truncated variants of a text */
+class TruncatedTextBuilder
 {
-	if (mode == kTextTruncateNone)
-		return text;
-	auto painter = font->getPlatformFont () ? font->getPlatformFont ()->getPainter () : nullptr;
-	if (!painter)
-		return text;
-	CCoord width = painter->getStringWidth (nullptr, text.getPlatformString (), true);
-	width += textInset.x * 2;
-	if (width > maxWidth)
+public:
+	TruncatedTextBuilder (TextTruncateMode mode, const UTF8String& text) : mode (mode)
 	{
-		std::string truncatedText;
-		UTF8String result;
-		auto left = text.begin ();
-		auto right = text.end ();
-		while (width > maxWidth && left != right)
+		for (auto it = text.begin (); it != text.end (); ++it)
+			positions.emplace_back (it.base ());
+		positions.emplace_back (text.end ().base ());
+	}
+
+	size_t getNumCodePoints () const { return positions.size () - 1; }
+
+	/** returns the placeholder together with numKept code points of the text */
+	UTF8String create (size_t numKept) const
+	{
+		auto numCodePoints = getNumCodePoints ();
+		std::string result;
+		switch (mode)
 		{
-			if (mode == kTextTruncateHead)
+			case kTextTruncateHead:
 			{
-				++left;
-				truncatedText = "..";
+				result = "..";
+				result.append (positions[numCodePoints - numKept], positions.back ());
+				break;
 			}
-			else if (mode == kTextTruncateTail)
+			case kTextTruncateTail:
 			{
-				--right;
-				truncatedText = "";
+				result.assign (positions.front (), positions[numKept]);
+				result += "..";
+				break;
 			}
+			case kTextTruncateMiddle:
+			{
+				auto numHead = (numKept + 1) / 2;
+				result.assign (positions.front (), positions[numHead]);
+				result += "..";
+				result.append (positions[numCodePoints - (numKept - numHead)], positions.back ());
+				break;
+			}
+			case kTextTruncateNone: break;
+		}
+		return UTF8String (std::move (result));
+	}
+
+private:
+	TextTruncateMode mode;
+	std::vector<std::string::const_iterator> positions;
+};
 
-			truncatedText += {left.base (), right.base ()};
+//------------------------------------------------------------------------
+} // anonymous
 
-			if (mode == kTextTruncateTail)
-				truncatedText += "..";
+//------------------------------------------------------------------------
+UTF8String createTruncatedText (TextTruncateMode mode, const UTF8String& text, CFontRef font,
+                                CCoord maxWidth, const CPoint& textInset, uint32_t flags)
+{
+	if (mode == kTextTruncateNone)
+		return text;
+	auto painter = font->getPlatformFont () ? font->getPlatformFont ()->getPainter () : nullptr;
+	if (!painter)
+		return text;
+	auto measure = [&] (const UTF8String& str) {
+		return painter->getStringWidth (nullptr, str.getPlatformString (), true) +
+		       textInset.x * 2;
+	};
+	if (measure (text) <= maxWidth)
+		return text;
 
-			result = truncatedText;
-			width = painter->getStringWidth (nullptr, result.getPlatformString (), true);
-			width += textInset.x * 2;
+	TruncatedTextBuilder builder (mode, text);
+	if (builder.getNumCodePoints () == 0)
+		return {};
+	// the width grows with the number of kept code points. The candidates are measured as a
+	// whole instead of adding up the widths of the characters as these would miss the kerning
+	size_t fitting = 0;
+	size_t tooWide = builder.getNumCodePoints ();
+	UTF8String result;
+	while (tooWide - fitting > 1)
+	{
+		auto numKept = fitting + (tooWide - fitting) / 2;
+		auto candidate = builder.create (numKept);
+		if (measure (candidate) <= maxWidth)
+		{
+			fitting = numKept;
+			result = std::move (candidate);
 		}
-		if (left == right && flags & kReturnEmptyIfTruncationIsPlaceholderOnly)
-			result = "";
-		return result;
+		else
+			tooWide = numKept;
+	}
+	if (fitting == 0)
+	{
+		if (flags & kReturnEmptyIfTruncationIsPlaceholderOnly)
+			return {};
+		return builder.create (0);
 	}
-	return text;
+	return result;
 }
 
 //------------------------------------------------------------------------
@@ -29,7 +29,8 @@ enum IconPosition : uint16_t {
 enum TextTruncateMode : uint16_t {
 	kTextTruncateNone = 0,
 	kTextTruncateHead,
-	kTextTruncateTail
+	kTextTruncateTail,
+	kTextTruncateMiddle
 };
 
 //-----------------------------------------------------------------------------
@@ -40,6 +41,9 @@ enum CreateTextTruncateFlags : uint16_t {
 
 //-----------------------------------------------------------------------------
 /** create a truncated string
+ *
+ *	The number of characters kept is found with a binary search, so only a logarithmic number of
+ *	strings are measured.
  *
  *	@param mode			truncation mode
  *	@param text			text string
@@ -5,6 +5,7 @@
 #include "cframe.h"
 #include "events.h"
 #include "finally.h"
+#include "cbitmap.h"
 #include "coffscreencontext.h"
 #include "ctooltipsupport.h"
 #include "cinvalidrectlist.h"
@@ -233,7 +234,7 @@ bool CFrame::attached (CView* parent)
 	{
 		setParentView (nullptr);
 
-		for (const auto& pV : getChildren ())
+		for (const auto& pV : getChildViews ().snapshot ())
 			pV->attached (this);
 		
 		return true;
@@ -321,6 +322,12 @@ void CFrame::draw (CDrawContext* pContext)
 	return CFrame::drawRect (pContext, getViewSize ());
 }
 
+//-----------------------------------------------------------------------------
+bool CFrame::isDrawThreadSafe () const
+{
+	return isExactType (this);
+}
+
 //-----------------------------------------------------------------------------
 void CFrame::drawRect (CDrawContext* pContext, const CRect& updateRect)
 {
@@ -1500,7 +1507,7 @@ void CFrame::scrollRect (const CRect& src, const CPoint& distance)
 //-----------------------------------------------------------------------------
 void CFrame::invalidate (const CRect &rect)
 {
-	for (const auto& pV : getChildren ())
+	for (const auto& pV : getChildViews ())
 	{
 		CRect rectView = pV->getViewSize ();
 		if (rect.rectOverlap (rectView))
@@ -1666,6 +1673,40 @@ bool CFrame::platformDrawRect (CDrawContext* context, const CRect& rect)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+bool CFrame::platformPrepareConcurrentDraw (CDrawContext* context, const CRect& rect)
+{
+	if (!isAttached () || rect.isEmpty ())
+		return false;
+	return prepareConcurrentDraw (context, rect);
+}
+
+//-----------------------------------------------------------------------------
+bool CFrame::platformDrawRects (CDrawContext* context, const std::vector<CRect>& rects)
+{
+	if (rects.empty ())
+		return false;
+	if (rects.size () == 1)
+		return platformDrawRect (context, rects.front ());
+
+	// the parts of a draw region must not overlap, otherwise transparent views would be drawn
+	// twice into the overlapping area
+	CInvalidRectList::MergePolicy policy;
+	policy.mergeOverlapping = true;
+	CInvalidRectList region (policy);
+	for (const auto& r : rects)
+		region.add (r);
+
+	CRect updateRect (*region.begin ());
+	for (const auto& r : region)
+		updateRect.unite (r);
+
+	context->setDrawRegion (region.data ());
+	drawRect (context, updateRect);
+	context->clearDrawRegion ();
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void CFrame::platformOnEvent (Event& event)
 {
@@ -1746,6 +1787,8 @@ void CFrame::platformScaleFactorChanged (double newScaleFactor)
 //-----------------------------------------------------------------------------
 void CFrame::dispatchNewScaleFactor (double newScaleFactor)
 {
+	// the bitmaps are drawn with other scale factors now
+	CBitmap::clearAllScaledVariants ();
 	pImpl->scaleFactorChangedListenerList.forEach ([&] (IScaleFactorChangedListener* listener) {
 		listener->onScaleFactorChanged (this, newScaleFactor);
 	});
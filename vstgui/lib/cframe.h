@@ -221,6 +221,7 @@ public:
 	bool attached (CView* parent) override;
 	void draw (CDrawContext* pContext) override;
 	void drawRect (CDrawContext* pContext, const CRect& updateRect) override;
+	bool isDrawThreadSafe () const override;
 	void setViewSize (const CRect& rect, bool invalid = true) override;
 	void dispatchEvent (Event& event) override;
 
@@ -257,6 +258,8 @@ protected:
 
 	// platform frame
 	bool platformDrawRect (CDrawContext* context, const CRect& rect) override;
+	bool platformDrawRects (CDrawContext* context, const std::vector<CRect>& rects) override;
+	bool platformPrepareConcurrentDraw (CDrawContext* context, const CRect& rect) override;
 	void platformOnEvent (Event& event) override;
 	DragOperation platformOnDragEnter (DragEventData data) override;
 	DragOperation platformOnDragMove (DragEventData data) override;
@@ -122,6 +122,36 @@ void CGradientView::setViewSize (const CRect& rect, bool invalid)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void CGradientView::createPath (CDrawContext* context)
+{
+	auto lineWidth = getFrameWidth ();
+	if (lineWidth < 0.)
+		lineWidth = context->getHairlineSize ();
+	CRect r = getViewSize ();
+	r.inset (lineWidth / 2., lineWidth / 2.);
+	path = owned (context->createRoundRectGraphicsPath (r, roundRectRadius));
+}
+
+//-----------------------------------------------------------------------------
+bool CGradientView::isDrawThreadSafe () const
+{
+	return isExactType (this);
+}
+
+//-----------------------------------------------------------------------------
+bool CGradientView::prepareConcurrentDraw (CDrawContext* context, const CRect& updateRect)
+{
+	if (!CView::prepareConcurrentDraw (context, updateRect))
+		return false;
+	if (path == nullptr)
+		createPath (context);
+	// the platform path is built lazily, too
+	if (path)
+		path->getBoundingBox ();
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void CGradientView::draw (CDrawContext* context)
 {
@@ -129,11 +159,7 @@ void CGradientView::draw (CDrawContext* context)
 	if (lineWidth < 0.)
 		lineWidth = context->getHairlineSize ();
 	if (path == nullptr)
-	{
-		CRect r = getViewSize ();
-		r.inset (lineWidth / 2., lineWidth / 2.);
-		path = owned (context->createRoundRectGraphicsPath (r, roundRectRadius));
-	}
+		createPath (context);
 	if (path && gradient)
 	{
 		context->setDrawMode (drawAntialiased ? kAntiAliasing : kAliasing);
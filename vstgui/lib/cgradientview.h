@@ -54,8 +54,11 @@ public:
 	// override
 	void setViewSize (const CRect& rect, bool invalid = true) override;
 	void draw (CDrawContext* context) override;
+	bool isDrawThreadSafe () const override;
+	bool prepareConcurrentDraw (CDrawContext* context, const CRect& updateRect) override;
 protected:
 	virtual void attributeChanged ();
+	void createPath (CDrawContext* context);
 
 	GradientStyle gradientStyle {kLinearGradient};
 	CColor frameColor {kBlackCColor};
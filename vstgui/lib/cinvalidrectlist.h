@@ -5,16 +5,54 @@
 #pragma once
 
 #include "crect.h"
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace VSTGUI {
 
 //-----------------------------------------------------------------------------
+/** List of invalid rectangles
+ *
+ *	The rectangles are kept sorted by their top coordinate, so that adding a new rectangle only
+ *	needs to look at the band of rectangles which vertically overlap or touch it. Two rectangles
+ *	with a vertical gap between them can never be merged without adding area, thus the band
+ *	contains all possible merge candidates.
+ *
+ *	How eager rectangles are merged can be configured via the MergePolicy.
+ */
 struct CInvalidRectList
 {
 	using RectList = std::vector<CRect>;
 
+	struct MergePolicy
+	{
+		/** two rectangles are merged if the area of the union is not bigger than the sum of both
+		 *	areas plus this factor of the sum. 0 means no additional area is allowed.
+		 */
+		double areaOverhead {0.};
+		/** maximum number of rectangles in the list. If reached, a new rectangle is merged with
+		 *	the one which results in the least additional area. 0 means unlimited.
+		 */
+		size_t maxRects {0};
+		/** always merge overlapping rectangles, so that no two rectangles in the list overlap.
+		 *	Needed when the list is used as a draw region.
+		 */
+		bool mergeOverlapping {false};
+	};
+
+	CInvalidRectList () = default;
+	explicit CInvalidRectList (const MergePolicy& policy) : policy (policy) {}
+
+	void setMergePolicy (const MergePolicy& p) { policy = p; }
+	const MergePolicy& getMergePolicy () const { return policy; }
+
+	/** add a rectangle
+	 *	@return true if the list was changed
+	 */
 	bool add (const CRect& r);
+	/** join rectangles which share two edges and are not further apart than maxDistance */
+	void joinNearby (CCoord maxDistance);
 
 	RectList::iterator begin () { return list.begin (); }
 	RectList::iterator end () { return list.end (); }
@@ -23,88 +61,200 @@ struct CInvalidRectList
 
 	void erase (RectList::iterator it) { list.erase (it); }
 
-	void clear () { list.clear (); }
+	void clear ()
+	{
+		list.clear ();
+		maxHeight = 0.;
+	}
 	const RectList& data () const { return list; }
 	bool empty () const { return list.empty (); }
+	size_t size () const { return list.size (); }
 
 private:
+	static CCoord area (const CRect& r) { return r.getWidth () * r.getHeight (); }
+	static bool lessTop (const CRect& r, CCoord top) { return r.top < top; }
+
+	bool canMerge (const CRect& r1, const CRect& r2, CRect& joined) const;
+	RectList::iterator insertSorted (const CRect& r);
+	void mergeIntoCheapest (CRect& r);
+	void sortAndUpdateMaxHeight ();
+
 	RectList list;
+	CCoord maxHeight {0.};
+	MergePolicy policy;
 };
 
 //-----------------------------------------------------------------------------
-inline bool CInvalidRectList::add (const CRect& r)
+inline bool CInvalidRectList::canMerge (const CRect& r1, const CRect& r2, CRect& joined) const
+{
+	auto areaSum = area (r1) + area (r2);
+	joined = r1;
+	joined.unite (r2);
+	if (policy.mergeOverlapping && r1.left < r2.right && r2.left < r1.right &&
+		r1.top < r2.bottom && r2.top < r1.bottom)
+		return true;
+	return area (joined) <= areaSum * (1. + policy.areaOverhead);
+}
+
+//-----------------------------------------------------------------------------
+inline CInvalidRectList::RectList::iterator CInvalidRectList::insertSorted (const CRect& r)
 {
-	for (auto it = list.begin (), end = list.end (); it != end; ++it)
+	maxHeight = std::max (maxHeight, r.getHeight ());
+	auto it = std::upper_bound (list.begin (), list.end (), r.top,
+								[] (CCoord top, const CRect& r) { return top < r.top; });
+	return list.insert (it, r);
+}
+
+//-----------------------------------------------------------------------------
+inline void CInvalidRectList::mergeIntoCheapest (CRect& r)
+{
+	auto best = list.end ();
+	auto bestCost = std::numeric_limits<CCoord>::max ();
+	for (auto it = list.begin (); it != list.end (); ++it)
 	{
-		// the same rectangle is already in the list
-		if (*it == r)
-			return false;
-		// the new rectangle is part of one already in the list
-		if (it->rectInside (r))
-			return false;
-		// if the new rectangle contains one of the previous rectangles
-		if (r.rectInside (*it))
-		{
-			list.erase (it);
-			return add (r);
-		}
-		// now check if the combined rect has the same or less area as both rects together
-		auto area1 = r.getWidth () * r.getHeight ();
-		auto area2 = it->getWidth () * it->getHeight ();
-		CRect jr (*it);
-		jr.unite (r);
-		auto joinedArea = jr.getWidth () * jr.getHeight ();
-		if (joinedArea <= (area1 + area2))
+		CRect joined (*it);
+		joined.unite (r);
+		auto cost = area (joined) - area (*it);
+		if (cost < bestCost)
 		{
-			list.erase (it);
-			return add (jr);
+			bestCost = cost;
+			best = it;
 		}
 	}
-	list.emplace_back (r);
-	return true;
+	if (best == list.end ())
+		return;
+	r.unite (*best);
+	list.erase (best);
 }
 
 //-----------------------------------------------------------------------------
-inline void joinNearbyInvalidRects (CInvalidRectList& list, CCoord maxDistance)
+inline bool CInvalidRectList::add (const CRect& rect)
 {
-	for (auto it = list.begin (); it != list.end (); ++it)
+	CRect r (rect);
+	bool restart;
+	do
 	{
-		for (auto it2 = list.begin (); it2 != list.end (); ++it2)
+		restart = false;
+		// a rectangle with a vertical gap of more than maxGap to r cannot be merged with it
+		auto maxGap = policy.areaOverhead * (r.getHeight () + maxHeight);
+		auto it = std::lower_bound (list.begin (), list.end (), r.top - maxHeight - maxGap,
+									lessTop);
+		while (it != list.end () && it->top <= r.bottom + maxGap)
 		{
-			if (it2 == it)
+			if (it->bottom < r.top - maxGap)
+			{
+				++it;
 				continue;
-			if (it->left == it2->left && it->right == it2->right)
+			}
+			// the same rectangle is already in the list
+			if (*it == r)
+				return false;
+			// the new rectangle is part of one already in the list
+			if (it->rectInside (r))
+				return false;
+			// if the new rectangle contains one of the previous rectangles
+			if (r.rectInside (*it))
 			{
-				CCoord distance;
-				if (it->bottom < it2->top)
-					distance = it2->top - it->bottom;
-				else
-					distance = it->top - it2->bottom;
-				if (distance <= maxDistance)
-				{
-					it->unite (*it2);
-					list.erase (it2);
-					joinNearbyInvalidRects (list, maxDistance);
-					return;
-				}
+				it = list.erase (it);
+				continue;
 			}
-			if (it->top == it2->top && it->bottom == it2->bottom)
+			// now check if the combined rect is not too much bigger than both rects together
+			CRect joined;
+			if (canMerge (r, *it, joined))
 			{
-				CCoord distance;
-				if (it->right < it2->left)
-					distance = it2->left - it->right;
-				else
-					distance = it->left - it2->right;
-				if (distance <= maxDistance)
-				{
-					it->unite (*it2);
-					list.erase (it2);
-					joinNearbyInvalidRects (list, maxDistance);
-					return;
-				}
+				list.erase (it);
+				r = joined;
+				restart = true;
+				break;
 			}
+			++it;
 		}
+	} while (restart);
+
+	if (policy.maxRects && list.size () >= policy.maxRects)
+	{
+		mergeIntoCheapest (r);
+		add (r);
+		return true;
 	}
+	insertSorted (r);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+inline void CInvalidRectList::sortAndUpdateMaxHeight ()
+{
+	std::sort (list.begin (), list.end (),
+			   [] (const CRect& r1, const CRect& r2) { return r1.top < r2.top; });
+	maxHeight = 0.;
+	for (const auto& r : list)
+		maxHeight = std::max (maxHeight, r.getHeight ());
+}
+
+//-----------------------------------------------------------------------------
+inline void CInvalidRectList::joinNearby (CCoord maxDistance)
+{
+	if (list.size () < 2)
+		return;
+
+	// the rects are sorted so that rects with the same edges follow each other, ordered by their
+	// position along the other axis. Then a single sweep joins all neighbours.
+	auto joinPass = [&] (auto sortPred, auto sameEdges, auto distance) {
+		std::sort (list.begin (), list.end (), sortPred);
+		bool joined = false;
+		auto out = list.begin ();
+		for (auto it = std::next (list.begin ()); it != list.end (); ++it)
+		{
+			if (sameEdges (*out, *it) && distance (*out, *it) <= maxDistance)
+			{
+				out->unite (*it);
+				joined = true;
+				continue;
+			}
+			++out;
+			if (out != it)
+				*out = *it;
+		}
+		list.erase (std::next (out), list.end ());
+		return joined;
+	};
+
+	bool joined;
+	do
+	{
+		joined = joinPass (
+			[] (const CRect& r1, const CRect& r2) {
+				if (r1.left != r2.left)
+					return r1.left < r2.left;
+				if (r1.right != r2.right)
+					return r1.right < r2.right;
+				return r1.top < r2.top;
+			},
+			[] (const CRect& r1, const CRect& r2) {
+				return r1.left == r2.left && r1.right == r2.right;
+			},
+			[] (const CRect& r1, const CRect& r2) { return r2.top - r1.bottom; });
+		joined |= joinPass (
+			[] (const CRect& r1, const CRect& r2) {
+				if (r1.top != r2.top)
+					return r1.top < r2.top;
+				if (r1.bottom != r2.bottom)
+					return r1.bottom < r2.bottom;
+				return r1.left < r2.left;
+			},
+			[] (const CRect& r1, const CRect& r2) {
+				return r1.top == r2.top && r1.bottom == r2.bottom;
+			},
+			[] (const CRect& r1, const CRect& r2) { return r2.left - r1.right; });
+	} while (joined && list.size () > 1);
+
+	sortAndUpdateMaxHeight ();
+}
+
+//-----------------------------------------------------------------------------
+inline void joinNearbyInvalidRects (CInvalidRectList& list, CCoord maxDistance)
+{
+	list.joinNearby (maxDistance);
 }
 
 //-----------------------------------------------------------------------------
@@ -98,6 +98,7 @@ bool CLayeredViewContainer::attached (CView* parent)
 		{
 			layer->setZIndex (zIndex);
 			layer->setAlpha (getAlphaValue ());
+			layer->onScaleFactorChanged (frame->getScaleFactor ());
 			updateLayerSize ();
 			frame->registerScaleFactorChangedListener (this);
 		}
@@ -185,6 +186,17 @@ void CLayeredViewContainer::setAlphaValue (float alpha)
 		CViewContainer::setAlphaValue (alpha);
 }
 
+//-----------------------------------------------------------------------------
+bool CLayeredViewContainer::isOpaque () const
+{
+	// the content of the layer is not drawn into the context of the parent
+	if (layer)
+		return false;
+	if (CViewContainer::isOpaque ())
+		return true;
+	return isExactType (this) && hasOpaqueBackground ();
+}
+
 //-----------------------------------------------------------------------------
 void CLayeredViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 {
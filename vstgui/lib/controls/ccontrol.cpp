@@ -262,6 +262,9 @@ bool CControl::isDirty () const
 //------------------------------------------------------------------------
 void CControl::setDirty (bool val)
 {
+	// prepareConcurrentDraw already cleared the dirty state of the views drawn on this thread
+	if (isDrawingConcurrently ())
+		return;
 	CView::setDirty (val);
 	if (val)
 	{
@@ -501,6 +501,12 @@ void CKnob::draw (CDrawContext *pContext)
 	setDirty (false);
 }
 
+//------------------------------------------------------------------------
+bool CKnob::isDrawThreadSafe () const
+{
+	return isExactType (this);
+}
+
 //------------------------------------------------------------------------
 void CKnob::addArc (CGraphicsPath* path, const CRect& r, double startAngle, double sweepAngle)
 {
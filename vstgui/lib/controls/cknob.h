@@ -122,6 +122,7 @@ public:
 
 	// overrides
 	void draw (CDrawContext* pContext) override;
+	bool isDrawThreadSafe () const override;
 	bool getFocusPath (CGraphicsPath& outPath) override;
 	bool drawFocusOnTop () override;
 
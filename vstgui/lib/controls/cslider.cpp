@@ -850,6 +850,12 @@ void CSlider::draw (CDrawContext* pContext)
 	setDirty (false);
 }
 
+//------------------------------------------------------------------------
+bool CSlider::isDrawThreadSafe () const
+{
+	return isExactType (this);
+}
+
 //------------------------------------------------------------------------
 void CSlider::setHandle (CBitmap* _pHandle)
 {
@@ -157,6 +157,7 @@ public:
 
 	// overrides
 	void draw (CDrawContext*) override;
+	bool isDrawThreadSafe () const override;
 	bool sizeToFit () override;
 
 	CLASS_METHODS (CSlider, CControl)
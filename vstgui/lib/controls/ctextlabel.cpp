@@ -81,12 +81,26 @@ void CTextLabel::calculateTruncatedText ()
 	if (textRotation != 0.) // currently truncation is only supported when not rotated
 	{
 		truncatedText = "";
+		truncationInput = {};
 		return;
 	}
 	if (!(textTruncateMode == kTruncateNone || text.empty () || fontID == nullptr || fontID->getPlatformFont () == nullptr || fontID->getPlatformFont ()->getPainter () == nullptr))
 	{
-		CDrawMethods::TextTruncateMode mode = textTruncateMode == kTruncateHead ? CDrawMethods::kTextTruncateHead : CDrawMethods::kTextTruncateTail;
-		truncatedText = CDrawMethods::createTruncatedText (mode, text, fontID, getWidth () - getTextInset ().x * 2.);
+		auto width = getWidth () - getTextInset ().x * 2.;
+		if (truncationInput.mode == textTruncateMode && truncationInput.width == width &&
+		    truncationInput.text == text && truncationInput.font && *truncationInput.font == *fontID)
+			return;
+		truncationInput.font = makeOwned<CFontDesc> (*fontID);
+		truncationInput.text = text;
+		truncationInput.width = width;
+		truncationInput.mode = textTruncateMode;
+
+		CDrawMethods::TextTruncateMode mode = CDrawMethods::kTextTruncateTail;
+		if (textTruncateMode == kTruncateHead)
+			mode = CDrawMethods::kTextTruncateHead;
+		else if (textTruncateMode == kTruncateMiddle)
+			mode = CDrawMethods::kTextTruncateMiddle;
+		truncatedText = CDrawMethods::createTruncatedText (mode, text, fontID, width);
 		if (truncatedText == text)
 			truncatedText.clear ();
 		if (listeners)
@@ -95,8 +109,12 @@ void CTextLabel::calculateTruncatedText ()
 			    [this] (ITextLabelListener* l) { l->onTextLabelTruncatedTextChanged (this); });
 		}
 	}
-	else if (!truncatedText.empty ())
-		truncatedText.clear ();
+	else
+	{
+		if (!truncatedText.empty ())
+			truncatedText.clear ();
+		truncationInput = {};
+	}
 }
 
 //------------------------------------------------------------------------
@@ -113,6 +131,27 @@ void CTextLabel::draw (CDrawContext *pContext)
 	setDirty (false);
 }
 
+//------------------------------------------------------------------------
+bool CTextLabel::isDrawThreadSafe () const
+{
+	return isExactType (this);
+}
+
+//------------------------------------------------------------------------
+bool CTextLabel::prepareConcurrentDraw (CDrawContext* pContext, const CRect& updateRect)
+{
+	if (!CParamDisplay::prepareConcurrentDraw (pContext, updateRect))
+		return false;
+	// the platform font and string are created lazily
+	if (auto font = getFont ())
+		font->getPlatformFont ();
+	if (truncatedText.empty ())
+		text.getPlatformString ();
+	else
+		truncatedText.getPlatformString ();
+	return true;
+}
+
 //------------------------------------------------------------------------
 bool CTextLabel::sizeToFit ()
 {
@@ -199,6 +238,8 @@ void CMultiLineTextLabel::setLineLayout (LineLayout layout)
 		return;
 	lineLayout = layout;
 	lines.clear ();
+	for (auto& paragraph : paragraphs)
+		paragraph.lines.clear ();
 }
 
 //------------------------------------------------------------------------
@@ -363,109 +404,222 @@ inline bool isLineBreakSeparator (char32_t c)
 }
 
 //------------------------------------------------------------------------
-void CMultiLineTextLabel::calculateWrapLine  (CDrawContext* context,
-                                       std::pair<UTF8String, double>& element,
-                                       const IFontPainter* const& fontPainter, double lineHeight,
-                                       double lineWidth, double maxWidth, const CPoint& textInset,
-                                       CCoord& y)
+inline bool isLineBreakSpace (char32_t c)
+{
+	return c < 0x80 && isspace (static_cast<int> (c));
+}
+
+//------------------------------------------------------------------------
+inline CCoord getSubStringWidth (CDrawContext* context, const IFontPainter* fontPainter,
+                                 const UTF8String& text, size_t begin, size_t end)
+{
+	UTF8String str (text.getString ().substr (begin, end - begin));
+	return fontPainter->getStringWidth (context, str.getPlatformString ());
+}
+
+//------------------------------------------------------------------------
+void CMultiLineTextLabel::updateParagraphs (CDrawContext* context,
+                                            const IFontPainter* fontPainter)
 {
-	auto start = element.first.begin ();
-	auto lastSeparator = start;
-	auto pos = start;
-	while (pos != element.first.end () && *pos != 0)
+	if (!paragraphsFont || *paragraphsFont != *getFont ())
 	{
-		if (isspace (*pos))
-			lastSeparator = pos;
-		else if (isLineBreakSeparator (*pos))
-			lastSeparator = ++pos;
-		if (pos == element.first.end ())
-			break;
-		auto tmpEnd = pos;
-		UTF8String tmp ({start.base (), (++tmpEnd).base ()});
-		auto width = fontPainter->getStringWidth (context, tmp.getPlatformString ());
-		if (width > maxWidth)
+		paragraphs.clear ();
+		paragraphsFont = makeOwned<CFontDesc> (*getFont ());
+	}
+
+	std::vector<std::string> texts;
+	std::stringstream stream (getText ().getString ());
+	std::string line;
+	while (std::getline (stream, line, '\n'))
+		texts.emplace_back (std::move (line));
+
+	// keep the paragraphs before the first and after the last changed one
+	size_t numEqualHead = 0;
+	while (numEqualHead < texts.size () && numEqualHead < paragraphs.size () &&
+	       paragraphs[numEqualHead].text == texts[numEqualHead])
+		++numEqualHead;
+	size_t numEqualTail = 0;
+	while (numEqualTail < texts.size () - numEqualHead &&
+	       numEqualTail < paragraphs.size () - numEqualHead &&
+	       paragraphs[paragraphs.size () - numEqualTail - 1].text ==
+	           texts[texts.size () - numEqualTail - 1])
+		++numEqualTail;
+	if (numEqualHead != texts.size () || texts.size () != paragraphs.size ())
+	{
+		Paragraphs newParagraphs (texts.size ());
+		for (size_t i = 0; i < numEqualHead; ++i)
+			newParagraphs[i] = std::move (paragraphs[i]);
+		for (size_t i = numEqualHead; i < texts.size () - numEqualTail; ++i)
+			newParagraphs[i].text = std::move (texts[i]);
+		for (size_t i = 0; i < numEqualTail; ++i)
+			newParagraphs[texts.size () - i - 1] = std::move (paragraphs[paragraphs.size () - i - 1]);
+		paragraphs = std::move (newParagraphs);
+	}
+
+	for (auto& paragraph : paragraphs)
+	{
+		if (paragraph.width < 0.)
+			paragraph.width =
+			    fontPainter->getStringWidth (context, paragraph.text.getPlatformString ());
+	}
+}
+
+//------------------------------------------------------------------------
+const std::vector<UTF8String>& CMultiLineTextLabel::getParagraphLines (
+    Paragraph& paragraph, CDrawContext* context, const IFontPainter* fontPainter, CCoord maxWidth)
+{
+	if (paragraph.linesMaxWidth == maxWidth && !paragraph.lines.empty ())
+		return paragraph.lines;
+	paragraph.lines.clear ();
+	paragraph.linesMaxWidth = maxWidth;
+	if (paragraph.width <= maxWidth || lineLayout == LineLayout::clip)
+		paragraph.lines.emplace_back (paragraph.text);
+	else if (lineLayout == LineLayout::truncate)
+		paragraph.lines.emplace_back (CDrawMethods::createTruncatedText (
+		    CDrawMethods::kTextTruncateTail, paragraph.text, fontID, maxWidth));
+	else
+		wrapParagraph (paragraph, context, fontPainter, maxWidth);
+	return paragraph.lines;
+}
+
+//------------------------------------------------------------------------
+void CMultiLineTextLabel::wrapParagraph (Paragraph& paragraph, CDrawContext* context,
+                                         const IFontPainter* fontPainter, CCoord maxWidth)
+{
+	const auto& text = paragraph.text;
+	auto& segments = paragraph.segments;
+	if (segments.empty ())
+	{
+		// the text is broken before white space and after separator characters
+		auto textBegin = text.getString ().begin ();
+		auto breakAfter = false;
+		for (auto it = text.begin (); it != text.end (); ++it)
 		{
-			if (lastSeparator == element.first.end ())
-				lastSeparator = pos;
-			if (start == lastSeparator)
-				lastSeparator = pos;
-			lines.emplace_back (
-			    Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
-			          UTF8String ({start.base (), lastSeparator.base ()})});
-			y += lineHeight;
-			pos = lastSeparator;
-			start = pos;
-			if (isspace (*start))
-				++start;
-			lastSeparator = element.first.end ();
+			auto begin = static_cast<size_t> (it.base () - textBegin);
+			auto isSpace = isLineBreakSpace (*it);
+			if (segments.empty () || segments.back ().isSpace != isSpace || breakAfter)
+				segments.push_back ({begin, begin, 0., isSpace});
+			segments.back ().end = static_cast<size_t> (std::next (it).base () - textBegin);
+			breakAfter = !isSpace && isLineBreakSeparator (*it);
 		}
-		++pos;
+		for (auto& segment : segments)
+			segment.width =
+			    getSubStringWidth (context, fontPainter, text, segment.begin, segment.end);
 	}
-	if (start != element.first.end ())
+
+	size_t index = 0;
+	size_t pos = 0;
+	while (index < segments.size ())
 	{
-		lines.emplace_back (Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
-		                          UTF8String ({start.base (), element.first.end ().base ()})});
-		y += lineHeight;
+		if (!paragraph.lines.empty () && pos == segments[index].begin)
+		{
+			while (index < segments.size () && segments[index].isSpace)
+				++index;
+			if (index == segments.size ())
+				break;
+			pos = segments[index].begin;
+		}
+		auto lineBegin = pos;
+		auto lineEnd = pos;
+		CCoord lineWidth = 0.;
+		while (index < segments.size ())
+		{
+			const auto& segment = segments[index];
+			auto width = pos == segment.begin
+			                 ? segment.width
+			                 : getSubStringWidth (context, fontPainter, text, pos, segment.end);
+			if (lineWidth + width > maxWidth)
+				break;
+			lineWidth += width;
+			pos = segment.end;
+			if (!segment.isSpace)
+				lineEnd = pos;
+			++index;
+		}
+		if (pos == lineBegin)
+		{
+			// a word wider than the line is broken at the last fitting character
+			const auto& segment = segments[index];
+			auto textBegin = text.getString ().begin ();
+			std::vector<size_t> positions;
+			for (auto it = UTF8String::CodePointIterator (textBegin + pos);
+			     it.base () != textBegin + segment.end; ++it)
+				positions.emplace_back (static_cast<size_t> (std::next (it).base () - textBegin));
+			// at least one character is put on the line
+			size_t fitting = 0;
+			size_t tooWide = positions.size ();
+			while (tooWide - fitting > 1)
+			{
+				auto middle = fitting + (tooWide - fitting) / 2;
+				if (getSubStringWidth (context, fontPainter, text, pos, positions[middle]) <=
+				    maxWidth)
+					fitting = middle;
+				else
+					tooWide = middle;
+			}
+			pos = lineEnd = positions[fitting];
+			if (pos == segment.end)
+				++index;
+		}
+		paragraph.lines.emplace_back (text.getString ().substr (lineBegin, lineEnd - lineBegin));
 	}
 }
 
 //------------------------------------------------------------------------
-void CMultiLineTextLabel::recalculateLines (CDrawContext* context)
+void CMultiLineTextLabel::layoutLines (CDrawContext* context, CCoord width, Lines& result)
 {
 	const auto& font = getFont ()->getPlatformFont ();
 	const auto& fontPainter = getFont ()->getFontPainter ();
+	if (!font || !fontPainter)
+		return;
+	updateParagraphs (context, fontPainter);
+
 	auto ascent = font->getAscent ();
 	auto descent = font->getDescent ();
 	auto leading = font->getLeading ();
 	auto lineHeight = ascent + descent + leading;
 
 	const auto& textInset = getTextInset ();
-	auto maxWidth = getWidth () - (textInset.x * 2);
-
-	std::vector<std::pair<UTF8String, CCoord>> elements;
-	std::stringstream stream (getText ().getString ());
-	std::string line;
-	while (std::getline (stream, line, '\n'))
-	{
-		UTF8String str (std::move (line));
-		auto width = fontPainter->getStringWidth (context, str.getPlatformString ());
-		elements.emplace_back (std::move (str), width);
-	}
+	auto maxWidth = width - (textInset.x * 2);
+	auto lineWidth = width - textInset.x;
 
 	CCoord y = textInset.y;
-
-	auto lineWidth = getWidth () - textInset.x;
-	
-	for (auto& element : elements)
+	for (auto& paragraph : paragraphs)
 	{
 		if (lineLayout == LineLayout::clip)
 		{
-			lines.emplace_back (Line {
-			    CRect (textInset.x, y, element.second + textInset.x, y + lineHeight + textInset.y),
-			    std::move (element.first)});
+			result.emplace_back (Line {CRect (textInset.x, y, paragraph.width + textInset.x,
+			                                  y + lineHeight + textInset.y),
+			                           paragraph.text});
+			y += lineHeight;
+			continue;
 		}
-		else
+		for (const auto& str : getParagraphLines (paragraph, context, fontPainter, maxWidth))
 		{
-			if (element.second > maxWidth)
-			{
-				if (lineLayout == LineLayout::truncate)
-				{
-					element.first = CDrawMethods::createTruncatedText (
-					    CDrawMethods::kTextTruncateTail, element.first, fontID, maxWidth);
-				}
-				else // wrap
-				{
-					calculateWrapLine (context, element, fontPainter, lineHeight, lineWidth,
-					                   maxWidth, textInset, y);
-					continue;
-				}
-			}
-			lines.emplace_back (
-			    Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y),
-			          std::move (element.first)});
+			result.emplace_back (
+			    Line {CRect (textInset.x, y, lineWidth, y + lineHeight + textInset.y), str});
+			y += lineHeight;
 		}
-		y += lineHeight;
 	}
+}
+
+//------------------------------------------------------------------------
+CCoord CMultiLineTextLabel::calculateContentHeight (CCoord width)
+{
+	Lines measuredLines;
+	layoutLines (nullptr, width, measuredLines);
+	if (measuredLines.empty ())
+		return 0.;
+	return measuredLines.back ().r.bottom + getTextInset ().y;
+}
+
+//------------------------------------------------------------------------
+void CMultiLineTextLabel::recalculateLines (CDrawContext* context)
+{
+	lines.clear ();
+	layoutLines (context, getWidth (), lines);
+
+	const auto& textInset = getTextInset ();
 	if (getVerticalCentered () && !lines.empty ())
 	{
 		auto maxHeight = lines.back ().r.bottom;
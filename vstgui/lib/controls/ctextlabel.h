@@ -37,7 +37,9 @@ public:
 		/** characters will be removed from the beginning of the text */
 		kTruncateHead,
 		/** characters will be removed from the end of the text */
-		kTruncateTail
+		kTruncateTail,
+		/** characters will be removed from the middle of the text */
+		kTruncateMiddle
 	};
 	
 	/** set text truncate mode */
@@ -54,6 +56,8 @@ public:
 	//@}
 
 	void draw (CDrawContext* pContext) override;
+	bool isDrawThreadSafe () const override;
+	bool prepareConcurrentDraw (CDrawContext* pContext, const CRect& updateRect) override;
 	bool sizeToFit () override;
 	void setViewSize (const CRect& rect, bool invalid = true) override;
 	void drawStyleChanged () override;
@@ -72,6 +76,16 @@ protected:
 	TextTruncateMode textTruncateMode;
 	UTF8String text;
 	UTF8String truncatedText;
+
+	/** what the truncated text was calculated for, it is only calculated again if one changes */
+	struct TruncationInput
+	{
+		SharedPointer<CFontDesc> font;
+		UTF8String text;
+		CCoord width {-1.};
+		TextTruncateMode mode {kTruncateNone};
+	};
+	TruncationInput truncationInput;
 	using TextLabelListenerList = DispatchList<ITextLabelListener*>;
 	std::unique_ptr<TextLabelListenerList> listeners;
 };
@@ -114,6 +128,15 @@ public:
 	/** return the maximum line width of all lines */
 	CCoord getMaxLineWidth ();
 
+	/** calculate the height the view would need to show all lines at a width
+	 *
+	 *	The view is neither resized nor drawn, so this can be used to size a scroll view container.
+	 *	The measured words and lines are cached and reused when the view is laid out at this width.
+	 *	@param width the width of the view
+	 *	@return the height of the lines including the text inset
+	 */
+	CCoord calculateContentHeight (CCoord width);
+
 	void drawRect (CDrawContext* pContext, const CRect& updateRect) override;
 	bool sizeToFit () override;
 	void setText (const UTF8String& txt) override;
@@ -122,14 +145,6 @@ public:
 	void setValue (float val) override;
 private:
 	void drawStyleChanged () override;
-	void calculateWrapLine  (CDrawContext *context, std::pair<UTF8String, double> &element, const IFontPainter *const &fontPainter, double lineHeight, double lineWidth, double maxWidth, const CPoint &textInset, CCoord &y);
-	
-	void recalculateLines (CDrawContext* context);
-	void recalculateHeight ();
-	
-	bool autoHeight {false};
-	bool verticalCentered {false};
-	LineLayout lineLayout {LineLayout::clip};
 
 	struct Line
 	{
@@ -137,7 +152,48 @@ private:
 		UTF8String str;
 	};
 	using Lines = std::vector<Line>;
+
+	/** a line of the text separated by a line feed */
+	struct Paragraph
+	{
+		/** a word or a run of white space */
+		struct Segment
+		{
+			size_t begin;
+			size_t end;
+			CCoord width;
+			bool isSpace;
+		};
+
+		UTF8String text;
+		CCoord width {-1.};
+		std::vector<Segment> segments;
+		/** the lines of the last layout and the maximum width they were calculated for */
+		std::vector<UTF8String> lines;
+		CCoord linesMaxWidth {-1.};
+	};
+	using Paragraphs = std::vector<Paragraph>;
+
+	void updateParagraphs (CDrawContext* context, const IFontPainter* fontPainter);
+	const std::vector<UTF8String>& getParagraphLines (Paragraph& paragraph, CDrawContext* context,
+	                                                  const IFontPainter* fontPainter,
+	                                                  CCoord maxWidth);
+	void wrapParagraph (Paragraph& paragraph, CDrawContext* context,
+	                    const IFontPainter* fontPainter, CCoord maxWidth);
+	void layoutLines (CDrawContext* context, CCoord width, Lines& result);
+
+	void recalculateLines (CDrawContext* context);
+	void recalculateHeight ();
+	
+	bool autoHeight {false};
+	bool verticalCentered {false};
+	LineLayout lineLayout {LineLayout::clip};
+
 	Lines lines;
+	/** the paragraphs are kept until the text or the font changes, unchanged paragraphs are not
+	 *	measured again */
+	Paragraphs paragraphs;
+	SharedPointer<CFontDesc> paragraphsFont;
 };
 
 } // VSTGUI
@@ -194,7 +194,7 @@ void CRowColumnView::layoutViews ()
 //--------------------------------------------------------------------------------
 bool CRowColumnView::sizeToFit ()
 {
-	if (!getChildren ().empty ())
+	if (!getChildViews ().empty ())
 	{
 		CRect viewSize = getViewSize ();
 		CPoint maxSize;
@@ -230,6 +230,20 @@ bool CRowColumnView::sizeToFit ()
 	return false;
 }
 
+//--------------------------------------------------------------------------------
+bool CRowColumnView::honorsDrawRegion () const
+{
+	return isExactType (this);
+}
+
+//--------------------------------------------------------------------------------
+bool CRowColumnView::isOpaque () const
+{
+	if (CAutoLayoutContainerView::isOpaque ())
+		return true;
+	return isExactType (this) && hasOpaqueBackground ();
+}
+
 //--------------------------------------------------------------------------------
 CMessageResult CRowColumnView::notify (CBaseObject* sender, IdStringPtr message)
 {
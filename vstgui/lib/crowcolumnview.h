@@ -83,6 +83,8 @@ public:
 	void layoutViews () override;
 	bool sizeToFit () override;
 	CMessageResult notify (CBaseObject* sender, IdStringPtr message) override;
+	bool honorsDrawRegion () const override;
+	bool isOpaque () const override;
 
 	CLASS_METHODS(CRowColumnView, CAutoLayoutContainerView)
 protected:
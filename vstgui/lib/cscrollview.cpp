@@ -32,6 +32,12 @@ public:
 	void setContainerSize (const CRect& cs);
 
 	bool isDirty () const override;
+	// draws nothing besides the background and the children
+	bool honorsDrawRegion () const override { return true; }
+	bool isOpaque () const override
+	{
+		return CViewContainer::isOpaque () || hasOpaqueBackground ();
+	}
 
 	void setAutoDragScroll (bool state) { autoDragScroll = state; }
 
@@ -137,7 +143,7 @@ void CScrollContainer::setScrollOffset (CPoint newOffset, bool redraw)
 		return;
 	offset = newOffset;
 	inScrolling = true;
-	for (const auto& pV : getChildren ())
+	for (const auto& pV : getChildViews ())
 	{
 		CRect r = pV->getViewSize ();
 		CRect mr = pV->getMouseableArea ();
@@ -183,7 +189,7 @@ bool CScrollContainer::isDirty () const
 	if (CView::isDirty ())
 		return true;
 
-	for (const auto& pV : getChildren ())
+	for (const auto& pV : getChildViews ())
 	{
 		if (pV->isDirty () && pV->isVisible ())
 		{
@@ -8,7 +8,8 @@
 #include "cframe.h"
 #include "cbitmap.h"
 #include <cassert>
-#include <array>
+#include <cmath>
+#include <cstring>
 
 namespace VSTGUI {
 
@@ -32,6 +33,7 @@ CShadowViewContainer::CShadowViewContainer (const CShadowViewContainer& copy)
 , scaleFactorUsed (0.)
 {
 	registerViewContainerListener (this);
+	forEachChild ([this] (CView* view) { view->registerViewListener (this); });
 }
 
 //------------------------------------------------------------------------
@@ -41,6 +43,7 @@ CShadowViewContainer::~CShadowViewContainer () noexcept = default;
 void CShadowViewContainer::beforeDelete ()
 {
 	unregisterViewContainerListener (this);
+	forEachChild ([this] (CView* view) { view->unregisterViewListener (this); });
 	CViewContainer::beforeDelete ();
 }
 
@@ -104,32 +107,43 @@ void CShadowViewContainer::setShadowBlurSize (double size)
 void CShadowViewContainer::invalidateShadow ()
 {
 	scaleFactorUsed = 0.;
+	shadowDirtyRect = CRect ();
 	invalid ();
 }
 
 //-----------------------------------------------------------------------------
-CMessageResult CShadowViewContainer::notify (CBaseObject* sender, IdStringPtr message)
+/** the distance in points over which the blur spreads a pixel of the shadow
+ *
+ *	The gaussian blur filter uses three box blurs which are at most two pixels wider than the ideal
+ *	box width sqrt (4 * sigma * sigma + 1).
+ */
+static CCoord getShadowBlurExtent (double blurSize)
 {
-	if (message == kMsgViewSizeChanged)
-		invalidateShadow ();
-	return CViewContainer::notify(sender, message);
+	return std::ceil (1.5 * (std::sqrt (4. * blurSize * blurSize + 1.) + 2.));
 }
 
 //-----------------------------------------------------------------------------
-template <size_t numBoxes>
-static std::array<int32_t, numBoxes> boxesForGauss (double sigma)
+void CShadowViewContainer::invalidRect (const CRect& rect)
 {
-	std::array<int32_t, numBoxes> boxes;
-	double ideal = std::sqrt ((12 * sigma * sigma / numBoxes) + 1);
-	uint16_t l = static_cast<uint16_t> (std::floor (ideal));
-	if (l % 2 == 0)
-		l--;
-	int32_t u = l + 2;
-	ideal = ((12. * sigma * sigma) - (numBoxes * l * l) - (4. * numBoxes * l) - (3. * numBoxes)) / ((-4. * l) - 4.);
-	int32_t m = static_cast<int32_t> (std::floor (ideal));
-	for (int32_t i = 0; i < numBoxes; ++i)
-		boxes[i] = (i < m ? l : u);
-	return boxes;
+	CViewContainer::invalidRect (rect);
+	// the children are invalidated while the shadow is rendered, too
+	if (dontDrawBackground || scaleFactorUsed == 0. || !isVisible ())
+		return;
+	CRect shadowRect (rect);
+	getTransform ().transform (shadowRect);
+	shadowRect.offset (-shadowOffset.x, -shadowOffset.y);
+	auto extent = getShadowBlurExtent (shadowBlurSize);
+	shadowRect.extend (extent, extent);
+	shadowRect.bound (CRect (0, 0, getWidth (), getHeight ()));
+	if (shadowRect.isEmpty ())
+		return;
+	if (shadowDirtyRect.isEmpty ())
+		shadowDirtyRect = shadowRect;
+	else
+		shadowDirtyRect.unite (shadowRect);
+	shadowRect.offset (getViewSize ().left, getViewSize ().top);
+	if (auto parent = getParentView ())
+		parent->invalidRect (shadowRect);
 }
 
 //-----------------------------------------------------------------------------
@@ -138,6 +152,94 @@ static bool isUniformScaled (const CGraphicsTransform& matrix)
 	return matrix.m11 == matrix.m22;
 }
 
+//-----------------------------------------------------------------------------
+SharedPointer<CBitmap> CShadowViewContainer::renderShadow (const CRect& rect, double scaleFactor)
+{
+	auto offscreenContext = COffscreenContext::create (rect.getSize (), scaleFactor);
+	if (!offscreenContext)
+		return nullptr;
+	offscreenContext->beginDraw ();
+	{
+		CDrawContext::Transform transform (*offscreenContext, CGraphicsTransform ().translate (-getViewSize ().left - shadowOffset.x - rect.left, -getViewSize ().top - shadowOffset.y - rect.top));
+		CRect updateRect (rect);
+		updateRect.offset (getViewSize ().left + shadowOffset.x, getViewSize ().top + shadowOffset.y);
+		dontDrawBackground = true;
+		CViewContainer::drawRect (offscreenContext, updateRect);
+		dontDrawBackground = false;
+	}
+	offscreenContext->endDraw ();
+	SharedPointer<CBitmap> bitmap = offscreenContext->getBitmap ();
+	if (!bitmap)
+		return nullptr;
+	SharedPointer<BitmapFilter::IFilter> setColorFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kSetColor));
+	if (setColorFilter)
+	{
+		setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap.get ());
+		setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputColor, kBlackCColor);
+		setColorFilter->setProperty (BitmapFilter::Standard::Property::kIgnoreAlphaColorValue, (int32_t)1);
+		if (setColorFilter->run (true))
+		{
+			SharedPointer<BitmapFilter::IFilter> blurFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kGaussianBlur));
+			if (blurFilter)
+			{
+				blurFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap.get ());
+				blurFilter->setProperty (BitmapFilter::Standard::Property::kStandardDeviation, shadowBlurSize);
+				blurFilter->setProperty (BitmapFilter::Standard::Property::kAlphaChannelOnly, 1);
+				blurFilter->run (true);
+			}
+		}
+	}
+	return bitmap;
+}
+
+//-----------------------------------------------------------------------------
+static CRect toPixelRect (const CRect& rect, double scaleFactor, const CPoint& pixelSize)
+{
+	CRect pixelRect (rect.left * scaleFactor, rect.top * scaleFactor, rect.right * scaleFactor, rect.bottom * scaleFactor);
+	pixelRect.makeIntegral ();
+	pixelRect.bound (CRect (0, 0, pixelSize.x, pixelSize.y));
+	return pixelRect;
+}
+
+//-----------------------------------------------------------------------------
+bool CShadowViewContainer::updateShadow (double scaleFactor)
+{
+	auto bitmap = getBackground ();
+	if (!bitmap || !bitmap->getPlatformBitmap ())
+		return false;
+	const auto& pixelSize = bitmap->getPlatformBitmap ()->getSize ();
+	auto updatePixels = toPixelRect (shadowDirtyRect, scaleFactor, pixelSize);
+	shadowDirtyRect = CRect ();
+	if (updatePixels.isEmpty ())
+		return true;
+	// the pixels in the updated part only depend on the pixels within the blur extent around it
+	CRect renderPixels (updatePixels);
+	auto extent = std::ceil (getShadowBlurExtent (shadowBlurSize) * scaleFactor);
+	renderPixels.extend (extent, extent);
+	renderPixels.bound (CRect (0, 0, pixelSize.x, pixelSize.y));
+	CRect renderRect (renderPixels.left / scaleFactor, renderPixels.top / scaleFactor, renderPixels.right / scaleFactor, renderPixels.bottom / scaleFactor);
+	auto shadow = renderShadow (renderRect, scaleFactor);
+	if (!shadow || !shadow->getPlatformBitmap () || shadow->getPlatformBitmap ()->getSize () != renderPixels.getSize ())
+		return false;
+	auto source = shadow->getPlatformBitmap ()->lockPixels (true);
+	auto dest = bitmap->getPlatformBitmap ()->lockPixels (true);
+	if (!source || !dest || source->getPixelFormat () != dest->getPixelFormat ())
+		return false;
+	auto left = static_cast<uint32_t> (updatePixels.left);
+	auto top = static_cast<uint32_t> (updatePixels.top);
+	auto width = static_cast<uint32_t> (updatePixels.getWidth ());
+	auto height = static_cast<uint32_t> (updatePixels.getHeight ());
+	auto sourceLeft = left - static_cast<uint32_t> (renderPixels.left);
+	auto sourceTop = top - static_cast<uint32_t> (renderPixels.top);
+	for (auto y = 0u; y < height; ++y)
+	{
+		auto sourceRow = source->getAddress () + (sourceTop + y) * source->getBytesPerRow () + sourceLeft * 4;
+		auto destRow = dest->getAddress () + (top + y) * dest->getBytesPerRow () + left * 4;
+		memcpy (destRow, sourceRow, width * 4);
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void CShadowViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 {
@@ -149,58 +251,19 @@ void CShadowViewContainer::drawRect (CDrawContext* pContext, const CRect& update
 		if (matrixScale != 0.)
 			scaleFactor *= matrixScale;
 	}
-	if (scaleFactor != scaleFactorUsed && getWidth () > 0. && getHeight () > 0.)
+	if (scaleFactor == scaleFactorUsed && !shadowDirtyRect.isEmpty ())
 	{
-		scaleFactorUsed = scaleFactor;
-		CCoord width = getWidth ();
-		CCoord height = getHeight ();
-		
-		if (auto offscreenContext = COffscreenContext::create ({width, height}, scaleFactor))
-		{
-			offscreenContext->beginDraw ();
-			CDrawContext::Transform transform (*offscreenContext, CGraphicsTransform ().translate (-getViewSize ().left - shadowOffset.x, -getViewSize ().top - shadowOffset.y));
-			dontDrawBackground = true;
-			CViewContainer::draw (offscreenContext);
-			dontDrawBackground = false;
-			offscreenContext->endDraw ();
-			CBitmap* bitmap = offscreenContext->getBitmap ();
-			if (bitmap)
-			{
-				setBackground (bitmap);
-				SharedPointer<BitmapFilter::IFilter> setColorFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kSetColor));
-				if (setColorFilter)
-				{
-					setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
-					setColorFilter->setProperty (BitmapFilter::Standard::Property::kInputColor, kBlackCColor);
-					setColorFilter->setProperty (BitmapFilter::Standard::Property::kIgnoreAlphaColorValue, (int32_t)1);
-					if (setColorFilter->run (true))
-					{
-						SharedPointer<BitmapFilter::IFilter> boxBlurFilter = owned (BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kBoxBlur));
-						if (boxBlurFilter)
-						{
-							auto boxSizes = boxesForGauss<3> (shadowBlurSize);
-							boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
-							boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[0]);
-							boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kAlphaChannelOnly, 1);
-							if (boxBlurFilter->run (true))
-							{
-								boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[1]);
-								boxBlurFilter->run (true);
-								boxBlurFilter->setProperty (BitmapFilter::Standard::Property::kRadius, boxSizes[2]);
-								boxBlurFilter->run (true);
-							}
-						}
-					}
-				}
-
-				CViewContainer::drawRect (pContext, updateRect);
-			}
-		}
+		if (!updateShadow (scaleFactor))
+			scaleFactorUsed = 0.;
 	}
-	else
+	if (scaleFactor != scaleFactorUsed && getWidth () > 0. && getHeight () > 0.)
 	{
-		CViewContainer::drawRect (pContext, updateRect);
+		scaleFactorUsed = scaleFactor;
+		shadowDirtyRect = CRect ();
+		if (auto bitmap = renderShadow (CRect (0, 0, getWidth (), getHeight ()), scaleFactor))
+			setBackground (bitmap);
 	}
+	CViewContainer::drawRect (pContext, updateRect);
 }
 
 //-----------------------------------------------------------------------------
@@ -231,21 +294,30 @@ void CShadowViewContainer::setViewSize (const CRect& rect, bool invalid)
 void CShadowViewContainer::viewContainerViewAdded (CViewContainer* container, CView* view)
 {
 	vstgui_assert (container == this);
-	invalidateShadow ();
+	view->registerViewListener (this);
+	invalidRect (view->getViewSize ());
 }
 
 //-----------------------------------------------------------------------------
 void CShadowViewContainer::viewContainerViewRemoved (CViewContainer* container, CView* view)
 {
 	vstgui_assert (container == this);
-	invalidateShadow ();
+	view->unregisterViewListener (this);
+	invalidRect (view->getViewSize ());
 }
 
 //-----------------------------------------------------------------------------
 void CShadowViewContainer::viewContainerViewZOrderChanged (CViewContainer* container, CView* view)
 {
 	vstgui_assert (container == this);
-	invalidateShadow ();
+	invalidRect (view->getViewSize ());
+}
+
+//-----------------------------------------------------------------------------
+void CShadowViewContainer::viewSizeChanged (CView* view, const CRect& oldSize)
+{
+	invalidRect (oldSize);
+	invalidRect (view->getViewSize ());
 }
 
 } // VSTGUI
@@ -18,7 +18,8 @@ namespace VSTGUI {
 //-----------------------------------------------------------------------------
 class CShadowViewContainer : public CViewContainer,
                              public IScaleFactorChangedListener,
-                             public ViewContainerListenerAdapter
+                             public ViewContainerListenerAdapter,
+                             public ViewListenerAdapter
 {
 public:
 	explicit CShadowViewContainer (const CRect& size);
@@ -46,8 +47,8 @@ public:
 	bool attached (CView* parent) override;
 	void drawRect (CDrawContext* pContext, const CRect& updateRect) override;
 	void drawBackgroundRect (CDrawContext* pContext, const CRect& _updateRect) override;
+	void invalidRect (const CRect& rect) override;
 	void setViewSize (const CRect& rect, bool invalid = true) override;
-	CMessageResult notify (CBaseObject* sender, IdStringPtr message) override;
 
 	void onScaleFactorChanged (CFrame* frame, double newScaleFactor) override;
 
@@ -56,14 +57,22 @@ protected:
 	void viewContainerViewAdded (CViewContainer* container, CView* view) override;
 	void viewContainerViewRemoved (CViewContainer* container, CView* view) override;
 	void viewContainerViewZOrderChanged (CViewContainer* container, CView* view) override;
+	void viewSizeChanged (CView* view, const CRect& oldSize) override;
 
 	void beforeDelete () override;
 
+	/** render the shadow of the part rect of the container at the scale factor */
+	SharedPointer<CBitmap> renderShadow (const CRect& rect, double scaleFactor);
+	/** update only the dirty part of the shadow bitmap, returns false if it must be rebuilt */
+	bool updateShadow (double scaleFactor);
+
 	bool dontDrawBackground;
 	CPoint shadowOffset;
 	float shadowIntensity;
 	double shadowBlurSize;
 	double scaleFactorUsed;
+	/** the part of the shadow which needs to be updated */
+	CRect shadowDirtyRect;
 };
 
 } // VSTGUI
@@ -69,6 +69,8 @@ public:
 	//@}
 
 	void drawBackgroundRect (CDrawContext *pContext, const CRect& _updateRect) override;
+	/** the background is not drawn behind the tab buttons */
+	bool isOpaque () const override { return CView::isOpaque (); }
 	void valueChanged (CControl *pControl) override;
 	void setViewSize (const CRect &rect, bool invalid = true) override;
 	void setAutosizeFlags (int32_t flags) override;
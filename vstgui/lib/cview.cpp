@@ -193,6 +193,13 @@ struct CView::Impl
 	int32_t autosizeFlags {kAutosizeNone};
 	CFrame* parentFrame {nullptr};
 	CView* parentView {nullptr};
+
+	/** tell the parent container that the size, mouseable area or visibility of view changed */
+	void childViewChanged (CView* view)
+	{
+		if (auto container = parentView ? parentView->asViewContainer () : nullptr)
+			container->onChildViewChanged (view);
+	}
 };
 
 //-----------------------------------------------------------------------------
@@ -285,6 +292,7 @@ void CView::setMouseableArea (const CRect& rect)
 		setViewFlag (kHasMouseableArea, true);
 		setAttribute (kCViewMouseableAreaAttrID, rect);
 	}
+	pImpl->childViewChanged (this);
 }
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
@@ -383,6 +391,16 @@ void CView::setTransparency (bool state)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void CView::setOpaque (bool state)
+{
+	if (hasViewFlag (kOpaque) != state)
+	{
+		setViewFlag (kOpaque, state);
+		setDirty (true);
+	}
+}
+
 //-----------------------------------------------------------------------------
 void CView::setWantsFocus (bool state)
 {
@@ -402,6 +420,9 @@ void CView::setWantsIdle (bool state)
 //-----------------------------------------------------------------------------
 void CView::setDirty (bool state)
 {
+	// prepareConcurrentDraw already cleared the flag of the views drawn on this thread
+	if (isDrawingConcurrently ())
+		return;
 	if (kDirtyCallAlwaysOnMainThread && isAttached ())
 	{
 		if (state)
@@ -419,6 +440,42 @@ void CView::setDirty (bool state)
 	}
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * @param pContext the context which draws the area on the main thread
+ * @param updateRect the area which will be drawn
+ * @return true if the view can be drawn on a worker thread
+ */
+bool CView::prepareConcurrentDraw (CDrawContext* pContext, const CRect& updateRect)
+{
+	if (!isDrawThreadSafe ())
+		return false;
+	// drawing clears the dirty flag, do it here so that the worker threads only read it
+	setDirty (false);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+static thread_local uint32_t gConcurrentDrawDepth = 0;
+
+//-----------------------------------------------------------------------------
+CView::ConcurrentDrawScope::ConcurrentDrawScope ()
+{
+	++gConcurrentDrawDepth;
+}
+
+//-----------------------------------------------------------------------------
+CView::ConcurrentDrawScope::~ConcurrentDrawScope () noexcept
+{
+	--gConcurrentDrawDepth;
+}
+
+//-----------------------------------------------------------------------------
+bool CView::isDrawingConcurrently ()
+{
+	return gConcurrentDrawDepth > 0;
+}
+
 //-----------------------------------------------------------------------------
 void CView::setSubviewState (bool state)
 {
@@ -998,6 +1055,7 @@ void CView::setViewSize (const CRect& newSize, bool doInvalid)
 		pImpl->size = newSize;
 		if (doInvalid)
 			setDirty ();
+		pImpl->childViewChanged (this);
 		if (getParentView ())
 			getParentView ()->notify (this, kMsgViewSizeChanged);
 		if (pImpl->viewListeners)
@@ -1040,6 +1098,7 @@ void CView::setVisible (bool state)
 			invalid ();
 			setViewFlag (kVisible, false);
 		}
+		pImpl->childViewChanged (this);
 	}
 }
 
@@ -1056,6 +1115,7 @@ void CView::setAlphaValueNoInvalidate (float value)
 		setAttribute (kCViewAlphaValueAttrID, value);
 		setViewFlag (kHasAlpha, true);
 	}
+	pImpl->childViewChanged (this);
 }
 
 //-----------------------------------------------------------------------------
@@ -1076,6 +1136,7 @@ void CView::setAlphaValue (float alpha)
 	}
 	if (oldAlpha != alpha)
 	{
+		pImpl->childViewChanged (this);
 		// we invalidate the parent to make sure that when alpha == 0 that a redraw occurs
 		if (pImpl->parentView)
 			pImpl->parentView->invalidRect (getViewSize ());
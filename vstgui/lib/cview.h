@@ -11,6 +11,7 @@
 #include "cbuttonstate.h"
 #include "cgraphicstransform.h"
 #include <memory>
+#include <typeinfo>
 
 namespace VSTGUI {
 
@@ -70,6 +71,28 @@ public:
 	/** if this is true, setting a view dirty will call invalid() instead of checking it in idle. Default value is false. */
 	static bool kDirtyCallAlwaysOnMainThread;
 
+	/** returns true if the view can be drawn on a worker thread while other views are drawn.
+	 *	Such a view must not change any state in draw () and drawRect (), setDirty does nothing
+	 *	while it is drawn concurrently. Default is false.
+	 */
+	virtual bool isDrawThreadSafe () const { return false; }
+	/** called on the main thread before the view is drawn on a worker thread.
+	 *	Builds state which would otherwise be created lazily while drawing.
+	 *	@return false if the view must be drawn on the main thread
+	 */
+	virtual bool prepareConcurrentDraw (CDrawContext* pContext, const CRect& updateRect);
+
+	/** marks the calling thread as drawing views which prepareConcurrentDraw certified, as long
+	 *	as it exists. Must be used as stack object.
+	 */
+	struct ConcurrentDrawScope
+	{
+		ConcurrentDrawScope ();
+		~ConcurrentDrawScope () noexcept;
+	};
+	/** true while a ConcurrentDrawScope exists on the calling thread */
+	static bool isDrawingConcurrently ();
+
 	/** mark rect as invalid */
 	virtual void invalidRect (const CRect& rect);
 	/** mark whole view as invalid */
@@ -328,6 +351,13 @@ public:
 	virtual void setAlphaValue (float alpha);
 	/** get alpha value */
 	float getAlphaValue () const;
+
+	/** declare that the view paints every pixel of its view size with opaque content.
+	 *	Containers do not draw what is hidden behind opaque views.
+	 */
+	void setOpaque (bool state);
+	/** returns true if the view paints every pixel of its view size with opaque content */
+	virtual bool isOpaque () const { return hasViewFlag (kOpaque); }
 	//@}
 
 	//-----------------------------------------------------------------------------
@@ -463,7 +493,8 @@ protected:
 		kHasBackground			= 1 << 9,
 		kHasDisabledBackground	= 1 << 10,
 		kHasMouseableArea		= 1 << 11,
-		kLastCViewFlag			= 11
+		kOpaque					= 1 << 12,
+		kLastCViewFlag			= 12
 	};
 
 	~CView () noexcept override;
@@ -482,6 +513,18 @@ private:
 	std::unique_ptr<Impl> pImpl;
 };
 
+//-----------------------------------------------------------------------------
+/** returns true if view is a T and not an instance of a class derived from T.
+ *
+ *	Views use it for properties which depend on how they draw, like CView::isDrawThreadSafe or
+ *	CView::isOpaque. Derived classes may draw differently and have to opt in themselves.
+ */
+template<typename T>
+inline bool isExactType (const T* view)
+{
+	return typeid (*view) == typeid (T);
+}
+
 //-----------------------------------------------------------------------------
 ///	@brief Helper class to port old code which used CDragContainer
 ///	@ingroup new_in_4_2
@@ -20,6 +20,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 namespace VSTGUI {
 
@@ -30,6 +34,361 @@ const CViewAttributeID kCViewContainerMouseDownViewAttribute = 'vcmd';
 const CViewAttributeID kCViewContainerLastDrawnFocusAttribute = 'vclf';
 const CViewAttributeID kCViewContainerBackgroundOffsetAttribute = 'vcbo';
 
+//-----------------------------------------------------------------------------
+// ChildViewList Implementation
+//-----------------------------------------------------------------------------
+size_t ChildViewList::find (const CView* view, size_t hint) const
+{
+	const auto& views = storage->views;
+	if (hint >= views.size ())
+		hint = 0;
+	for (auto index = hint; index < views.size (); ++index)
+	{
+		if (views[index] == view)
+			return index;
+	}
+	for (size_t index = 0; index < hint; ++index)
+	{
+		if (views[index] == view)
+			return index;
+	}
+	return npos;
+}
+
+//-----------------------------------------------------------------------------
+void ChildViewList::insert (size_t index, CView* view)
+{
+	listChanged ();
+	auto& s = mutableStorage ();
+	s.views.emplace (s.views.begin () + static_cast<std::ptrdiff_t> (index), view);
+	s.states.emplace (s.states.begin () + static_cast<std::ptrdiff_t> (index), makeState (view));
+}
+
+//-----------------------------------------------------------------------------
+void ChildViewList::erase (size_t index)
+{
+	listChanged ();
+	auto& s = mutableStorage ();
+	s.views.erase (s.views.begin () + static_cast<std::ptrdiff_t> (index));
+	s.states.erase (s.states.begin () + static_cast<std::ptrdiff_t> (index));
+}
+
+//-----------------------------------------------------------------------------
+void ChildViewList::move (size_t from, size_t to)
+{
+	listChanged ();
+	auto& s = mutableStorage ();
+	auto rotate = [&] (auto& vector) {
+		auto first = vector.begin ();
+		if (from < to)
+			std::rotate (first + static_cast<std::ptrdiff_t> (from),
+						 first + static_cast<std::ptrdiff_t> (from + 1),
+						 first + static_cast<std::ptrdiff_t> (to + 1));
+		else
+			std::rotate (first + static_cast<std::ptrdiff_t> (to),
+						 first + static_cast<std::ptrdiff_t> (from),
+						 first + static_cast<std::ptrdiff_t> (from + 1));
+	};
+	rotate (s.views);
+	rotate (s.states);
+}
+
+//-----------------------------------------------------------------------------
+void ChildViewList::updateState (size_t index)
+{
+	auto& s = mutableStorage ();
+	s.states[index] = makeState (s.views[index]);
+}
+
+//-----------------------------------------------------------------------------
+void ChildViewList::updateStates ()
+{
+	auto& s = mutableStorage ();
+	for (size_t index = 0; index < s.views.size (); ++index)
+		s.states[index] = makeState (s.views[index]);
+}
+
+//-----------------------------------------------------------------------------
+auto ChildViewList::asList () const -> const std::list<SharedPointer<CView>>&
+{
+	// the old list is only replaced here, so that it stays valid for code still iterating it
+	if (!listValid)
+	{
+		list.assign (storage->views.begin (), storage->views.end ());
+		listValid = true;
+	}
+	return list;
+}
+
+//-----------------------------------------------------------------------------
+auto ChildViewList::mutableStorage () -> Storage&
+{
+	// someone iterates the list, keep the storage for them
+	if (storage->getNbReference () > 1)
+		storage = makeOwned<Storage> (*storage);
+	return *storage;
+}
+
+namespace {
+
+//-----------------------------------------------------------------------------
+/** uniform grid over the child views of a container
+ *
+ *	Every cell holds the z-order positions of the children overlapping it in ascending order.
+ *	Children covering too many cells are kept in a separate list which is part of every query.
+ *	Adding a view on top and changing the geometry of a child update the grid in place, all
+ *	other changes of the child list mark it dirty and it is rebuilt on the next query.
+ */
+struct ChildViewGrid
+{
+	using Position = uint32_t;
+	using PositionList = std::vector<Position>;
+
+	void markDirty () { dirty = true; }
+	bool isDirty () const { return dirty; }
+
+	void rebuild (const ChildViewList& children)
+	{
+		views.clear ();
+		entries.clear ();
+		positions.clear ();
+		cells.clear ();
+		large.clear ();
+		dirty = false;
+
+		// use the median child size as cell size, so that most children cover only a few cells
+		std::vector<CCoord> widths;
+		std::vector<CCoord> heights;
+		widths.reserve (children.size ());
+		heights.reserve (children.size ());
+		for (const auto& view : children)
+		{
+			auto bounds = getBounds (view);
+			widths.push_back (bounds.getWidth ());
+			heights.push_back (bounds.getHeight ());
+		}
+		cellWidth = std::max (median (widths), kMinCellSize);
+		cellHeight = std::max (median (heights), kMinCellSize);
+
+		views.reserve (children.size ());
+		entries.reserve (children.size ());
+		positions.reserve (children.size ());
+		for (const auto& view : children)
+			append (view);
+	}
+
+	/** add a view on top of all other children */
+	void append (CView* view)
+	{
+		auto position = static_cast<Position> (views.size ());
+		views.push_back (view);
+		positions.emplace (view, position);
+		entries.push_back (makeEntry (getBounds (view)));
+		// the new position is the largest one, so the lists stay sorted
+		forEachList (entries.back (), [&] (PositionList& list) { list.push_back (position); });
+	}
+
+	void update (CView* view)
+	{
+		auto it = positions.find (view);
+		if (it == positions.end ())
+			return;
+		auto position = it->second;
+		auto entry = makeEntry (getBounds (view));
+		auto& oldEntry = entries[position];
+		if (entry.large == oldEntry.large && entry.left == oldEntry.left &&
+			entry.top == oldEntry.top && entry.right == oldEntry.right &&
+			entry.bottom == oldEntry.bottom)
+			return;
+		forEachList (oldEntry, [&] (PositionList& list) {
+			auto pos = std::lower_bound (list.begin (), list.end (), position);
+			if (pos != list.end () && *pos == position)
+				list.erase (pos);
+		});
+		oldEntry = entry;
+		forEachList (entry, [&] (PositionList& list) {
+			list.insert (std::lower_bound (list.begin (), list.end (), position), position);
+		});
+	}
+
+	bool getPosition (CView* view, Position& position) const
+	{
+		auto it = positions.find (view);
+		if (it == positions.end ())
+			return false;
+		position = it->second;
+		return true;
+	}
+
+	CView* getView (Position position) const { return views[position]; }
+
+	/** call proc with the children which may contain p from top to bottom until it returns
+	 *	true. proc must not change the children of the container.
+	 */
+	template<typename Proc>
+	void forEachViewAt (const CPoint& p, Proc proc) const
+	{
+		static const PositionList emptyList;
+		const PositionList* cell = &emptyList;
+		auto it = cells.find (makeKey (cellX (p.x), cellY (p.y)));
+		if (it != cells.end ())
+			cell = &it->second;
+		auto c = cell->rbegin ();
+		auto l = large.rbegin ();
+		while (c != cell->rend () || l != large.rend ())
+		{
+			Position position;
+			if (l == large.rend () || (c != cell->rend () && *c > *l))
+				position = *c++;
+			else
+				position = *l++;
+			if (proc (views[position]))
+				break;
+		}
+	}
+
+	/** collect the positions of the children which may overlap r in ascending order */
+	void collect (const CRect& r, PositionList& result) const
+	{
+		result = large;
+		auto rect = r;
+		rect.normalize ();
+		auto left = cellX (rect.left);
+		auto right = cellX (rect.right);
+		auto top = cellY (rect.top);
+		auto bottom = cellY (rect.bottom);
+		if ((static_cast<double> (right) - left + 1.) * (static_cast<double> (bottom) - top + 1.) >
+			static_cast<double> (cells.size ()))
+		{
+			for (const auto& cell : cells)
+			{
+				if (cell.first.x >= left && cell.first.x <= right && cell.first.y >= top &&
+					cell.first.y <= bottom)
+					result.insert (result.end (), cell.second.begin (), cell.second.end ());
+			}
+		}
+		else
+		{
+			for (auto y = top; y <= bottom; ++y)
+			{
+				for (auto x = left; x <= right; ++x)
+				{
+					auto it = cells.find (makeKey (x, y));
+					if (it != cells.end ())
+						result.insert (result.end (), it->second.begin (), it->second.end ());
+				}
+			}
+		}
+		std::sort (result.begin (), result.end ());
+		result.erase (std::unique (result.begin (), result.end ()), result.end ());
+	}
+
+private:
+	static constexpr CCoord kMinCellSize = 8.;
+	static constexpr double kMaxCellsPerView = 16.;
+
+	struct Key
+	{
+		int32_t x;
+		int32_t y;
+		bool operator== (const Key& other) const { return x == other.x && y == other.y; }
+	};
+	struct KeyHash
+	{
+		size_t operator() (const Key& key) const
+		{
+			return std::hash<uint64_t> () ((static_cast<uint64_t> (static_cast<uint32_t> (key.x)) << 32) |
+										   static_cast<uint32_t> (key.y));
+		}
+	};
+	struct Entry
+	{
+		int32_t left {0};
+		int32_t top {0};
+		int32_t right {0};
+		int32_t bottom {0};
+		bool large {false};
+	};
+
+	static CRect getBounds (const CView* view)
+	{
+		auto bounds = view->getViewSize ();
+		auto mouseableArea = view->getMouseableArea ();
+		bounds.normalize ();
+		bounds.unite (mouseableArea.normalize ());
+		return bounds;
+	}
+
+	static CCoord median (std::vector<CCoord>& values)
+	{
+		if (values.empty ())
+			return 0.;
+		auto middle = values.begin () + static_cast<std::ptrdiff_t> (values.size () / 2);
+		std::nth_element (values.begin (), middle, values.end ());
+		return *middle;
+	}
+
+	static Key makeKey (int32_t x, int32_t y) { return {x, y}; }
+
+	static int32_t toCell (CCoord value, CCoord cellSize)
+	{
+		auto cell = std::floor (value / cellSize);
+		if (!(cell > static_cast<CCoord> (std::numeric_limits<int32_t>::min ())))
+			return std::numeric_limits<int32_t>::min ();
+		if (!(cell < static_cast<CCoord> (std::numeric_limits<int32_t>::max ())))
+			return std::numeric_limits<int32_t>::max ();
+		return static_cast<int32_t> (cell);
+	}
+	int32_t cellX (CCoord x) const { return toCell (x, cellWidth); }
+	int32_t cellY (CCoord y) const { return toCell (y, cellHeight); }
+
+	Entry makeEntry (const CRect& bounds) const
+	{
+		Entry entry;
+		entry.left = cellX (bounds.left);
+		entry.right = cellX (bounds.right);
+		entry.top = cellY (bounds.top);
+		entry.bottom = cellY (bounds.bottom);
+		entry.large = (static_cast<double> (entry.right) - entry.left + 1.) *
+						  (static_cast<double> (entry.bottom) - entry.top + 1.) >
+					  kMaxCellsPerView;
+		return entry;
+	}
+
+	template<typename Proc>
+	void forEachList (const Entry& entry, Proc proc)
+	{
+		if (entry.large)
+		{
+			proc (large);
+			return;
+		}
+		for (auto y = entry.top; y <= entry.bottom; ++y)
+		{
+			for (auto x = entry.left; x <= entry.right; ++x)
+			{
+				auto key = makeKey (x, y);
+				auto& list = cells[key];
+				proc (list);
+				if (list.empty ())
+					cells.erase (key);
+			}
+		}
+	}
+
+	std::vector<CView*> views;
+	std::vector<Entry> entries;
+	std::unordered_map<const CView*, Position> positions;
+	std::unordered_map<Key, PositionList, KeyHash> cells;
+	PositionList large;
+	CCoord cellWidth {kMinCellSize};
+	CCoord cellHeight {kMinCellSize};
+	bool dirty {true};
+};
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
 //-----------------------------------------------------------------------------
 // CViewContainer Implementation
 //-----------------------------------------------------------------------------
@@ -40,10 +399,46 @@ struct CViewContainer::Impl
 	ViewContainerListenerDispatcher viewContainerListeners;
 	CGraphicsTransform transform;
 	
-	ViewList children;
+	ChildViewList children;
+	size_t lastChangedChild {0};
+	std::unique_ptr<ChildViewGrid> childViewGrid;
 	
 	CDrawStyle backgroundColorDrawStyle {kDrawFilledAndStroked};
 	CColor backgroundColor {kBlackCColor};
+
+	/** the spatial index of the children if it is enabled and usable */
+	ChildViewGrid* getChildViewGrid (bool attached)
+	{
+		if (!childViewGrid || !attached)
+			return nullptr;
+		if (childViewGrid->isDirty ())
+			childViewGrid->rebuild (children);
+		return childViewGrid.get ();
+	}
+
+	void childViewsChanged ()
+	{
+		if (childViewGrid)
+			childViewGrid->markDirty ();
+	}
+
+	/** call proc with the children which may contain where from top to bottom until it returns
+	 *	true
+	 */
+	template<typename Proc>
+	void forEachChildAt (const CPoint& where, bool attached, Proc proc)
+	{
+		if (auto grid = getChildViewGrid (attached))
+		{
+			grid->forEachViewAt (where, proc);
+			return;
+		}
+		for (auto it = children.rbegin (), end = children.rend (); it != end; ++it)
+		{
+			if (proc (*it))
+				break;
+		}
+	}
 };
 
 //------------------------------------------------------------------------
@@ -151,6 +546,7 @@ CViewContainer::CViewContainer (const CViewContainer& v)
 	pImpl->backgroundColorDrawStyle = v.pImpl->backgroundColorDrawStyle;
 	pImpl->backgroundColor = v.pImpl->backgroundColor;
 	setBackgroundOffset (v.getBackgroundOffset ());
+	setSpatialIndexEnabled (v.isSpatialIndexEnabled ());
 	for (auto& view : v.pImpl->children)
 		addView (static_cast<CView*> (view->newCopy ()));
 }
@@ -188,10 +584,41 @@ void CViewContainer::unregisterViewContainerListener (IViewContainerListener* li
 	pImpl->viewContainerListeners.remove (listener);
 }
 
+//-----------------------------------------------------------------------------
+void CViewContainer::setSpatialIndexEnabled (bool state)
+{
+	if (state == isSpatialIndexEnabled ())
+		return;
+	if (state)
+		pImpl->childViewGrid = std::unique_ptr<ChildViewGrid> (new ChildViewGrid ());
+	else
+		pImpl->childViewGrid = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool CViewContainer::isSpatialIndexEnabled () const
+{
+	return pImpl->childViewGrid != nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void CViewContainer::onChildViewChanged (CView* child)
+{
+	// children are often changed in order, for example when a scroll container moves them
+	auto index = pImpl->children.find (child, pImpl->lastChangedChild + 1);
+	if (index != ChildViewList::npos)
+	{
+		pImpl->children.updateState (index);
+		pImpl->lastChangedChild = index;
+	}
+	if (pImpl->childViewGrid && !pImpl->childViewGrid->isDirty ())
+		pImpl->childViewGrid->update (child);
+}
+
 //-----------------------------------------------------------------------------
 void CViewContainer::parentSizeChanged ()
 {
-	for (const auto& pV : pImpl->children)
+	for (const auto& pV : pImpl->children.snapshot ())
 		pV->parentSizeChanged ();	// notify children that the size of the parent or this container has changed
 }
 
@@ -253,11 +680,17 @@ void CViewContainer::setLastDrawnFocus (CRect r)
 }
 
 //-----------------------------------------------------------------------------
-auto CViewContainer::getChildren () const -> const ViewList&
+auto CViewContainer::getChildViews () const -> const ChildViewList&
 {
 	return pImpl->children;
 }
 
+//-----------------------------------------------------------------------------
+auto CViewContainer::getChildren () const -> const ViewList&
+{
+	return pImpl->children.asList ();
+}
+
 //-----------------------------------------------------------------------------
 void CViewContainer::setTransform (const CGraphicsTransform& t)
 {
@@ -307,7 +740,7 @@ void CViewContainer::setViewSize (const CRect &rect, bool invalid)
 			uint32_t counter = 0;
 			bool treatAsColumn = (getAutosizeFlags () & kAutosizeColumn) != 0;
 			bool treatAsRow = (getAutosizeFlags () & kAutosizeRow) != 0;
-			for (const auto& pV : pImpl->children)
+			for (const auto& pV : pImpl->children.snapshot ())
 			{
 				int32_t autosize = pV->getAutosizeFlags ();
 				CRect viewSize (pV->getViewSize ());
@@ -518,13 +951,18 @@ bool CViewContainer::addView (CView *pView, CView* pBefore)
 
 	if (pBefore)
 	{
-		auto it = std::find (pImpl->children.begin (), pImpl->children.end (), pBefore);
-		vstgui_assert (it != pImpl->children.end ());
-		pImpl->children.insert (it, pView);
+		auto index = pImpl->children.find (pBefore);
+		vstgui_assert (index != ChildViewList::npos);
+		if (index == ChildViewList::npos)
+			index = pImpl->children.size ();
+		pImpl->children.insert (index, pView);
+		pImpl->childViewsChanged ();
 	}
 	else
 	{
-		pImpl->children.emplace_back (pView);
+		pImpl->children.insert (pImpl->children.size (), pView);
+		if (pImpl->childViewGrid && !pImpl->childViewGrid->isDirty ())
+			pImpl->childViewGrid->append (pView);
 	}
 
 	pView->setSubviewState (true);
@@ -567,21 +1005,22 @@ bool CViewContainer::addView (CView* pView, const CRect &mouseableArea, bool mou
 bool CViewContainer::removeAll (bool withForget)
 {
 	clearMouseDownView ();
-	
-	auto it = pImpl->children.begin ();
-	while (it != pImpl->children.end ())
+
+	ChildViewList children;
+	std::swap (children, pImpl->children);
+	if (children.empty ())
+		return true;
+	pImpl->childViewsChanged ();
+	for (const auto& view : children)
 	{
-		auto view = *it;
 		if (isAttached ())
 			view->removed (this);
-		pImpl->children.erase (it);
 		view->setSubviewState (false);
 		pImpl->viewContainerListeners.forEach ([&] (IViewContainerListener* listener) {
 			listener->viewContainerViewRemoved (this, view);
 		});
 		if (withForget)
 			view->forget ();
-		it = pImpl->children.begin ();
 	}
 	return true;
 }
@@ -594,8 +1033,8 @@ bool CViewContainer::removeAll (bool withForget)
  */
 bool CViewContainer::removeView (CView *pView, bool withForget)
 {
-	auto it = std::find (pImpl->children.begin (), pImpl->children.end (), pView);
-	if (it != pImpl->children.end ())
+	auto index = pImpl->children.find (pView);
+	if (index != ChildViewList::npos)
 	{
 		pView->invalid ();
 		if (pView == getMouseDownView ())
@@ -608,7 +1047,11 @@ bool CViewContainer::removeView (CView *pView, bool withForget)
 		});
 		if (withForget)
 			pView->forget ();
-		pImpl->children.erase (it);
+		// the callbacks above may have changed the children
+		index = pImpl->children.find (pView, index);
+		if (index != ChildViewList::npos)
+			pImpl->children.erase (index);
+		pImpl->childViewsChanged ();
 		return true;
 	}
 	return false;
@@ -647,7 +1090,7 @@ bool CViewContainer::isChild (CView *pView, bool deep) const
 	}
 	else
 	{
-		found = std::find (pImpl->children.begin (), pImpl->children.end (), pView) != pImpl->children.end ();
+		found = pImpl->children.find (pView) != ChildViewList::npos;
 	}
 	return found;
 }
@@ -674,10 +1117,8 @@ uint32_t CViewContainer::getNbViews () const
  */
 CView* CViewContainer::getView (uint32_t index) const
 {
-	auto it = pImpl->children.begin ();
-	std::advance (it, index);
-	if (it != pImpl->children.end ())
-		return *it;
+	if (index < pImpl->children.size ())
+		return pImpl->children[index];
 	return nullptr;
 }
 
@@ -691,21 +1132,14 @@ bool CViewContainer::changeViewZOrder (CView* view, uint32_t newIndex)
 {
 	if (newIndex < getNbViews ())
 	{
-		uint32_t oldIndex = 0;
-		auto src = pImpl->children.begin ();
-		for (;src != pImpl->children.end () && *src != view; ++src, ++oldIndex);
-		if (src != pImpl->children.end ())
+		auto oldIndex = pImpl->children.find (view);
+		if (oldIndex != ChildViewList::npos)
 		{
 			if (newIndex == oldIndex)
 				return true;
-			if (newIndex > oldIndex)
-				++newIndex;
-
-			auto dest = pImpl->children.begin ();
-			std::advance (dest, newIndex);
 
-			pImpl->children.insert (dest, view);
-			pImpl->children.erase (src);
+			pImpl->children.move (oldIndex, newIndex);
+			pImpl->childViewsChanged ();
 
 			pImpl->viewContainerListeners.forEach ([&] (IViewContainerListener* listener) {
 				listener->viewContainerViewZOrderChanged (this, view);
@@ -810,6 +1244,184 @@ void CViewContainer::drawBackgroundRect (CDrawContext* pContext, const CRect& _u
 	}
 }
 
+//-----------------------------------------------------------------------------
+bool CViewContainer::isOpaque () const
+{
+	if (CView::isOpaque ())
+		return true;
+	return isExactType (this) && hasOpaqueBackground ();
+}
+
+//-----------------------------------------------------------------------------
+bool CViewContainer::hasOpaqueBackground () const
+{
+	if (getDrawBackground () || getTransparency () || pImpl->backgroundColor.alpha != 255)
+		return false;
+	return pImpl->backgroundColorDrawStyle != kDrawStroked;
+}
+
+//-----------------------------------------------------------------------------
+bool CViewContainer::honorsDrawRegion () const
+{
+	return isExactType (this);
+}
+
+//-----------------------------------------------------------------------------
+bool CViewContainer::isDrawThreadSafe () const
+{
+	return isExactType (this);
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * @param pContext the context which draws the area on the main thread
+ * @param updateRect the area which will be drawn
+ * @return true if the container and all children drawn into updateRect can be drawn on a worker
+ * thread
+ */
+bool CViewContainer::prepareConcurrentDraw (CDrawContext* pContext, const CRect& updateRect)
+{
+	if (!isDrawThreadSafe () || !isAttached ())
+		return false;
+	// the focus is drawn and remembered by the container which has the focus view as child
+	auto frame = getFrame ();
+	if (frame && frame->focusDrawingEnabled () && isChild (frame->getFocusView (), false))
+		return false;
+
+	CRect clientRect (updateRect);
+	clientRect.bound (getViewSize ());
+	clientRect.offset (-getViewSize ().left, -getViewSize ().top);
+	getTransform ().inverse ().transform (clientRect);
+
+	CPoint offset (getViewSize ().left, getViewSize ().top);
+	CDrawContext::Transform offsetTransform (*pContext, CGraphicsTransform ().translate (offset.x, offset.y));
+	CDrawContext::Transform tr (*pContext, getTransform ());
+
+	auto prepareChild = [&] (CView* pV, const ChildViewList::State& state) {
+		if (!state.visible)
+			return true;
+		auto r = state.viewSize;
+		r.bound (clientRect);
+		if (r.isEmpty () || !checkUpdateRect (pV, clientRect))
+			return true;
+		return pV->prepareConcurrentDraw (pContext, r);
+	};
+	// the spatial index is rebuilt here, so that the worker threads only read it
+	if (auto childViewGrid = pImpl->getChildViewGrid (true))
+	{
+		ChildViewGrid::PositionList positions;
+		childViewGrid->collect (clientRect, positions);
+		for (auto position : positions)
+		{
+			if (!prepareChild (childViewGrid->getView (position), pImpl->children.getState (position)))
+				return false;
+		}
+	}
+	else
+	{
+		const auto& children = pImpl->children;
+		for (auto it = children.begin (), end = children.end (); it != end; ++it)
+		{
+			if (!prepareChild (it->get (), it.getState ()))
+				return false;
+		}
+	}
+	// drawing clears the dirty flag, do it here so that the worker threads only read it
+	setDirty (false);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+namespace {
+
+//-----------------------------------------------------------------------------
+/** the opaque children of a container in drawing order */
+struct Occluders
+{
+	struct Entry
+	{
+		size_t position;
+		CRect rect;
+	};
+	using EntryList = std::vector<Entry>;
+
+	void add (size_t position, const CRect& rect) { entries.push_back ({position, rect}); }
+	bool empty () const { return entries.empty (); }
+
+	/** only use the occluders which are drawn after the child at position */
+	void drawnAfter (size_t position)
+	{
+		while (first < entries.size () && entries[first].position <= position)
+			++first;
+	}
+
+	/** the bounding box of the part of rect which is not covered by the occluders */
+	CRect visiblePart (const CRect& rect) const
+	{
+		auto begin = entries.begin () + static_cast<EntryList::difference_type> (first);
+		auto intersects = [] (const CRect& r1, const CRect& r2) {
+			return r1.left < r2.right && r1.right > r2.left && r1.top < r2.bottom &&
+				   r1.bottom > r2.top;
+		};
+		auto it = std::find_if (begin, entries.end (),
+								[&] (const Entry& e) { return intersects (e.rect, rect); });
+		if (it == entries.end ())
+			return rect;
+
+		parts.clear ();
+		parts.push_back (rect);
+		for (; it != entries.end () && !parts.empty (); ++it)
+		{
+			const auto& o = it->rect;
+			for (size_t i = 0; i < parts.size ();)
+			{
+				auto r = parts[i];
+				if (!intersects (o, r))
+				{
+					++i;
+					continue;
+				}
+				// replace the part with the up to four pieces not covered by the occluder
+				parts[i] = parts.back ();
+				parts.pop_back ();
+				if (o.top > r.top)
+					parts.push_back ({r.left, r.top, r.right, o.top});
+				if (o.bottom < r.bottom)
+					parts.push_back ({r.left, o.bottom, r.right, r.bottom});
+				auto top = std::max (r.top, o.top);
+				auto bottom = std::min (r.bottom, o.bottom);
+				if (o.left > r.left)
+					parts.push_back ({r.left, top, o.left, bottom});
+				if (o.right < r.right)
+					parts.push_back ({o.right, top, r.right, bottom});
+				if (parts.size () > kMaxParts)
+					return boundingBox ();
+			}
+		}
+		return boundingBox ();
+	}
+
+private:
+	static constexpr size_t kMaxParts = 32;
+
+	CRect boundingBox () const
+	{
+		if (parts.empty ())
+			return {};
+		auto result = parts.front ();
+		for (const auto& r : parts)
+			result.unite (r);
+		return result;
+	}
+
+	EntryList entries;
+	size_t first {0};
+	mutable std::vector<CRect> parts;
+};
+
+//-----------------------------------------------------------------------------
+} // anonymous
+
 //-----------------------------------------------------------------------------
 /**
  * @param pContext the context which to use to draw
@@ -833,10 +1445,7 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 	CRect newClip (clientRect);
 	newClip.bound (oldClip);
 	pContext->setClipRect (newClip);
-	
-	// draw the background
-	drawBackgroundRect (pContext, clientRect);
-	
+
 	CView* _focusView = nullptr;
 	IFocusDrawing* _focusDrawing = nullptr;
 	auto frame = getFrame ();
@@ -846,6 +1455,93 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 		_focusDrawing = dynamic_cast<IFocusDrawing*> (_focusView);
 	}
 
+	// with the spatial index only the children near the update rect are visited
+	struct IndexedChild
+	{
+		size_t position;
+		CView* view;
+		ChildViewList::State state;
+	};
+	std::vector<IndexedChild> indexedChildren;
+	auto attached = isAttached ();
+	auto childViewGrid = pImpl->getChildViewGrid (attached);
+	if (childViewGrid)
+	{
+		CRect childClientRect (clientRect);
+		getTransform ().inverse ().transform (childClientRect);
+		ChildViewGrid::PositionList positions;
+		childViewGrid->collect (childClientRect, positions);
+		// the focus view is drawn with the children even if it is outside of the update rect
+		ChildViewGrid::Position focusPosition;
+		if (_focusView && childViewGrid->getPosition (_focusView, focusPosition))
+		{
+			auto it = std::lower_bound (positions.begin (), positions.end (), focusPosition);
+			if (it == positions.end () || *it != focusPosition)
+				positions.insert (it, focusPosition);
+		}
+		indexedChildren.reserve (positions.size ());
+		for (auto position : positions)
+			indexedChildren.push_back ({position, childViewGrid->getView (position),
+										pImpl->children.getState (position)});
+	}
+	// a child may add or remove views while it is drawn
+	auto children = pImpl->children.snapshot ();
+	// the children report their visibility and size only while the container is attached
+	auto forEachChild = [&] (auto proc) {
+		if (childViewGrid)
+		{
+			for (const auto& child : indexedChildren)
+				proc (child.position, child.view, child.state);
+			return;
+		}
+		for (auto it = children.begin (), end = children.end (); it != end; ++it)
+		{
+			if (attached)
+				proc (it.position (), it->get (), it.getState ());
+			else
+				proc (it.position (), it->get (), ChildViewList::makeState (*it));
+		}
+	};
+
+	CRect childClip (newClip);
+	getTransform ().inverse ().transform (childClip);
+
+	// collect the opaque children, everything drawn before them is hidden where they are
+	Occluders occluders;
+	{
+		CRect childClientRect (clientRect);
+		getTransform ().inverse ().transform (childClientRect);
+		forEachChild ([&] (size_t position, CView* pV, const ChildViewList::State& state) {
+			if (!state.visible)
+				return;
+			auto r = state.viewSize;
+			r.bound (childClip);
+			if (r.isEmpty ())
+				return;
+			if (pV->getAlphaValue () >= 1.f && pV->isOpaque () &&
+				checkUpdateRect (pV, childClientRect))
+				occluders.add (position, r);
+		});
+	}
+	// the background is drawn untransformed, so only cull it without a transform
+	auto cullBackground = !occluders.empty () && getTransform ().isInvariant ();
+
+	// draw the background
+	if (pContext->hasDrawRegion ())
+	{
+		pContext->forEachDrawRegionPart (newClip, [&] (const CRect& part) {
+			auto r = cullBackground ? occluders.visiblePart (part) : part;
+			if (!r.isEmpty ())
+				drawBackgroundRect (pContext, r);
+		});
+	}
+	else
+	{
+		auto r = cullBackground ? occluders.visiblePart (clientRect) : clientRect;
+		if (!r.isEmpty ())
+			drawBackgroundRect (pContext, r);
+	}
+
 	{
 		CDrawContext::Transform tr (*pContext, getTransform ());
 		getTransform ().inverse ().transform (newClip);
@@ -853,8 +1549,18 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 		getTransform ().transform (oldClip2);
 		
 		// draw each view
-		for (const auto& pV : pImpl->children)
-		{
+		forEachChild ([&] (size_t position, CView* pV, const ChildViewList::State& state) {
+			occluders.drawnAfter (position);
+			if (!state.visible)
+				return;
+			// the focus view may draw its focus outside of the update rect
+			if (pV != _focusView)
+			{
+				auto r = state.viewSize;
+				r.bound (childClip);
+				if (r.getWidth () == 0 || r.getHeight () == 0)
+					return;
+			}
 			if (pV->isVisible ())
 			{
 				if (frame && _focusDrawing && _focusView == pV && !_focusDrawing->drawFocusOnTop ())
@@ -867,12 +1573,14 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 							auto lastDrawnFocus = focusPath->getBoundingBox ();
 							if (!lastDrawnFocus.isEmpty ())
 							{
-								pContext->setClipRect (oldClip2);
-								pContext->setDrawMode (kAntiAliasing|kNonIntegralMode);
-								pContext->setFillColor (frame->getFocusColor ());
-								pContext->drawGraphicsPath (focusPath, CDrawContext::kPathFilledEvenOdd);
+								pContext->forEachDrawRegionPart (oldClip2, [&] (const CRect&) {
+									pContext->setDrawMode (kAntiAliasing|kNonIntegralMode);
+									pContext->setFillColor (frame->getFocusColor ());
+									pContext->drawGraphicsPath (focusPath, CDrawContext::kPathFilledEvenOdd);
+								});
 								lastDrawnFocus.extend (1, 1);
-								setLastDrawnFocus (lastDrawnFocus);
+								if (!isDrawingConcurrently ())
+									setLastDrawnFocus (lastDrawnFocus);
 							}
 							_focusDrawing = nullptr;
 							_focusView = nullptr;
@@ -885,15 +1593,40 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 					CRect viewSize = pV->getViewSize ();
 					viewSize.bound (newClip);
 					if (viewSize.getWidth () == 0 || viewSize.getHeight () == 0)
-						continue;
-					pContext->setClipRect (viewSize);
+						return;
+					if (!occluders.empty ())
+					{
+						viewSize = occluders.visiblePart (viewSize);
+						if (viewSize.isEmpty ())
+							return;
+					}
 					float globalContextAlpha = pContext->getGlobalAlpha ();
 					pContext->setGlobalAlpha (globalContextAlpha * pV->getAlphaValue ());
-					pV->drawRect (pContext, viewSize);
+					if (!pContext->hasDrawRegion ())
+					{
+						pContext->setClipRect (viewSize);
+						pV->drawRect (pContext, viewSize);
+					}
+					else if (pV->asViewContainer () && pV->asViewContainer ()->honorsDrawRegion ())
+					{
+						// containers walk the draw region themselves, so they are only drawn once
+						viewSize = pContext->boundToDrawRegion (viewSize);
+						if (!viewSize.isEmpty ())
+						{
+							pContext->setClipRect (viewSize);
+							pV->drawRect (pContext, viewSize);
+						}
+					}
+					else
+					{
+						pContext->forEachDrawRegionPart (viewSize, [&] (const CRect& part) {
+							pV->drawRect (pContext, part);
+						});
+					}
 					pContext->setGlobalAlpha (globalContextAlpha);
 				}
 			}
-		}
+		});
 	}
 	
 	pContext->setClipRect (oldClip2);
@@ -919,16 +1652,20 @@ void CViewContainer::drawRect (CDrawContext* pContext, const CRect& updateRect)
 			auto lastDrawnFocus = focusPath->getBoundingBox ();
 			if (!lastDrawnFocus.isEmpty ())
 			{
-				pContext->setDrawMode (kAntiAliasing|kNonIntegralMode);
-				pContext->setFillColor (frame->getFocusColor ());
-				pContext->drawGraphicsPath (focusPath, CDrawContext::kPathFilledEvenOdd);
+				pContext->forEachDrawRegionPart (oldClip2, [&] (const CRect&) {
+					pContext->setDrawMode (kAntiAliasing|kNonIntegralMode);
+					pContext->setFillColor (frame->getFocusColor ());
+					pContext->drawGraphicsPath (focusPath, CDrawContext::kPathFilledEvenOdd);
+				});
 				lastDrawnFocus.extend (1, 1);
-				setLastDrawnFocus (lastDrawnFocus);
+				if (!isDrawingConcurrently ())
+					setLastDrawnFocus (lastDrawnFocus);
 			}
 		}
 	}
 	
-	setDirty (false);
+	if (!isDrawingConcurrently ())
+		setDirty (false);
 }
 
 //-----------------------------------------------------------------------------
@@ -955,21 +1692,18 @@ bool CViewContainer::hitTestSubViews (const CPoint& where, const Event& event)
 	where2.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where2);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	bool result = false;
+	pImpl->forEachChildAt (where2, isAttached (), [&] (CView* pV) {
 		if (pV && pV->isVisible () && pV->getMouseEnabled () && pV->hitTest (where2, event))
 		{
 			if (auto container = pV->asViewContainer ())
-			{
-				if (container->hitTestSubViews (where2, event))
-					return true;
-			}
+				result = container->hitTestSubViews (where2, event);
 			else
-				return true;
+				result = true;
 		}
-	}
-	return false;
+		return result;
+	});
+	return result;
 }
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
@@ -990,8 +1724,8 @@ void CViewContainer::dispatchEventToSubViews (Event& event)
 		auto f = finally ([&] () { mouseEvent->mousePosition = mousePos; });
 		mouseEvent->mousePosition.offset (-getViewSize ().left, -getViewSize ().top);
 		getTransform ().inverse ().transform (mouseEvent->mousePosition);
-		for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end;
-			 ++it)
+		auto children = pImpl->children.snapshot ();
+		for (auto it = children.rbegin (), end = children.rend (); it != end; ++it)
 		{
 			const auto& pV = *it;
 			if (pV && pV->isVisible () && pV->getMouseEnabled () &&
@@ -1033,7 +1767,8 @@ void CViewContainer::onMouseDownEvent (MouseDownEvent& event)
 	auto f = finally ([&, pos = event.mousePosition] () { event.mousePosition = pos; });
 	event.mousePosition.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (event.mousePosition);
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
+	auto children = pImpl->children.snapshot ();
+	for (auto it = children.rbegin (), end = children.rend (); it != end; ++it)
 	{
 		const auto& pV = *it;
 		if (pV && pV->isVisible () && pV->getMouseEnabled () &&
@@ -1303,9 +2038,10 @@ bool CViewContainer::advanceNextFocusView (CView* oldFocus, bool reverse)
 			return false;
 		};
 
+		auto children = pImpl->children.snapshot ();
 		if (reverse)
 		{
-			for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
+			for (auto it = children.rbegin (), end = children.rend (); it != end; ++it)
 			{
 				if (func (*it))
 					return true;
@@ -1313,7 +2049,7 @@ bool CViewContainer::advanceNextFocusView (CView* oldFocus, bool reverse)
 		}
 		else
 		{
-			for (const auto& view : pImpl->children)
+			for (const auto& view : children)
 			{
 				if (func (view))
 					return true;
@@ -1357,33 +2093,35 @@ CView* CViewContainer::getViewAt (const CPoint& p, const GetViewOptions& options
 	where.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	CView* result = nullptr;
+	pImpl->forEachChildAt (where, isAttached (), [&] (CView* pV) {
 		if (pV && pV->getMouseableArea ().pointInside (where))
 		{
 			if (!options.getIncludeInvisible () && pV->isVisible () == false)
-				continue;
+				return false;
 			if (options.getMouseEnabled ())
 			{
 				if (pV->getMouseEnabled () == false)
-					continue;
+					return false;
 			}
 			if (options.getDeep ())
 			{
 				if (auto container = pV->asViewContainer ())
 				{
 					CView* view = container->getViewAt (where, options);
-					return options.getIncludeViewContainer () ? (view ? view : container) : view;
+					result = options.getIncludeViewContainer () ? (view ? view : container) : view;
+					return true;
 				}
 			}
 			if (!options.getIncludeViewContainer () && pV->asViewContainer ())
-				continue;
-			return pV;
+				return false;
+			result = pV;
+			return true;
 		}
-	}
+		return false;
+	});
 
-	return nullptr;
+	return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -1401,17 +2139,15 @@ bool CViewContainer::getViewsAt (const CPoint& p, ViewList& views, const GetView
 	where.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	pImpl->forEachChildAt (where, isAttached (), [&] (CView* pV) {
 		if (pV && pV->getMouseableArea ().pointInside (where))
 		{
 			if (!options.getIncludeInvisible () && pV->isVisible () == false)
-				continue;
+				return false;
 			if (options.getMouseEnabled ())
 			{
 				if (pV->getMouseEnabled () == false)
-					continue;
+					return false;
 			}
 			if (options.getDeep ())
 			{
@@ -1421,12 +2157,13 @@ bool CViewContainer::getViewsAt (const CPoint& p, ViewList& views, const GetView
 			if (options.getIncludeViewContainer () == false)
 			{
 				if (pV->asViewContainer ())
-					continue;
+					return false;
 			}
 			views.emplace_back (pV);
 			result = true;
 		}
-	}
+		return false;
+	});
 
 	return result;
 }
@@ -1443,28 +2180,28 @@ CViewContainer* CViewContainer::getContainerAt (const CPoint& p, const GetViewOp
 	where.offset (-getViewSize ().left, -getViewSize ().top);
 	getTransform ().inverse ().transform (where);
 
-	for (auto it = pImpl->children.rbegin (), end = pImpl->children.rend (); it != end; ++it)
-	{
-		const auto& pV = *it;
+	auto result = const_cast<CViewContainer*>(this);
+	pImpl->forEachChildAt (where, isAttached (), [&] (CView* pV) {
 		if (pV && pV->getMouseableArea ().pointInside (where))
 		{
 			if (!options.getIncludeInvisible () && pV->isVisible () == false)
-				continue;
+				return false;
 			if (options.getMouseEnabled ())
 			{
 				if (pV->getMouseEnabled() == false)
-					continue;
+					return false;
 			}
 			if (options.getDeep ())
 			{
 				if (CViewContainer* container = pV->asViewContainer ())
-					return container->getContainerAt (where, options);
+					result = container->getContainerAt (where, options);
 			}
-			break;
+			return true;
 		}
-	}
+		return false;
+	});
 
-	return const_cast<CViewContainer*>(this);
+	return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -1491,8 +2228,9 @@ bool CViewContainer::removed (CView* parent)
 	if (!isAttached ())
 		return false;
 
-	for (const auto& pV : pImpl->children)
+	for (const auto& pV : pImpl->children.snapshot ())
 		pV->removed (this);
+	pImpl->childViewsChanged ();
 	
 	return CView::removed (parent);
 }
@@ -1508,7 +2246,10 @@ bool CViewContainer::attached (CView* parent)
 	bool result = CView::attached (parent);
 	if (result)
 	{
-		for (const auto& pV : pImpl->children)
+		// the children do not report changes while the container is not attached
+		pImpl->children.updateStates ();
+		pImpl->childViewsChanged ();
+		for (const auto& pV : pImpl->children.snapshot ())
 			pV->attached (this);
 	}
 	return result;
@@ -10,8 +10,10 @@
 #if VSTGUI_TOUCH_EVENT_HANDLING
 #include "itouchevent.h"
 #endif
+#include <iterator>
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace VSTGUI {
 
@@ -44,6 +46,165 @@ private:
 	uint32_t flags;
 };
 
+//-----------------------------------------------------------------------------
+/** contiguous storage of the child views of a container
+ *
+ *	Next to the views the list keeps an array with the visibility and size of every child, so
+ *	that drawing can skip children without touching them.
+ *
+ *	Iterators and snapshots keep the storage they were created from alive. Changing the list while
+ *	one of them exists copies the storage first, so they keep iterating the views as they were and
+ *	are not affected by views added, removed or moved in the meantime. Code which calls out to the
+ *	children while iterating takes a Snapshot, so that it does not depend on iterator lifetimes.
+ */
+class ChildViewList
+{
+public:
+	struct State
+	{
+		CRect viewSize;
+		bool visible {false};
+	};
+
+	static State makeState (const CView* view) { return {view->getViewSize (), view->isVisible ()}; }
+
+private:
+	// snapshots share the storage, which may happen on several draw threads at once
+	struct Storage : AtomicReferenceCounted
+	{
+		std::vector<SharedPointer<CView>> views;
+		std::vector<State> states;
+	};
+	using StoragePtr = SharedPointer<Storage>;
+
+public:
+	template<bool reverse>
+	class IteratorT
+	{
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = SharedPointer<CView>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type*;
+		using reference = const value_type&;
+
+		IteratorT () = default;
+		IteratorT (const StoragePtr& storage, size_t index) : storage (storage), index (index) {}
+
+		reference operator* () const { return storage->views[position ()]; }
+		pointer operator-> () const { return &storage->views[position ()]; }
+		/** the visibility and size of the view at the time it was last reported */
+		const State& getState () const { return storage->states[position ()]; }
+		/** the index of the view in the list */
+		size_t position () const { return reverse ? index - 1 : index; }
+
+		IteratorT& operator++ ()
+		{
+			reverse ? --index : ++index;
+			return *this;
+		}
+		IteratorT operator++ (int)
+		{
+			auto old = *this;
+			++(*this);
+			return old;
+		}
+		IteratorT& operator-- ()
+		{
+			reverse ? ++index : --index;
+			return *this;
+		}
+		IteratorT operator-- (int)
+		{
+			auto old = *this;
+			--(*this);
+			return old;
+		}
+
+		/** only iterators of the same list or snapshot can be compared */
+		bool operator== (const IteratorT& other) const { return index == other.index; }
+		bool operator!= (const IteratorT& other) const { return !(*this == other); }
+
+	private:
+		StoragePtr storage;
+		size_t index {0};
+	};
+	using const_iterator = IteratorT<false>;
+	using const_reverse_iterator = IteratorT<true>;
+	using iterator = const_iterator;
+	using reverse_iterator = const_reverse_iterator;
+	using value_type = SharedPointer<CView>;
+	using reference = const value_type&;
+	using const_reference = const value_type&;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+
+	static constexpr size_t npos = static_cast<size_t> (-1);
+
+	/** the views of the list at the time the snapshot was taken */
+	class Snapshot
+	{
+	public:
+		Snapshot () = default;
+		explicit Snapshot (const StoragePtr& storage) : storage (storage) {}
+
+		const_iterator begin () const { return {storage, 0}; }
+		const_iterator end () const { return {storage, size ()}; }
+		const_reverse_iterator rbegin () const { return {storage, size ()}; }
+		const_reverse_iterator rend () const { return {storage, 0}; }
+
+		size_t size () const { return storage ? storage->views.size () : 0; }
+		bool empty () const { return size () == 0; }
+
+	private:
+		StoragePtr storage;
+	};
+
+	ChildViewList () : storage (makeOwned<Storage> ()) {}
+
+	const_iterator begin () const { return {storage, 0}; }
+	const_iterator end () const { return {storage, size ()}; }
+	const_reverse_iterator rbegin () const { return {storage, size ()}; }
+	const_reverse_iterator rend () const { return {storage, 0}; }
+	const_iterator cbegin () const { return begin (); }
+	const_iterator cend () const { return end (); }
+	const_reverse_iterator crbegin () const { return rbegin (); }
+	const_reverse_iterator crend () const { return rend (); }
+
+	/** the views as they are now, for iterating while the list may change */
+	Snapshot snapshot () const { return Snapshot (storage); }
+	/** the views as a std::list, built when the list changed since the last call */
+	const std::list<SharedPointer<CView>>& asList () const;
+
+	size_t size () const { return storage->views.size (); }
+	bool empty () const { return storage->views.empty (); }
+	const SharedPointer<CView>& operator[] (size_t index) const { return storage->views[index]; }
+	const SharedPointer<CView>& front () const { return storage->views.front (); }
+	const SharedPointer<CView>& back () const { return storage->views.back (); }
+	const State& getState (size_t index) const { return storage->states[index]; }
+
+	/** find the index of view, the search starts at hint
+	 *	@return the index or npos
+	 */
+	size_t find (const CView* view, size_t hint = 0) const;
+
+	void insert (size_t index, CView* view);
+	void erase (size_t index);
+	/** move the view at index from to index to */
+	void move (size_t from, size_t to);
+	/** update the visibility and size of the view at index */
+	void updateState (size_t index);
+	void updateStates ();
+
+private:
+	Storage& mutableStorage ();
+	void listChanged () { listValid = false; }
+
+	StoragePtr storage;
+	mutable std::list<SharedPointer<CView>> list;
+	mutable bool listValid {false};
+};
+
 //-----------------------------------------------------------------------------
 // CViewContainer Declaration
 //! @brief Container Class of CView objects
@@ -90,6 +251,19 @@ public:
 
 	virtual bool hitTestSubViews (const CPoint& where, const Event& event);
 
+	/** enable or disable the spatial index of the child views. Per default this is disabled.
+	 *
+	 *	With the index getViewAt, getViewsAt, getContainerAt, hitTestSubViews and drawRect only
+	 *	look at the children near the point or rect instead of all children, which is useful for
+	 *	containers with many children. The index is only used while the container is attached.
+	 *	Children must not answer hitTest or checkUpdate outside of their view size and mouseable
+	 *	area.
+	 */
+	void setSpatialIndexEnabled (bool state);
+	bool isSpatialIndexEnabled () const;
+	/** called by a child view when its view size, mouseable area or visibility changed */
+	void onChildViewChanged (CView* child);
+
 	/** enable or disable autosizing subviews. Per default this is enabled. */
 	virtual void setAutosizingEnabled (bool state);
 	bool getAutosizingEnabled () const { return hasViewFlag (kAutosizeSubviews); }
@@ -123,6 +297,14 @@ public:
 	CDrawStyle getBackgroundColorDrawStyle () const;
 	//@}
 
+	/** returns true if drawRect only draws into the parts of the draw region of the context.
+	 *
+	 *	A child container which does is drawn once with the bounding box of the parts, all others
+	 *	are drawn once per part. Default is true for CViewContainer only, as derived containers may
+	 *	draw more than the background and the children.
+	 */
+	virtual bool honorsDrawRegion () const;
+
 	virtual bool advanceNextFocusView (CView* oldFocus, bool reverse = false);
 	virtual bool invalidateDirtyViews ();
 	virtual CRect getVisibleSize (const CRect& rect) const;
@@ -136,6 +318,9 @@ public:
 	// CView
 	void draw (CDrawContext* pContext) override;
 	void drawRect (CDrawContext* pContext, const CRect& updateRect) override;
+	bool isOpaque () const override;
+	bool isDrawThreadSafe () const override;
+	bool prepareConcurrentDraw (CDrawContext* pContext, const CRect& updateRect) override;
 	void onMouseDownEvent (MouseDownEvent& event) override;
 	void onMouseMoveEvent (MouseMoveEvent& event) override;
 	void onMouseUpEvent (MouseUpEvent& event) override;
@@ -175,8 +360,8 @@ public:
 	CPoint& localToFrame (CPoint& point) const override;
 
 	//-----------------------------------------------------------------------------
-	using ChildViewConstIterator = ViewList::const_iterator;
-	using ChildViewConstReverseIterator = ViewList::const_reverse_iterator;
+	using ChildViewConstIterator = ChildViewList::const_iterator;
+	using ChildViewConstReverseIterator = ChildViewList::const_reverse_iterator;
 
 	//-----------------------------------------------------------------------------
 	template<bool reverse>
@@ -186,20 +371,28 @@ public:
 		using IteratorType = typename std::conditional<reverse, ChildViewConstReverseIterator,
 													   ChildViewConstIterator>::type;
 
-		explicit Iterator (const CViewContainer* container) : children (container->getChildren ())
+		explicit Iterator (const CViewContainer* container)
+		: children (container->getChildViews ().snapshot ())
 		{
 			if constexpr (reverse)
+			{
 				iterator = children.rbegin ();
+				end = children.rend ();
+			}
 			else
+			{
 				iterator = children.begin ();
+				end = children.end ();
+			}
 		}
 
 		explicit Iterator (const Iterator<reverse>& vi)
-		: children (vi.children), iterator (vi.iterator)
+		: children (vi.children), iterator (vi.iterator), end (vi.end)
 		{
 		}
 
-		Iterator (Iterator<reverse>&& o) : children (o.children), iterator (std::move (o.iterator))
+		Iterator (Iterator<reverse>&& o)
+		: children (std::move (o.children)), iterator (o.iterator), end (o.end)
 		{
 		}
 
@@ -224,15 +417,14 @@ public:
 		
 		CView* operator* () const
 		{
-			if constexpr (reverse)
-				return (iterator == children.rend ()) ? nullptr : *iterator;
-			else
-				return (iterator == children.end ()) ? nullptr : *iterator;
+			return (iterator == end) ? nullptr : *iterator;
 		}
 		
 	protected:
-		const ViewList& children;
+		// the views can be removed while they are iterated
+		ChildViewList::Snapshot children;
 		IteratorType iterator;
+		IteratorType end;
 	};
 
 	//-------------------------------------------
@@ -255,10 +447,19 @@ protected:
 	void beforeDelete () override;
 	
 	virtual bool checkUpdateRect (CView* view, const CRect& rect);
+	/** returns true if the background fills the view size with an opaque color.
+	 *
+	 *	isOpaque only reports this for CViewContainer itself, derived containers which draw nothing
+	 *	besides the background and the children can use it to opt in.
+	 */
+	bool hasOpaqueBackground () const;
 
 	void setMouseDownView (CView* view);
 	CView* getMouseDownView () const;
 	
+	/** the child views in drawing order */
+	const ChildViewList& getChildViews () const;
+	/** the child views as a std::list, kept for compatibility. Prefer getChildViews */
 	const ViewList& getChildren () const;
 private:
 	void dispatchEventToSubViews (Event& event);
@@ -278,7 +479,7 @@ using ReverseViewIterator = CViewContainer::Iterator<true>;
 template<class ViewClass, class ContainerClass>
 inline uint32_t CViewContainer::getChildViewsOfType (ContainerClass& result, bool deep) const
 {
-	for (auto& child : getChildren ())
+	for (auto& child : getChildViews ())
 	{
 		auto vObj = child.cast<ViewClass> ();
 		if (vObj)
@@ -300,7 +501,7 @@ inline uint32_t CViewContainer::getChildViewsOfType (ContainerClass& result, boo
 template <typename Proc>
 inline void CViewContainer::forEachChild (Proc proc) const
 {
-	for (auto& child : getChildren ())
+	for (auto& child : getChildViews ())
 	{
 		proc (child);
 	}
@@ -4,6 +4,30 @@
 
 #include "pixelbuffer.h"
 #include "vstguibase.h"
+#include "workerpool.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define VSTGUI_PIXELBUFFER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VSTGUI_PIXELBUFFER_SSE2 1
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define VSTGUI_PIXELBUFFER_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#else
+#define VSTGUI_PIXELBUFFER_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define VSTGUI_PIXELBUFFER_NEON 1
+#include <arm_neon.h>
+#endif
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -51,129 +75,421 @@ inline uint32_t shuffle (uint32_t input)
 #pragma warning(pop)
 #endif
 
+#if VSTGUI_PIXELBUFFER_SSE2
 //------------------------------------------------------------------------
-template<Format SourceFormat, Format DestinationFormat>
-inline void convert (uint8_t* buffer, uint32_t bytesPerRow, uint32_t width, uint32_t height)
+template<int32_t shift>
+inline __m128i shiftRight (__m128i input)
 {
-	for (auto y = 0u; y < height; ++y, buffer += bytesPerRow)
+	if constexpr (shift >= 0)
+		return _mm_srli_epi32 (input, shift);
+	else
+		return _mm_slli_epi32 (input, -shift);
+}
+
+//------------------------------------------------------------------------
+/** the same as shuffle for four pixels, x86 is always little endian */
+template<int8_t bs1, int8_t bs2, int8_t bs3, int8_t bs4>
+inline __m128i shuffle (__m128i input)
+{
+	auto b1 = _mm_and_si128 (input, _mm_set1_epi32 (static_cast<int32_t> (0xFF000000u)));
+	auto b2 = _mm_and_si128 (input, _mm_set1_epi32 (0x00FF0000));
+	auto b3 = _mm_and_si128 (input, _mm_set1_epi32 (0x0000FF00));
+	auto b4 = _mm_and_si128 (input, _mm_set1_epi32 (0x000000FF));
+
+	b1 = shiftRight<bs4 * 8> (b1);
+	b2 = shiftRight<bs3 * 8> (b2);
+	b3 = shiftRight<bs2 * 8> (b3);
+	b4 = shiftRight<bs1 * 8> (b4);
+
+	return _mm_or_si128 (_mm_or_si128 (b1, b2), _mm_or_si128 (b3, b4));
+}
+#endif
+
+//------------------------------------------------------------------------
+template<Format SourceFormat, Format DestinationFormat, typename Pixel>
+inline Pixel convertPixel (Pixel pixel)
+{
+	switch (SourceFormat)
 	{
-		auto intPtr = reinterpret_cast<uint32_t*> (buffer);
-		for (auto x = 0u; x < width; ++x, ++intPtr)
+		case Format::ARGB:
 		{
-			auto pixel = *intPtr;
-			switch (SourceFormat)
+			switch (DestinationFormat)
 			{
 				case Format::ARGB:
 				{
-					switch (DestinationFormat)
-					{
-						case Format::ARGB:
-						{
-							// nothing to do
-							break;
-						}
-						case Format::ABGR:
-						{
-							*intPtr = shuffle<-2, 0, 2, 0> (pixel);
-							break;
-						}
-						case Format::BGRA:
-						{
-							*intPtr = shuffle<-3, -1, 1, 3> (pixel);
-							break;
-						}
-						case Format::RGBA:
-						{
-							*intPtr = shuffle<-1, -1, -1, 3> (pixel);
-							break;
-						}
-					}
+					// nothing to do
 					break;
 				}
 				case Format::ABGR:
 				{
-					switch (DestinationFormat)
-					{
-						case Format::ARGB:
-						{
-							*intPtr = shuffle<-2, 0, 2, 0> (pixel);
-							break;
-						}
-						case Format::ABGR:
-						{
-							// nothing to do
-							break;
-						}
-						case Format::BGRA:
-						{
-							*intPtr = shuffle<-1, -1, -1, 3> (pixel);
-							break;
-						}
-						case Format::RGBA:
-						{
-							*intPtr = shuffle<-3, -1, 1, 3> (pixel);
-							break;
-						}
-					}
+					return shuffle<-2, 0, 2, 0> (pixel);
+				}
+				case Format::BGRA:
+				{
+					return shuffle<-3, -1, 1, 3> (pixel);
+				}
+				case Format::RGBA:
+				{
+					return shuffle<-1, -1, -1, 3> (pixel);
+				}
+			}
+			break;
+		}
+		case Format::ABGR:
+		{
+			switch (DestinationFormat)
+			{
+				case Format::ARGB:
+				{
+					return shuffle<-2, 0, 2, 0> (pixel);
+				}
+				case Format::ABGR:
+				{
+					// nothing to do
 					break;
 				}
+				case Format::BGRA:
+				{
+					return shuffle<-1, -1, -1, 3> (pixel);
+				}
 				case Format::RGBA:
 				{
-					switch (DestinationFormat)
-					{
-						case Format::ARGB:
-						{
-							*intPtr = shuffle<-1, -1, -1, 3> (pixel);
-							break;
-						}
-						case Format::ABGR:
-						{
-							*intPtr = shuffle<-3, -1, 1, 3> (pixel);
-							break;
-						}
-						case Format::BGRA:
-						{
-							*intPtr = shuffle<-2, 0, 2, 0> (pixel);
-							break;
-						}
-						case Format::RGBA:
-						{
-							// nothing to do
-							break;
-						}
-					}
+					return shuffle<-3, -1, 1, 3> (pixel);
+				}
+			}
+			break;
+		}
+		case Format::RGBA:
+		{
+			switch (DestinationFormat)
+			{
+				case Format::ARGB:
+				{
+					return shuffle<-1, -1, -1, 3> (pixel);
+				}
+				case Format::ABGR:
+				{
+					return shuffle<-3, -1, 1, 3> (pixel);
+				}
+				case Format::BGRA:
+				{
+					return shuffle<-2, 0, 2, 0> (pixel);
+				}
+				case Format::RGBA:
+				{
+					// nothing to do
 					break;
 				}
+			}
+			break;
+		}
+		case Format::BGRA:
+		{
+			switch (DestinationFormat)
+			{
+				case Format::ARGB:
+				{
+					return shuffle<-3, -1, 1, 3> (pixel);
+				}
+				case Format::ABGR:
+				{
+					return shuffle<-1, -1, -1, 3> (pixel);
+				}
 				case Format::BGRA:
 				{
-					switch (DestinationFormat)
-					{
-						case Format::ARGB:
-						{
-							*intPtr = shuffle<-3, -1, 1, 3> (pixel);
-							break;
-						}
-						case Format::ABGR:
-						{
-							*intPtr = shuffle<-1, -1, -1, 3> (pixel);
-							break;
-						}
-						case Format::BGRA:
-						{
-							// nothing to do
-							break;
-						}
-						case Format::RGBA:
-						{
-							*intPtr = shuffle<0, -2, 0, 2> (pixel);
-							break;
-						}
-					}
+					// nothing to do
 					break;
 				}
+				case Format::RGBA:
+				{
+					return shuffle<0, -2, 0, 2> (pixel);
+				}
 			}
+			break;
 		}
 	}
+	return pixel;
+}
+
+//------------------------------------------------------------------------
+/** the index of the source byte for each destination byte of a pixel in memory */
+using ByteMask = std::array<uint8_t, 4>;
+
+//------------------------------------------------------------------------
+template<Format SourceFormat, Format DestinationFormat>
+inline ByteMask makeByteMask ()
+{
+	// convert a pixel which has its byte indices as values
+	ByteMask mask {{0, 1, 2, 3}};
+	uint32_t pixel;
+	std::memcpy (&pixel, mask.data (), sizeof (pixel));
+	pixel = convertPixel<SourceFormat, DestinationFormat> (pixel);
+	std::memcpy (mask.data (), &pixel, sizeof (pixel));
+	return mask;
+}
+
+//------------------------------------------------------------------------
+/** converts the first pixels of a row and returns the number of pixels converted */
+using RowConverter = uint32_t (*) (uint8_t* row, uint32_t width, const ByteMask& mask);
+
+#if VSTGUI_PIXELBUFFER_SSE2
+//------------------------------------------------------------------------
+template<Format SourceFormat, Format DestinationFormat>
+uint32_t convertRowSSE2 (uint8_t* row, uint32_t width, const ByteMask&)
+{
+	// SSE2 has no byte shuffle, so the shifts of the scalar version are done on four pixels
+	uint32_t x = 0;
+	for (; x + 4 <= width; x += 4, row += 16)
+	{
+		auto pixels = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (row));
+		_mm_storeu_si128 (reinterpret_cast<__m128i*> (row),
+						  convertPixel<SourceFormat, DestinationFormat> (pixels));
+	}
+	return x;
+}
+#endif
+
+#if VSTGUI_PIXELBUFFER_X86
+//------------------------------------------------------------------------
+VSTGUI_PIXELBUFFER_TARGET_AVX2 uint32_t convertRowAVX2 (uint8_t* row, uint32_t width,
+														const ByteMask& mask)
+{
+	alignas (32) uint8_t shuffleBytes[32];
+	for (auto i = 0u; i < 32u; ++i)
+		shuffleBytes[i] = static_cast<uint8_t> ((i & 0xC) + mask[i & 3]);
+	auto shuffleMask = _mm256_load_si256 (reinterpret_cast<const __m256i*> (shuffleBytes));
+	uint32_t x = 0;
+	for (; x + 8 <= width; x += 8, row += 32)
+	{
+		auto pixels = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (row));
+		_mm256_storeu_si256 (reinterpret_cast<__m256i*> (row),
+							 _mm256_shuffle_epi8 (pixels, shuffleMask));
+	}
+	return x;
+}
+
+//------------------------------------------------------------------------
+bool hasAVX2 ()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid (info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid (info, 1);
+	constexpr int osxsaveAndAVX = (1 << 27) | (1 << 28);
+	if ((info[2] & osxsaveAndAVX) != osxsaveAndAVX || (_xgetbv (0) & 6) != 6)
+		return false;
+	__cpuidex (info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports ("avx2");
+#endif
+}
+#endif
+
+#if VSTGUI_PIXELBUFFER_NEON
+//------------------------------------------------------------------------
+uint32_t convertRowNEON (uint8_t* row, uint32_t width, const ByteMask& mask)
+{
+	uint8_t shuffleBytes[16];
+	for (auto i = 0u; i < 16u; ++i)
+		shuffleBytes[i] = static_cast<uint8_t> ((i & 0xC) + mask[i & 3]);
+	auto shuffleMask = vld1q_u8 (shuffleBytes);
+	uint32_t x = 0;
+	for (; x + 4 <= width; x += 4, row += 16)
+		vst1q_u8 (row, vqtbl1q_u8 (vld1q_u8 (row), shuffleMask));
+	return x;
+}
+#endif
+
+//------------------------------------------------------------------------
+template<Format SourceFormat, Format DestinationFormat>
+RowConverter getRowConverter ()
+{
+	static const RowConverter rowConverter = [] () -> RowConverter {
+#if VSTGUI_PIXELBUFFER_X86
+		if (hasAVX2 ())
+			return convertRowAVX2;
+#endif
+#if VSTGUI_PIXELBUFFER_SSE2
+		return convertRowSSE2<SourceFormat, DestinationFormat>;
+#elif VSTGUI_PIXELBUFFER_NEON
+		return convertRowNEON;
+#else
+		return nullptr;
+#endif
+	}();
+	return rowConverter;
+}
+
+//------------------------------------------------------------------------
+/** call processRows (rows, numRows) for blocks of rows which are processed concurrently */
+template<typename Proc>
+inline void processRowBlocks (uint8_t* buffer, uint32_t bytesPerRow, uint32_t width,
+							  uint32_t height, Proc processRows)
+{
+	auto& pool = WorkerPool::instance ();
+	auto numBlocks = std::min (pool.numJobsForPixels (static_cast<uint64_t> (width) * height), height);
+	pool.perform (numBlocks, [&] (uint32_t block) {
+		auto firstRow = static_cast<uint32_t> (static_cast<uint64_t> (height) * block / numBlocks);
+		auto endRow = static_cast<uint32_t> (static_cast<uint64_t> (height) * (block + 1) / numBlocks);
+		processRows (buffer + static_cast<size_t> (firstRow) * bytesPerRow, endRow - firstRow);
+	});
+}
+
+//------------------------------------------------------------------------
+template<Format SourceFormat, Format DestinationFormat>
+inline void convert (uint8_t* buffer, uint32_t bytesPerRow, uint32_t width, uint32_t height)
+{
+	auto mask = makeByteMask<SourceFormat, DestinationFormat> ();
+	auto rowConverter = getRowConverter<SourceFormat, DestinationFormat> ();
+	processRowBlocks (buffer, bytesPerRow, width, height, [=] (uint8_t* rows, uint32_t numRows) {
+		for (auto y = 0u; y < numRows; ++y, rows += bytesPerRow)
+		{
+			auto x = rowConverter ? rowConverter (rows, width, mask) : 0u;
+			auto intPtr = reinterpret_cast<uint32_t*> (rows) + x;
+			for (; x < width; ++x, ++intPtr)
+				*intPtr = convertPixel<SourceFormat, DestinationFormat> (*intPtr);
+		}
+	});
+}
+
+//------------------------------------------------------------------------
+inline uint32_t getAlphaIndex (Format format)
+{
+	switch (format)
+	{
+		case Format::ARGB:
+		case Format::ABGR:
+			return 0;
+		case Format::RGBA:
+		case Format::BGRA:
+			return 3;
+	}
+	return 3;
+}
+
+//------------------------------------------------------------------------
+/** round (value / 255) for values up to 255 * 255 */
+inline uint32_t divideBy255 (uint32_t value)
+{
+	value += 128;
+	return (value + (value >> 8)) >> 8;
+}
+
+//------------------------------------------------------------------------
+inline void premultiplyPixel (uint8_t* pixel, uint32_t alphaIndex)
+{
+	uint32_t alpha = pixel[alphaIndex];
+	for (auto i = 0u; i < 4u; ++i)
+	{
+		if (i != alphaIndex)
+			pixel[i] = static_cast<uint8_t> (divideBy255 (pixel[i] * alpha));
+	}
+}
+
+//------------------------------------------------------------------------
+inline void unpremultiplyPixel (uint8_t* pixel, uint32_t alphaIndex)
+{
+	uint32_t alpha = pixel[alphaIndex];
+	if (alpha == 0)
+		return;
+	for (auto i = 0u; i < 4u; ++i)
+	{
+		// round (color * 255 / alpha)
+		if (i != alphaIndex)
+			pixel[i] = static_cast<uint8_t> (
+				std::min<uint32_t> ((pixel[i] * 510u + alpha) / (alpha * 2u), 255u));
+	}
+}
+
+#if VSTGUI_PIXELBUFFER_SSE2
+//------------------------------------------------------------------------
+uint32_t premultiplyRowSSE2 (uint8_t* row, uint32_t width, uint32_t alphaIndex)
+{
+	auto zero = _mm_setzero_si128 ();
+	auto alphaMask = _mm_set1_epi32 (static_cast<int32_t> (0xFFu << (alphaIndex * 8)));
+	auto rounding = _mm_set1_epi16 (128);
+	uint32_t x = 0;
+	for (; x + 4 <= width; x += 4, row += 16)
+	{
+		auto pixels = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (row));
+		__m128i halfs[2] = {_mm_unpacklo_epi8 (pixels, zero), _mm_unpackhi_epi8 (pixels, zero)};
+		for (auto& half : halfs)
+		{
+			// every 16 bit lane of a pixel gets its alpha
+			__m128i alpha;
+			if (alphaIndex == 0)
+				alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (half, 0x00), 0x00);
+			else
+				alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (half, 0xFF), 0xFF);
+			auto value = _mm_add_epi16 (_mm_mullo_epi16 (half, alpha), rounding);
+			half = _mm_srli_epi16 (_mm_add_epi16 (value, _mm_srli_epi16 (value, 8)), 8);
+		}
+		auto result = _mm_packus_epi16 (halfs[0], halfs[1]);
+		result = _mm_or_si128 (_mm_andnot_si128 (alphaMask, result),
+							   _mm_and_si128 (alphaMask, pixels));
+		_mm_storeu_si128 (reinterpret_cast<__m128i*> (row), result);
+	}
+	return x;
+}
+
+//------------------------------------------------------------------------
+uint32_t unpremultiplyRowSSE2 (uint8_t* row, uint32_t width, uint32_t alphaIndex)
+{
+	auto zero = _mm_setzero_si128 ();
+	auto alphaMask = _mm_set1_epi32 (static_cast<int32_t> (0xFFu << (alphaIndex * 8)));
+	auto maxValue = _mm_set1_ps (255.f);
+	auto half = _mm_set1_ps (0.5f);
+	uint32_t x = 0;
+	for (; x + 4 <= width; x += 4, row += 16)
+	{
+		auto pixels = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (row));
+		auto low = _mm_unpacklo_epi8 (pixels, zero);
+		auto high = _mm_unpackhi_epi8 (pixels, zero);
+		// one pixel per vector with the channels as 32 bit lanes
+		__m128i channels[4] = {_mm_unpacklo_epi16 (low, zero), _mm_unpackhi_epi16 (low, zero),
+							   _mm_unpacklo_epi16 (high, zero), _mm_unpackhi_epi16 (high, zero)};
+		for (auto& pixel : channels)
+		{
+			auto color = _mm_cvtepi32_ps (pixel);
+			auto alpha = alphaIndex == 0 ? _mm_shuffle_ps (color, color, 0x00)
+										 : _mm_shuffle_ps (color, color, 0xFF);
+			// the division is exact enough to round like the scalar version
+			auto value = _mm_add_ps (_mm_div_ps (_mm_mul_ps (color, maxValue), alpha), half);
+			value = _mm_min_ps (value, maxValue);
+			auto zeroAlpha = _mm_castps_si128 (_mm_cmpeq_ps (alpha, _mm_setzero_ps ()));
+			pixel = _mm_or_si128 (_mm_andnot_si128 (zeroAlpha, _mm_cvttps_epi32 (value)),
+								  _mm_and_si128 (zeroAlpha, pixel));
+		}
+		auto result = _mm_packus_epi16 (_mm_packs_epi32 (channels[0], channels[1]),
+										_mm_packs_epi32 (channels[2], channels[3]));
+		result = _mm_or_si128 (_mm_andnot_si128 (alphaMask, result),
+							   _mm_and_si128 (alphaMask, pixels));
+		_mm_storeu_si128 (reinterpret_cast<__m128i*> (row), result);
+	}
+	return x;
+}
+#endif
+
+//------------------------------------------------------------------------
+using AlphaRowProc = uint32_t (*) (uint8_t* row, uint32_t width, uint32_t alphaIndex);
+using AlphaPixelProc = void (*) (uint8_t* pixel, uint32_t alphaIndex);
+
+//------------------------------------------------------------------------
+inline void processAlpha (AlphaRowProc rowProc, AlphaPixelProc pixelProc, Format format,
+						  uint8_t* buffer, uint32_t bytesPerRow, uint32_t width, uint32_t height)
+{
+	auto alphaIndex = getAlphaIndex (format);
+	processRowBlocks (buffer, bytesPerRow, width, height, [=] (uint8_t* rows, uint32_t numRows) {
+		for (auto y = 0u; y < numRows; ++y, rows += bytesPerRow)
+		{
+			auto x = rowProc ? rowProc (rows, width, alphaIndex) : 0u;
+			for (auto pixel = rows + x * 4; x < width; ++x, pixel += 4)
+				pixelProc (pixel, alphaIndex);
+		}
+	});
 }
 
 //------------------------------------------------------------------------
@@ -284,6 +600,32 @@ void convert (Format srcFormat, Format dstFormat, uint8_t* buffer, uint32_t byte
 	}
 }
 
+//------------------------------------------------------------------------
+void premultiplyAlpha (Format format, uint8_t* buffer, uint32_t bytesPerRow, uint32_t width,
+					   uint32_t height)
+{
+	using namespace Private;
+#if VSTGUI_PIXELBUFFER_SSE2
+	AlphaRowProc rowProc = premultiplyRowSSE2;
+#else
+	AlphaRowProc rowProc = nullptr;
+#endif
+	processAlpha (rowProc, premultiplyPixel, format, buffer, bytesPerRow, width, height);
+}
+
+//------------------------------------------------------------------------
+void unpremultiplyAlpha (Format format, uint8_t* buffer, uint32_t bytesPerRow, uint32_t width,
+						 uint32_t height)
+{
+	using namespace Private;
+#if VSTGUI_PIXELBUFFER_SSE2
+	AlphaRowProc rowProc = unpremultiplyRowSSE2;
+#else
+	AlphaRowProc rowProc = nullptr;
+#endif
+	processAlpha (rowProc, unpremultiplyPixel, format, buffer, bytesPerRow, width, height);
+}
+
 //------------------------------------------------------------------------
 } // PixelBuffer
 } // VSTGUI
@@ -32,6 +32,33 @@ enum class Format
 void convert (Format srcFormat, Format dstFormat, uint8_t* buffer, uint32_t bytesPerRow,
 			  uint32_t width, uint32_t height);
 
+//------------------------------------------------------------------------
+/** Multiply the color channels of a buffer of 32 bit pixels with their alpha
+ *
+ *	@param format Pixel Format
+ *	@param buffer Pixel Buffer
+ *	@param bytesPerRow Number of bytes per row in buffer
+ *	@param width Number of pixels per row
+ *	@param height Number of rows
+ */
+void premultiplyAlpha (Format format, uint8_t* buffer, uint32_t bytesPerRow, uint32_t width,
+					   uint32_t height);
+
+//------------------------------------------------------------------------
+/** Divide the color channels of a buffer of 32 bit pixels by their alpha
+ *
+ *	Pixels with zero alpha are not changed. Premultiplying the result again restores the
+ *	original pixels, as long as no color channel is larger than the alpha channel.
+ *
+ *	@param format Pixel Format
+ *	@param buffer Pixel Buffer
+ *	@param bytesPerRow Number of bytes per row in buffer
+ *	@param width Number of pixels per row
+ *	@param height Number of rows
+ */
+void unpremultiplyAlpha (Format format, uint8_t* buffer, uint32_t bytesPerRow, uint32_t width,
+						 uint32_t height);
+
 //------------------------------------------------------------------------
 } // PixelBuffer
 } // VSTGUI
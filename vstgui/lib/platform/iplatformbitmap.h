@@ -19,6 +19,14 @@ public:
 	virtual const CPoint& getSize () const = 0;
 
 	virtual SharedPointer<IPlatformBitmapPixelAccess> lockPixels (bool alphaPremultiplied) = 0;
+	/** like lockPixels, but the accessor may only convert the pixels of the rows passed to its
+	 *	prepareRows. Only for callers which call prepareRows before they access a row, rows which
+	 *	were not prepared are neither valid nor written back on unlock.
+	 */
+	virtual SharedPointer<IPlatformBitmapPixelAccess> lockPixelsOnDemand (bool alphaPremultiplied)
+	{
+		return lockPixels (alphaPremultiplied);
+	}
 
 	virtual void setScaleFactor (double factor) = 0;
 	virtual double getScaleFactor () const = 0;
@@ -39,6 +47,11 @@ public:
 	virtual uint8_t* getAddress () const = 0;
 	virtual uint32_t getBytesPerRow () const = 0;
 	virtual PixelFormat getPixelFormat () const = 0;
+	/** accessors created by IPlatformBitmap::lockPixelsOnDemand make the rows [firstRow, endRow)
+	 *	valid at getAddress. Can be called on several threads for different rows at the same time.
+	 *	Accessors created by lockPixels are valid for all rows and ignore it.
+	 */
+	virtual void prepareRows (uint32_t firstRow, uint32_t endRow) {}
 };
 
 } // VSTGUI
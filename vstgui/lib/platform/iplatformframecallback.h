@@ -7,6 +7,8 @@
 /// @cond ignore
 
 #include "../vstguifwd.h"
+#include "../crect.h"
+#include <vector>
 
 struct VstKeyCode;
 
@@ -31,6 +33,22 @@ class IPlatformFrameCallback
 {
 public:
 	virtual bool platformDrawRect (CDrawContext* context, const CRect& rect) = 0;
+	/** draw all dirty rects in one pass. The default draws them one after the other. */
+	virtual bool platformDrawRects (CDrawContext* context, const std::vector<CRect>& rects)
+	{
+		bool result = false;
+		for (const auto& rect : rects)
+			result |= platformDrawRect (context, rect);
+		return result;
+	}
+	/** prepare the views in rect to be drawn with platformDrawRect on a worker thread.
+	 *	Called on the main thread with the context which draws the other rects.
+	 *	@return false if rect must be drawn on the main thread, which the default always returns
+	 */
+	virtual bool platformPrepareConcurrentDraw (CDrawContext* context, const CRect& rect)
+	{
+		return false;
+	}
 	
 	virtual void platformOnEvent (Event& event) = 0;
 
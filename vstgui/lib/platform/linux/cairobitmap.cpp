@@ -4,8 +4,11 @@
 
 #include "../../cpoint.h"
 #include "../../cresourcedescription.h"
+#include "../../pixelbuffer.h"
 #include "linuxfactory.h"
 #include "cairobitmap.h"
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -103,11 +106,30 @@ class PixelAccess : public IPlatformBitmapPixelAccess
 public:
 	~PixelAccess () override;
 
-	bool init (Bitmap* bitmap, const SurfaceHandle& surface);
+	/** if onDemand is false, all rows are converted to straight alpha at once */
+	bool init (Bitmap* bitmap, const SurfaceHandle& surface, bool alphaPremultiplied,
+			   bool onDemand);
 
 private:
+	/** call proc (firstRow, endRow) for the ranges of consecutive prepared rows */
+	template<typename Proc>
+	void forEachPreparedRange (uint32_t firstRow, uint32_t endRow, bool prepared, Proc proc) const;
+
 	uint8_t* address {nullptr};
 	uint32_t bytesPerRow {0};
+	uint32_t width {0};
+	uint32_t height {0};
+
+	/** the pixels with straight alpha if the bitmap was not locked with premultiplied alpha
+	 *
+	 *	A row is unpremultiplied from the surface when it is prepared, which lockPixels does for all
+	 *	rows. Only the prepared rows are premultiplied back into the surface on unlock, the others
+	 *	keep their pixels untouched.
+	 */
+	std::unique_ptr<uint8_t[]> straightPixels;
+	std::vector<uint8_t> preparedRows;
+
+	void prepareRows (uint32_t firstRow, uint32_t endRow) override;
 
 	uint8_t* getAddress () const override { return address; }
 	uint32_t getBytesPerRow () const override { return bytesPerRow; }
@@ -201,6 +223,7 @@ bool Bitmap::load (const CResourceDescription& desc)
 				return false;
 			}
 			surface = s;
+			invalidateCache ();
 			size.x = cairo_image_surface_get_width (surface);
 			size.y = cairo_image_surface_get_height (surface);
 			return true;
@@ -217,12 +240,29 @@ const CPoint& Bitmap::getSize () const
 //-----------------------------------------------------------------------------
 SharedPointer<IPlatformBitmapPixelAccess> Bitmap::lockPixels (bool alphaPremultiplied)
 {
-	if (locked)
-		return nullptr;
-#warning TODO: alphaPremultiplied is currently ignored, always treated as true
-	locked = true;
+	return lock (alphaPremultiplied, false);
+}
+
+//-----------------------------------------------------------------------------
+SharedPointer<IPlatformBitmapPixelAccess> Bitmap::lockPixelsOnDemand (bool alphaPremultiplied)
+{
+	return lock (alphaPremultiplied, true);
+}
+
+//-----------------------------------------------------------------------------
+SharedPointer<IPlatformBitmapPixelAccess> Bitmap::lock (bool alphaPremultiplied, bool onDemand)
+{
+	{
+		// getPattern checks the flag under the same mutex, so it does not cache a pattern
+		// of pixels which are written now
+		std::lock_guard<std::mutex> guard (cacheMutex);
+		if (locked)
+			return nullptr;
+		locked = true;
+		patternCache.clear ();
+	}
 	auto pixelAccess = owned (new CairoBitmapPrivate::PixelAccess ());
-	if (pixelAccess->init (this, surface))
+	if (pixelAccess->init (this, surface, alphaPremultiplied, onDemand))
 		return pixelAccess;
 	return nullptr;
 }
@@ -230,7 +270,10 @@ SharedPointer<IPlatformBitmapPixelAccess> Bitmap::lockPixels (bool alphaPremulti
 //-----------------------------------------------------------------------------
 void Bitmap::setScaleFactor (double factor)
 {
+	if (scaleFactor == factor)
+		return;
 	scaleFactor = factor;
+	invalidateCache ();
 }
 
 //-----------------------------------------------------------------------------
@@ -239,6 +282,37 @@ double Bitmap::getScaleFactor () const
 	return scaleFactor;
 }
 
+//-----------------------------------------------------------------------------
+PatternHandle Bitmap::getPattern (cairo_filter_t filter) const
+{
+	vstgui_assert (!locked, "Bitmap is locked");
+	if (locked || !surface)
+		return {};
+	std::lock_guard<std::mutex> guard (cacheMutex);
+	// the pixels may have been locked since the check above
+	if (locked)
+		return {};
+	for (const auto& entry : patternCache)
+	{
+		if (entry.filter == filter)
+			return entry.pattern;
+	}
+	PatternHandle pattern (cairo_pattern_create_for_surface (surface));
+	cairo_matrix_t matrix;
+	cairo_matrix_init_scale (&matrix, scaleFactor, scaleFactor);
+	cairo_pattern_set_matrix (pattern, &matrix);
+	cairo_pattern_set_filter (pattern, filter);
+	patternCache.push_back ({filter, pattern});
+	return pattern;
+}
+
+//-----------------------------------------------------------------------------
+void Bitmap::invalidateCache ()
+{
+	std::lock_guard<std::mutex> guard (cacheMutex);
+	patternCache.clear ();
+}
+
 //-----------------------------------------------------------------------------
 PNGBitmapBuffer Bitmap::createMemoryPNGRepresentation () const
 {
@@ -250,8 +324,10 @@ PNGBitmapBuffer Bitmap::createMemoryPNGRepresentation () const
 namespace CairoBitmapPrivate {
 
 //-----------------------------------------------------------------------------
-bool PixelAccess::init (Bitmap* inBitmap, const SurfaceHandle& inSurface)
+bool PixelAccess::init (Bitmap* inBitmap, const SurfaceHandle& inSurface,
+						bool alphaPremultiplied, bool onDemand)
 {
+	bitmap = inBitmap;
 	cairo_surface_flush (inSurface);
 	address = cairo_image_surface_get_data (inSurface);
 	if (!address)
@@ -267,16 +343,76 @@ bool PixelAccess::init (Bitmap* inBitmap, const SurfaceHandle& inSurface)
 		return false;
 	}
 	surface = inSurface;
-	bitmap = inBitmap;
 	bytesPerRow = cairo_image_surface_get_stride (surface);
+	width = static_cast<uint32_t> (cairo_image_surface_get_width (surface));
+	height = static_cast<uint32_t> (cairo_image_surface_get_height (surface));
+	if (!alphaPremultiplied && cairo_image_surface_get_format (surface) == CAIRO_FORMAT_ARGB32)
+	{
+		straightPixels.reset (new uint8_t[static_cast<size_t> (bytesPerRow) * height]);
+		preparedRows.assign (height, false);
+		address = straightPixels.get ();
+		if (!onDemand)
+			prepareRows (0, height);
+	}
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+template<typename Proc>
+void PixelAccess::forEachPreparedRange (uint32_t firstRow, uint32_t endRow, bool prepared,
+										Proc proc) const
+{
+	while (firstRow < endRow)
+	{
+		while (firstRow < endRow && static_cast<bool> (preparedRows[firstRow]) != prepared)
+			++firstRow;
+		auto rangeEnd = firstRow;
+		while (rangeEnd < endRow && static_cast<bool> (preparedRows[rangeEnd]) == prepared)
+			++rangeEnd;
+		if (firstRow < rangeEnd)
+			proc (firstRow, rangeEnd);
+		firstRow = rangeEnd;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void PixelAccess::prepareRows (uint32_t firstRow, uint32_t endRow)
+{
+	if (!straightPixels)
+		return;
+	endRow = std::min (endRow, height);
+	auto format = static_cast<PixelBuffer::Format> (getPixelFormat ());
+	auto surfacePixels = cairo_image_surface_get_data (surface);
+	forEachPreparedRange (firstRow, endRow, false, [&] (uint32_t first, uint32_t end) {
+		auto offset = static_cast<size_t> (first) * bytesPerRow;
+		std::memcpy (straightPixels.get () + offset, surfacePixels + offset,
+					 static_cast<size_t> (end - first) * bytesPerRow);
+		PixelBuffer::unpremultiplyAlpha (format, straightPixels.get () + offset, bytesPerRow,
+										 width, end - first);
+		std::fill (preparedRows.begin () + first, preparedRows.begin () + end, true);
+	});
+}
+
 //-----------------------------------------------------------------------------
 PixelAccess::~PixelAccess ()
 {
-	cairo_surface_mark_dirty (surface);
-	bitmap->unlock ();
+	if (straightPixels)
+	{
+		auto format = static_cast<PixelBuffer::Format> (getPixelFormat ());
+		auto surfacePixels = cairo_image_surface_get_data (surface);
+		// premultiplying restores the pixels of rows which were only read exactly
+		forEachPreparedRange (0, height, true, [&] (uint32_t first, uint32_t end) {
+			auto offset = static_cast<size_t> (first) * bytesPerRow;
+			PixelBuffer::premultiplyAlpha (format, straightPixels.get () + offset, bytesPerRow,
+										   width, end - first);
+			std::memcpy (surfacePixels + offset, straightPixels.get () + offset,
+						 static_cast<size_t> (end - first) * bytesPerRow);
+		});
+	}
+	if (surface)
+		cairo_surface_mark_dirty (surface);
+	if (bitmap)
+		bitmap->unlock ();
 }
 
 //-----------------------------------------------------------------------------
@@ -11,7 +11,10 @@
 #include "../iplatformbitmap.h"
 #include "../platformfwd.h"
 #include "cairoutils.h"
+#include <atomic>
 #include <functional>
+#include <mutex>
+#include <vector>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -32,6 +35,7 @@ public:
 	bool load (const CResourceDescription& desc);
 	const CPoint& getSize () const override;
 	SharedPointer<IPlatformBitmapPixelAccess> lockPixels (bool alphaPremultiplied) override;
+	SharedPointer<IPlatformBitmapPixelAccess> lockPixelsOnDemand (bool alphaPremultiplied) override;
 	void setScaleFactor (double factor) override;
 	double getScaleFactor () const override;
 
@@ -48,13 +52,34 @@ public:
 		return surface;
 	}
 
+	/** returns a pattern which draws the bitmap scaled by its scale factor
+	 *
+	 *	The pattern is cached per filter and must not be modified. The cache is cleared when the
+	 *	pixels are locked or the scale factor changes. Can be called from any thread, but not while
+	 *	the pixels are locked.
+	 */
+	PatternHandle getPattern (cairo_filter_t filter) const;
+	/** clear the cached patterns after the pixels were changed */
+	void invalidateCache ();
+
 	void unlock () { locked = false; }
 
 private:
+	SharedPointer<IPlatformBitmapPixelAccess> lock (bool alphaPremultiplied, bool onDemand);
+
+	struct CachedPattern
+	{
+		cairo_filter_t filter;
+		PatternHandle pattern;
+	};
+
 	double scaleFactor {1.0};
 	SurfaceHandle surface;
 	CPoint size;
-	bool locked {false};
+	std::atomic<bool> locked {false};
+
+	mutable std::mutex cacheMutex;
+	mutable std::vector<CachedPattern> patternCache;
 };
 
 //------------------------------------------------------------------------
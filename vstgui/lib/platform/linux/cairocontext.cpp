@@ -142,6 +142,13 @@ void Context::endDraw ()
 	cairo_restore (cr);
 	if (surface)
 		cairo_surface_flush (surface);
+	// the cached copies of a bitmap drawn into are outdated now
+	if (auto bitmap = getBitmap ())
+	{
+		bitmap->clearScaledVariants ();
+		if (auto cairoBitmap = bitmap->getPlatformBitmap ().cast<Bitmap> ())
+			cairoBitmap->invalidateCache ();
+	}
 	checkCairoStatus (cr);
 	super::endDraw ();
 }
@@ -384,6 +391,19 @@ void Context::drawPoint (const CPoint& point, const CColor& color)
 	checkCairoStatus (cr);
 }
 
+//-----------------------------------------------------------------------------
+cairo_filter_t Context::getBitmapFilter () const
+{
+	switch (getBitmapInterpolationQuality ())
+	{
+		case BitmapInterpolationQuality::kLow: return CAIRO_FILTER_NEAREST;
+		case BitmapInterpolationQuality::kMedium: return CAIRO_FILTER_BILINEAR;
+		case BitmapInterpolationQuality::kHigh: return CAIRO_FILTER_BEST;
+		case BitmapInterpolationQuality::kDefault: break;
+	}
+	return CAIRO_FILTER_GOOD;
+}
+
 //-----------------------------------------------------------------------------
 void Context::drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoint& offset, float alpha)
 {
@@ -397,22 +417,19 @@ void Context::drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoint& offs
 			bitmap->getBestPlatformBitmapForScaleFactor (transformedScaleFactor).cast<Bitmap> ();
 		if (cairoBitmap)
 		{
+			auto pattern = cairoBitmap->getPattern (getBitmapFilter ());
+			if (!pattern)
+				return;
 			cairo_translate (cr, dest.left, dest.top);
 			cairo_rectangle (cr, 0, 0, dest.getWidth (), dest.getHeight ());
 			cairo_clip (cr);
 
-			// Setup a pattern for scaling bitmaps and take it as source afterwards.
-			auto pattern = cairo_pattern_create_for_surface (cairoBitmap->getSurface ());
-			cairo_matrix_t matrix;
-			cairo_pattern_get_matrix (pattern, &matrix);
-			cairo_matrix_init_scale (&matrix, cairoBitmap->getScaleFactor (),
-									 cairoBitmap->getScaleFactor ());
-			cairo_matrix_translate (&matrix, offset.x, offset.y);
-			cairo_pattern_set_matrix (pattern, &matrix);
+			// the pattern is shared, so the offset is applied to the context instead of the
+			// pattern matrix
+			cairo_translate (cr, -offset.x, -offset.y);
 			cairo_set_source (cr, pattern);
 
-			cairo_rectangle (cr, -offset.x, -offset.y, dest.getWidth () + offset.x,
-							 dest.getHeight () + offset.y);
+			cairo_rectangle (cr, 0, 0, dest.getWidth () + offset.x, dest.getHeight () + offset.y);
 			alpha *= getGlobalAlpha ();
 			if (alpha != 1.f)
 			{
@@ -422,8 +439,6 @@ void Context::drawBitmap (CBitmap* bitmap, const CRect& dest, const CPoint& offs
 			{
 				cairo_fill (cr);
 			}
-
-			cairo_pattern_destroy (pattern);
 		}
 	}
 	checkCairoStatus (cr);
@@ -470,7 +485,7 @@ void Context::drawGraphicsPath (CGraphicsPath* path, CDrawContext::PathDrawMode
 		{
 			std::unique_ptr<GraphicsPath> alignedPath;
 			if (needPixelAlignment (getDrawMode ()))
-				alignedPath = graphicsPath->copyPixelAlign (getCurrentTransform ());
+				alignedPath = graphicsPath->copyPixelAlign (cr, getCurrentTransform ());
 			auto p = alignedPath ? alignedPath->getCairoPath () : graphicsPath->getCairoPath ();
 			if (transformation)
 			{
@@ -523,7 +538,7 @@ void Context::fillLinearGradient (CGraphicsPath* path, const CGradient& gradient
 			return;
 		std::unique_ptr<GraphicsPath> alignedPath;
 		if (needPixelAlignment (getDrawMode ()))
-			alignedPath = graphicsPath->copyPixelAlign (getCurrentTransform ());
+			alignedPath = graphicsPath->copyPixelAlign (cr, getCurrentTransform ());
 		if (auto cairoGradient = dynamic_cast<Gradient*> (gradient.getPlatformGradient ().get ()))
 		{
 			if (auto cd = DrawBlock::begin (*this))
@@ -64,6 +64,7 @@ private:
 	void init () override;
 	void setSourceColor (CColor color);
 	void setupCurrentStroke ();
+	cairo_filter_t getBitmapFilter () const;
 	void draw (CDrawStyle drawstyle);
 
 	SurfaceHandle surface;
@@ -11,6 +11,14 @@
 #include <pango/pango-features.h>
 #include <pango/pangofc-fontmap.h>
 #include <fontconfig/fontconfig.h>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -21,6 +29,100 @@ using PangoFontHandle =
 	Handle<PangoFont*, decltype (&g_object_ref), g_object_ref,
 		   decltype (&g_object_unref), g_object_unref>;
 
+//------------------------------------------------------------------------
+/** least recently used cache of laid out strings, used for measuring and drawing */
+class TextLayoutCache
+{
+public:
+	struct Key
+	{
+		std::string font;
+		int32_t style;
+		std::string text;
+
+		bool operator== (const Key& other) const
+		{
+			return style == other.style && font == other.font && text == other.text;
+		}
+	};
+
+	struct Layout
+	{
+		PangoLayout* layout {nullptr};
+		PangoRectangle extents {};
+		CCoord baseline {0.};
+		int width {0};
+	};
+
+	~TextLayoutCache () noexcept { clear (); }
+
+	/** returns the cached layout or the one created by createProc, which may be nullptr */
+	template<typename CreateProc>
+	const Layout* get (Key&& key, CreateProc createProc)
+	{
+		auto it = map.find (key);
+		if (it != map.end ())
+		{
+			++hits;
+			entries.splice (entries.begin (), entries, it->second);
+			return &it->second->second;
+		}
+		++misses;
+		Layout layout;
+		layout.layout = createProc (key);
+		if (!layout.layout)
+			return nullptr;
+		pango_layout_get_pixel_extents (layout.layout, nullptr, &layout.extents);
+		pango_layout_get_pixel_size (layout.layout, &layout.width, nullptr);
+		if (PangoLayoutIter* iter = pango_layout_get_iter (layout.layout))
+		{
+			layout.baseline = pango_units_to_double (pango_layout_iter_get_baseline (iter));
+			pango_layout_iter_free (iter);
+		}
+		if (entries.size () >= Font::kLayoutCacheCapacity)
+		{
+			g_object_unref (entries.back ().second.layout);
+			map.erase (entries.back ().first);
+			entries.pop_back ();
+		}
+		entries.emplace_front (std::move (key), layout);
+		map.emplace (entries.front ().first, entries.begin ());
+		return &entries.front ().second;
+	}
+
+	void clear ()
+	{
+		for (auto& entry : entries)
+			g_object_unref (entry.second.layout);
+		entries.clear ();
+		map.clear ();
+	}
+
+	uint64_t getHits () const { return hits; }
+	uint64_t getMisses () const { return misses; }
+	size_t size () const { return entries.size (); }
+
+private:
+	struct KeyHash
+	{
+		size_t operator() (const Key& key) const
+		{
+			auto h = std::hash<std::string> () (key.text);
+			h ^= std::hash<std::string> () (key.font) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<int32_t> () (key.style) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	using Entry = std::pair<Key, Layout>;
+	using EntryList = std::list<Entry>;
+
+	EntryList entries;
+	std::unordered_map<Key, EntryList::iterator, KeyHash> map;
+	uint64_t hits {0};
+	uint64_t misses {0};
+};
+
 //------------------------------------------------------------------------
 class FontList
 {
@@ -46,6 +148,19 @@ public:
 		return fontContext;
 	}
 
+	/** the font map, the context and the cached layouts are shared, so text must only be laid
+	 *	out and drawn with Pango on one draw thread at a time */
+	std::mutex& getMutex ()
+	{
+		return mutex;
+	}
+
+	/** only use while the mutex is locked */
+	TextLayoutCache& getLayoutCache ()
+	{
+		return layoutCache;
+	}
+
 	bool queryFont (UTF8StringPtr name, CCoord size, int32_t style, PangoFontHandle& fontHandle)
 	{
 		PangoFontDescription* desc = pango_font_description_new ();
@@ -104,6 +219,7 @@ private:
 
 	~FontList ()
 	{
+		layoutCache.clear ();
 		if (fontMap)
 			g_object_unref (fontMap);
 		if (fontContext)
@@ -116,6 +232,8 @@ private:
 	FcConfig* fcConfig = nullptr;
 	PangoFontMap* fontMap = nullptr;
 	PangoContext* fontContext = nullptr;
+	std::mutex mutex;
+	TextLayoutCache layoutCache;
 
 	static int slantFromStyle (int32_t style)
 	{
@@ -128,6 +246,80 @@ private:
 	}
 };
 
+//------------------------------------------------------------------------
+/** glyphs and advances of the printable ASCII characters of a font, as Pango shapes them */
+struct GlyphTable
+{
+	static constexpr unsigned char kFirst = 0x20;
+	static constexpr unsigned char kLast = 0x7e;
+	static constexpr size_t kSize = kLast - kFirst + 1;
+	/** marks the pairs which Pango does not shape glyph by glyph, like ligatures */
+	static constexpr int kComplexPair = std::numeric_limits<int>::min ();
+
+	ScaledFontHandle scaledFont;
+	std::array<bool, kSize> available {};
+	std::array<PangoGlyph, kSize> glyphs {};
+	/** the advances of the characters at the end of a text in Pango units */
+	std::array<int, kSize> advances {};
+	/** the advances of the characters followed by another one, including their kerning */
+	std::vector<int> pairAdvances = std::vector<int> (kSize * kSize, kComplexPair);
+
+	static size_t pairIndex (char first, char second)
+	{
+		return static_cast<size_t> (static_cast<unsigned char> (first) - kFirst) * kSize +
+			   (static_cast<unsigned char> (second) - kFirst);
+	}
+
+	/** simple text is short, has only characters of the table and is drawn glyph by glyph */
+	bool isSimpleText (const std::string& text) const
+	{
+		if (text.size () > kMaxSimpleTextLength)
+			return false;
+		for (size_t i = 0; i < text.size (); ++i)
+		{
+			auto uc = static_cast<unsigned char> (text[i]);
+			if (uc < kFirst || uc > kLast || !available[uc - kFirst])
+				return false;
+			if (i > 0 && pairAdvances[pairIndex (text[i - 1], text[i])] == kComplexPair)
+				return false;
+		}
+		return true;
+	}
+
+	/** the advance of the character at index in Pango units */
+	int getAdvance (const std::string& text, size_t index) const
+	{
+		if (index + 1 < text.size ())
+			return pairAdvances[pairIndex (text[index], text[index + 1])];
+		return advances[static_cast<unsigned char> (text[index]) - kFirst];
+	}
+
+	double getWidth (const std::string& text) const
+	{
+		int width = 0;
+		for (size_t i = 0; i < text.size (); ++i)
+			width += getAdvance (text, i);
+		return pango_units_to_double (width);
+	}
+
+	void draw (cairo_t* cr, const std::string& text, CPoint p) const
+	{
+		std::array<cairo_glyph_t, kMaxSimpleTextLength> cairoGlyphs;
+		int x = 0;
+		for (size_t i = 0; i < text.size (); ++i)
+		{
+			cairoGlyphs[i].index = glyphs[static_cast<unsigned char> (text[i]) - kFirst];
+			cairoGlyphs[i].x = p.x + pango_units_to_double (x);
+			cairoGlyphs[i].y = p.y;
+			x += getAdvance (text, i);
+		}
+		cairo_set_scaled_font (cr, scaledFont);
+		cairo_show_glyphs (cr, cairoGlyphs.data (), static_cast<int> (text.size ()));
+	}
+
+	static constexpr size_t kMaxSimpleTextLength = 64;
+};
+
 //------------------------------------------------------------------------
 } // anonymous
 
@@ -135,13 +327,200 @@ private:
 struct Font::Impl
 {
 	PangoFontHandle font;
+	/** the font description as string, identifies the font in the layout cache */
+	std::string description;
 	int32_t style;
 	CCoord ascent {-1.};
 	CCoord descent {-1.};
 	CCoord leading {-1.};
 	CCoord capHeight {-1.};
+	std::unique_ptr<GlyphTable> glyphTable;
+	bool glyphTableChecked {false};
+
+	/** returns the glyph table if text can be drawn without Pango. Must be called with the mutex
+	 *	of the font list locked */
+	const GlyphTable* getGlyphTableForText (const std::string& text)
+	{
+		if (!isSimpleTextFastPathEnabled () || (style & (kUnderlineFace | kStrikethroughFace)))
+			return nullptr;
+		if (!glyphTableChecked)
+		{
+			glyphTableChecked = true;
+			glyphTable = createGlyphTable ();
+		}
+		if (glyphTable && glyphTable->isSimpleText (text))
+			return glyphTable.get ();
+		return nullptr;
+	}
+
+	/** must be called with the mutex of the font list locked */
+	std::unique_ptr<GlyphTable> createGlyphTable () const
+	{
+		auto context = FontList::instance ().getFontContext ();
+		if (!font || !context)
+			return nullptr;
+		auto scaledFont = pango_cairo_font_get_scaled_font (PANGO_CAIRO_FONT (static_cast<PangoFont*> (font)));
+		if (!scaledFont || cairo_scaled_font_status (scaledFont) != CAIRO_STATUS_SUCCESS)
+			return nullptr;
+		PangoLayout* layout = createLayout (context);
+		if (!layout)
+			return nullptr;
+		auto table = std::unique_ptr<GlyphTable> (new GlyphTable);
+		table->scaledFont = ScaledFontHandle (cairo_scaled_font_reference (scaledFont));
+
+		// the glyph of every character on its own. Characters without a glyph in this font are
+		// left to the font fallback of Pango
+		std::string characters;
+		for (auto c = GlyphTable::kFirst; c <= GlyphTable::kLast; ++c)
+		{
+			char utf8[] = {static_cast<char> (c), 0};
+			pango_layout_set_text (layout, utf8, 1);
+			auto line = pango_layout_get_line_readonly (layout, 0);
+			if (!line || !line->runs || line->runs->next)
+				continue;
+			auto run = static_cast<PangoGlyphItem*> (line->runs->data);
+			if (run->glyphs->num_glyphs != 1 || !isFont (run->item->analysis.font))
+				continue;
+			const auto& info = run->glyphs->glyphs[0];
+			if ((info.glyph & PANGO_GLYPH_UNKNOWN_FLAG) || info.geometry.x_offset != 0 ||
+				info.geometry.y_offset != 0)
+				continue;
+			auto index = c - GlyphTable::kFirst;
+			table->available[index] = true;
+			table->glyphs[index] = info.glyph;
+			table->advances[index] = info.geometry.width;
+			characters.push_back (static_cast<char> (c));
+		}
+		if (characters.empty ())
+		{
+			g_object_unref (layout);
+			return nullptr;
+		}
+
+		// one text which has every pair of the characters exactly once, so that all of them are
+		// shaped at once. The kerning of a pair is applied to the advance of its first glyph
+		std::string pairs;
+		for (size_t i = 0; i < characters.size (); ++i)
+		{
+			pairs.push_back (characters[i]);
+			for (auto j = i + 1; j < characters.size (); ++j)
+			{
+				pairs.push_back (characters[i]);
+				pairs.push_back (characters[j]);
+			}
+		}
+		pairs.push_back (characters.front ());
+		pango_layout_set_text (layout, pairs.data (), static_cast<int> (pairs.size ()));
+		auto glyphOf = [&] (char c) {
+			return table->glyphs[static_cast<unsigned char> (c) - GlyphTable::kFirst];
+		};
+		auto line = pango_layout_get_line_readonly (layout, 0);
+		for (auto runs = line ? line->runs : nullptr; runs; runs = runs->next)
+		{
+			auto run = static_cast<PangoGlyphItem*> (runs->data);
+			if (!isFont (run->item->analysis.font))
+				continue;
+			auto glyphString = run->glyphs;
+			// the last glyph of a run is not kerned with the next character
+			for (auto i = 0; i + 1 < glyphString->num_glyphs; ++i)
+			{
+				auto position = run->item->offset + glyphString->log_clusters[i];
+				auto nextPosition = run->item->offset + glyphString->log_clusters[i + 1];
+				const auto& info = glyphString->glyphs[i];
+				const auto& nextInfo = glyphString->glyphs[i + 1];
+				// pairs which are ligatures or have other contextual glyphs stay complex
+				if (nextPosition != position + 1 || info.glyph != glyphOf (pairs[position]) ||
+					nextInfo.glyph != glyphOf (pairs[nextPosition]) || info.geometry.x_offset != 0 ||
+					info.geometry.y_offset != 0 || nextInfo.geometry.x_offset != 0 ||
+					nextInfo.geometry.y_offset != 0)
+					continue;
+				table->pairAdvances[GlyphTable::pairIndex (pairs[position], pairs[nextPosition])] =
+					info.geometry.width;
+			}
+		}
+		g_object_unref (layout);
+		return table;
+	}
+
+	/** returns true if other is this font or one with the same description */
+	bool isFont (PangoFont* other) const
+	{
+		if (other == static_cast<PangoFont*> (font))
+			return true;
+		bool result = false;
+		if (PangoFontDescription* desc = pango_font_describe (other))
+		{
+			if (char* otherDescription = pango_font_description_to_string (desc))
+			{
+				result = description == otherDescription;
+				g_free (otherDescription);
+			}
+			pango_font_description_free (desc);
+		}
+		return result;
+	}
+
+	/** a new layout with the font. Must be called with the mutex of the font list locked */
+	PangoLayout* createLayout (PangoContext* context) const
+	{
+		PangoLayout* layout = pango_layout_new (context);
+		if (layout && font)
+		{
+			PangoFontDescription* desc = pango_font_describe (font);
+			if (desc)
+			{
+				pango_layout_set_font_description (layout, desc);
+				pango_font_description_free (desc);
+			}
+		}
+		return layout;
+	}
+
+	/** must be called with the mutex of the font list locked */
+	const TextLayoutCache::Layout* getLayout (const std::string& text) const
+	{
+		auto& fontList = FontList::instance ();
+		auto context = fontList.getFontContext ();
+		if (!context)
+			return nullptr;
+		return fontList.getLayoutCache ().get (
+			{description, style, text}, [&] (const TextLayoutCache::Key& key) {
+				PangoLayout* layout = createLayout (context);
+				if (!layout)
+					return layout;
+
+				PangoAttrList* attrs = pango_attr_list_new ();
+				if (attrs)
+				{
+					if (style & kUnderlineFace)
+						pango_attr_list_insert (attrs, pango_attr_underline_new (PANGO_UNDERLINE_SINGLE));
+					if (style & kStrikethroughFace)
+						pango_attr_list_insert (attrs, pango_attr_strikethrough_new (true));
+					pango_layout_set_attributes (layout, attrs);
+					pango_attr_list_unref (attrs);
+				}
+
+				pango_layout_set_text (layout, key.text.c_str (), -1);
+				return layout;
+			});
+	}
 };
 
+//------------------------------------------------------------------------
+std::atomic<bool> Font::simpleTextFastPath {true};
+
+//------------------------------------------------------------------------
+void Font::setSimpleTextFastPathEnabled (bool state)
+{
+	simpleTextFastPath = state;
+}
+
+//------------------------------------------------------------------------
+bool Font::isSimpleTextFastPathEnabled ()
+{
+	return simpleTextFastPath;
+}
+
 //------------------------------------------------------------------------
 Font::Font (UTF8StringPtr name, const CCoord& size, const int32_t& style)
 {
@@ -151,6 +530,16 @@ Font::Font (UTF8StringPtr name, const CCoord& size, const int32_t& style)
 
 	if (fontList.queryFont (name, size, style, impl->font))
 	{
+		if (PangoFontDescription* desc = pango_font_describe (impl->font))
+		{
+			if (char* description = pango_font_description_to_string (desc))
+			{
+				impl->description = description;
+				g_free (description);
+			}
+			pango_font_description_free (desc);
+		}
+
 		PangoFontMetrics* metrics = pango_font_get_metrics (impl->font, nullptr);
 		if (metrics)
 		{
@@ -247,84 +636,58 @@ void Font::drawString (CDrawContext* context, IPlatformString* string, const CPo
 				cairo_set_source_rgba (cr, color.normRed<double> (), color.normGreen<double> (),
 									   color.normBlue<double> (), alpha);
 
-				PangoContext* context = FontList::instance ().getFontContext();
-				if (context)
+				std::unique_lock<std::mutex> lock (FontList::instance ().getMutex ());
+				if (auto glyphTable = impl->getGlyphTableForText (linuxString->get ()))
+				{
+					// the table is never replaced and cairo scaled fonts can be used on several
+					// threads, so only Pango layouts are drawn with the lock held
+					lock.unlock ();
+					glyphTable->draw (cr, linuxString->get (), p);
+				}
+				else if (auto layout = impl->getLayout (linuxString->get ()))
 				{
-					PangoLayout* layout = pango_layout_new (context);
-					if (layout)
-					{
-						if (impl->font)
-						{
-							PangoFontDescription* desc = pango_font_describe (impl->font);
-							if (desc)
-							{
-								pango_layout_set_font_description (layout, desc);
-								pango_font_description_free (desc);
-							}
-						}
-
-						PangoAttrList* attrs = pango_attr_list_new ();
-						if (attrs)
-						{
-							if (impl->style & kUnderlineFace)
-								pango_attr_list_insert (attrs, pango_attr_underline_new (PANGO_UNDERLINE_SINGLE));
-							if (impl->style & kStrikethroughFace)
-								pango_attr_list_insert (attrs, pango_attr_strikethrough_new (true));
-							pango_layout_set_attributes(layout, attrs);
-							pango_attr_list_unref (attrs);
-						}
-
-						pango_layout_set_text (layout, linuxString->get ().c_str (), -1);
-
-						PangoRectangle extents {};
-						pango_layout_get_pixel_extents (layout, nullptr, &extents);
-
-						PangoLayoutIter* iter = pango_layout_get_iter (layout);
-						CCoord baseline = 0.0;
-						if (iter)
-						{
-							baseline = pango_units_to_double (pango_layout_iter_get_baseline (iter));
-							pango_layout_iter_free (iter);
-						}
-
-						cairo_move_to (cr, p.x + extents.x, p.y + extents.y - baseline);
-						pango_cairo_show_layout (cr, layout);
-						g_object_unref (layout);
-					}
+					cairo_move_to (cr, p.x + layout->extents.x,
+								   p.y + layout->extents.y - layout->baseline);
+					pango_cairo_show_layout (cr, layout->layout);
 				}
 			}
 		}
 	}
 }
 
+//------------------------------------------------------------------------
+auto Font::getLayoutCacheStatistics () -> LayoutCacheStatistics
+{
+	auto& fontList = FontList::instance ();
+	std::lock_guard<std::mutex> guard (fontList.getMutex ());
+	const auto& cache = fontList.getLayoutCache ();
+	LayoutCacheStatistics statistics;
+	statistics.hits = cache.getHits ();
+	statistics.misses = cache.getMisses ();
+	statistics.entries = cache.size ();
+	return statistics;
+}
+
+//------------------------------------------------------------------------
+void Font::clearLayoutCache ()
+{
+	auto& fontList = FontList::instance ();
+	std::lock_guard<std::mutex> guard (fontList.getMutex ());
+	fontList.getLayoutCache ().clear ();
+}
+
 //------------------------------------------------------------------------
 CCoord Font::getStringWidth (CDrawContext* context, IPlatformString* string, bool antialias) const
 {
 	if (auto linuxString = dynamic_cast<LinuxString*> (string))
 	{
-		int pangoWidth = 0;
-		PangoContext* context = FontList::instance ().getFontContext();
-		if (context)
-		{
-			PangoLayout* layout = pango_layout_new (context);
-			if (layout)
-			{
-				if (impl->font)
-				{
-					PangoFontDescription* desc = pango_font_describe (impl->font);
-					if (desc)
-					{
-						pango_layout_set_font_description (layout, desc);
-						pango_font_description_free (desc);
-					}
-				}
-				pango_layout_set_text (layout, linuxString->get ().c_str (), -1);
-				pango_layout_get_pixel_size (layout, &pangoWidth, nullptr);
-				g_object_unref (layout);
-			}
-		}
-
-		return pangoWidth;
+		std::lock_guard<std::mutex> guard (FontList::instance ().getMutex ());
+		// round up like Pango does for the pixel size of a layout
+		if (auto glyphTable = impl->getGlyphTableForText (linuxString->get ()))
+			return std::ceil (glyphTable->getWidth (linuxString->get ()));
+		if (auto layout = impl->getLayout (linuxString->get ()))
+			return layout->width;
+		return 0;
 	}
 	return 0;
 }
@@ -6,6 +6,7 @@
 
 #include "../iplatformfont.h"
 #include "../platformfactory.h"
+#include <atomic>
 #include <memory>
 
 //------------------------------------------------------------------------
@@ -36,9 +37,28 @@ public:
 
 	static bool getAllFamilies (const FontFamilyCallback& callback);
 
+	/** draw and measure short printable ASCII strings glyph by glyph with the advances and kerning
+	 *	Pango gives them instead of laying them out with Pango. Strings with ligatures or other
+	 *	contextual glyphs are still laid out with Pango. Default is true. */
+	static void setSimpleTextFastPathEnabled (bool state);
+	static bool isSimpleTextFastPathEnabled ();
+
+	struct LayoutCacheStatistics
+	{
+		uint64_t hits {0};
+		uint64_t misses {0};
+		size_t entries {0};
+	};
+	/** the strings laid out by drawString and getStringWidth are cached for all fonts */
+	static constexpr size_t kLayoutCacheCapacity = 512;
+	static LayoutCacheStatistics getLayoutCacheStatistics ();
+	static void clearLayoutCache ();
+
 private:
 	struct Impl;
 	std::unique_ptr<Impl> impl;
+
+	static std::atomic<bool> simpleTextFastPath;
 };
 
 //------------------------------------------------------------------------
@@ -11,22 +11,30 @@ namespace Cairo {
 //------------------------------------------------------------------------
 Gradient::~Gradient () noexcept
 {
-	changed ();
+	resetPatterns ();
 }
 
 //------------------------------------------------------------------------
 void Gradient::changed ()
+{
+	std::lock_guard<std::mutex> guard (mutex);
+	resetPatterns ();
+}
+
+//------------------------------------------------------------------------
+void Gradient::resetPatterns ()
 {
 	linearGradient.reset ();
 	radialGradient.reset ();
 }
 
 //------------------------------------------------------------------------
-const PatternHandle& Gradient::getLinearGradient (CPoint start, CPoint end)
+PatternHandle Gradient::getLinearGradient (CPoint start, CPoint end)
 {
+	std::lock_guard<std::mutex> guard (mutex);
 	if (!linearGradient || start != linearGradientStart || end != linearGradientEnd)
 	{
-		changed ();
+		resetPatterns ();
 		linearGradientStart = start;
 		linearGradientEnd = end;
 		linearGradient =
@@ -43,8 +51,9 @@ const PatternHandle& Gradient::getLinearGradient (CPoint start, CPoint end)
 }
 
 //------------------------------------------------------------------------
-const PatternHandle& Gradient::getRadialGradient ()
+PatternHandle Gradient::getRadialGradient ()
 {
+	std::lock_guard<std::mutex> guard (mutex);
 	if (!radialGradient)
 	{
 		radialGradient = PatternHandle (cairo_pattern_create_radial (0, 0, 1, 0, 0, 1));
@@ -8,6 +8,7 @@
 #include "../../cpoint.h"
 #include "cairoutils.h"
 #include <cairo/cairo.h>
+#include <mutex>
 
 //------------------------------------------------------------------------
 namespace VSTGUI {
@@ -19,11 +20,15 @@ class Gradient : public PlatformGradientBase
 public:
 	~Gradient () noexcept override;
 
-	const PatternHandle& getLinearGradient (CPoint start, CPoint end);
-	const PatternHandle& getRadialGradient ();
+	/** the patterns are cached, the gradient may be used on several draw threads at once */
+	PatternHandle getLinearGradient (CPoint start, CPoint end);
+	PatternHandle getRadialGradient ();
 
 private:
 	void changed () override;
+	void resetPatterns ();
+
+	std::mutex mutex;
 
 	/* we want to calculate a normalized linear and radial gradiant */
 	PatternHandle linearGradient;
@@ -116,10 +116,11 @@ void GraphicsPath::closeSubpath ()
 }
 
 //------------------------------------------------------------------------
-std::unique_ptr<GraphicsPath> GraphicsPath::copyPixelAlign (const CGraphicsTransform& tm)
+std::unique_ptr<GraphicsPath> GraphicsPath::copyPixelAlign (const ContextHandle& cr,
+															const CGraphicsTransform& tm) const
 {
-	auto result = std::make_unique<GraphicsPath> (context);
-	cairo_append_path (context, path);
+	auto result = std::make_unique<GraphicsPath> (cr);
+	cairo_append_path (cr, path);
 	result->finishBuilding ();
 	auto rpath = result->path;
 
@@ -34,7 +34,10 @@ public:
 	~GraphicsPath () noexcept;
 
 	cairo_path_t* getCairoPath () const { return path; }
-	std::unique_ptr<GraphicsPath> copyPixelAlign (const CGraphicsTransform& tm);
+	/** the copy is built with the context it is drawn into, so that a path can be drawn on
+	 *	several threads at once */
+	std::unique_ptr<GraphicsPath> copyPixelAlign (const ContextHandle& cr,
+												  const CGraphicsTransform& tm) const;
 
 	// IPlatformGraphicsPath
 	void addArc (const CRect& rect, double startAngle, double endAngle, bool clockwise) override;
@@ -0,0 +1,118 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "cairotiledrenderer.h"
+#include "cairocontext.h"
+#include "../iplatformframecallback.h"
+#include "../../cview.h"
+#include "../../workerpool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Cairo {
+
+//------------------------------------------------------------------------
+void TiledRenderer::draw (IPlatformFrameCallback* frame, Context* context,
+						  const SurfaceHandle& surface, const std::vector<CRect>& rects)
+{
+	auto format = cairo_image_surface_get_format (surface);
+	if (numThreads == 0 || cairo_surface_get_type (surface) != CAIRO_SURFACE_TYPE_IMAGE ||
+		(format != CAIRO_FORMAT_ARGB32 && format != CAIRO_FORMAT_RGB24))
+	{
+		frame->platformDrawRects (context, rects);
+		return;
+	}
+	CRect surfaceRect (0, 0, cairo_image_surface_get_width (surface),
+					   cairo_image_surface_get_height (surface));
+
+	// the parts of the rects in one tile are united, so that the tiles do not overlap
+	using TileIndex = std::pair<int64_t, int64_t>;
+	std::map<TileIndex, CRect> tiles;
+	for (auto r : rects)
+	{
+		r.normalize ();
+		r.makeIntegral ();
+		r.bound (surfaceRect);
+		if (r.isEmpty ())
+			continue;
+		auto firstRow = static_cast<int64_t> (std::floor (r.top / kTileSize));
+		auto lastRow = static_cast<int64_t> (std::ceil (r.bottom / kTileSize));
+		auto firstColumn = static_cast<int64_t> (std::floor (r.left / kTileSize));
+		auto lastColumn = static_cast<int64_t> (std::ceil (r.right / kTileSize));
+		for (auto row = firstRow; row < lastRow; ++row)
+		{
+			for (auto column = firstColumn; column < lastColumn; ++column)
+			{
+				CRect tile (column * kTileSize, row * kTileSize, (column + 1) * kTileSize,
+							(row + 1) * kTileSize);
+				tile.bound (r);
+				if (tile.isEmpty ())
+					continue;
+				auto it = tiles.find ({row, column});
+				if (it == tiles.end ())
+					tiles.emplace (TileIndex {row, column}, tile);
+				else
+					it->second.unite (tile);
+			}
+		}
+	}
+
+	std::vector<CRect> concurrentTiles;
+	std::vector<CRect> mainThreadRects;
+	for (const auto& tile : tiles)
+	{
+		if (frame->platformPrepareConcurrentDraw (context, tile.second))
+			concurrentTiles.push_back (tile.second);
+		else
+			mainThreadRects.push_back (tile.second);
+	}
+
+	if (!concurrentTiles.empty ())
+	{
+		cairo_surface_flush (surface);
+		auto data = cairo_image_surface_get_data (surface);
+		auto stride = cairo_image_surface_get_stride (surface);
+		std::vector<SharedPointer<Context>> tileContexts;
+		tileContexts.reserve (concurrentTiles.size ());
+		for (const auto& tile : concurrentTiles)
+		{
+			// both formats use 4 bytes per pixel
+			auto x = static_cast<int> (tile.left);
+			auto y = static_cast<int> (tile.top);
+			SurfaceHandle tileSurface (cairo_image_surface_create_for_data (
+				data + y * stride + x * 4, format, static_cast<int> (tile.getWidth ()),
+				static_cast<int> (tile.getHeight ()), stride));
+			// the views draw in frame coordinates
+			cairo_surface_set_device_offset (tileSurface, -tile.left, -tile.top);
+			tileContexts.push_back (makeOwned<Context> (tile, tileSurface));
+		}
+		// every job draws the next tile until all are drawn, so that at most numThreads pool
+		// threads and the main thread draw at the same time
+		std::atomic<size_t> nextTile {0};
+		auto numJobs = static_cast<uint32_t> (std::min<size_t> (tileContexts.size (), numThreads + 1));
+		WorkerPool::instance ().perform (numJobs, [&] (uint32_t) {
+			CView::ConcurrentDrawScope concurrentDrawScope;
+			for (auto index = nextTile++; index < tileContexts.size (); index = nextTile++)
+			{
+				const auto& tileContext = tileContexts[index];
+				tileContext->beginDraw ();
+				tileContext->saveGlobalState ();
+				frame->platformDrawRect (tileContext, concurrentTiles[index]);
+				tileContext->restoreGlobalState ();
+				tileContext->endDraw ();
+			}
+		});
+		cairo_surface_mark_dirty (surface);
+	}
+	if (!mainThreadRects.empty ())
+		frame->platformDrawRects (context, mainThreadRects);
+}
+
+//------------------------------------------------------------------------
+} // Cairo
+} // VSTGUI
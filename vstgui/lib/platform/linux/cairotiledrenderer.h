@@ -0,0 +1,56 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../../crect.h"
+#include "cairoutils.h"
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+class IPlatformFrameCallback;
+
+namespace Cairo {
+
+class Context;
+
+//------------------------------------------------------------------------
+/** draws the dirty rects of a frame in tiles on several threads
+ *
+ *	The dirty rects are split into tiles of a fixed grid. A tile in which all views can be drawn
+ *	concurrently (see CView::isDrawThreadSafe) is drawn on the worker pool into its own context
+ *	over the pixels of the tile in the image surface. All other tiles are drawn afterwards on the
+ *	main thread with the main context.
+ */
+class TiledRenderer
+{
+public:
+	/** @param numThreads the maximum number of threads of the worker pool drawing tiles at the
+	 *	same time, the main thread draws tiles, too */
+	explicit TiledRenderer (uint32_t numThreads) : numThreads (numThreads) {}
+
+	/** draw the rects into the surface
+	 *
+	 *	Must be called between beginDraw and endDraw of the context.
+	 *	@param frame the frame to draw
+	 *	@param context the context which draws into surface on the main thread
+	 *	@param surface the surface to draw into, other than image surfaces are drawn on the main
+	 *	thread only
+	 *	@param rects the dirty rects
+	 */
+	void draw (IPlatformFrameCallback* frame, Context* context, const SurfaceHandle& surface,
+			   const std::vector<CRect>& rects);
+
+	/** the width and height of a tile in pixels */
+	static constexpr CCoord kTileSize = 128.;
+
+private:
+	uint32_t numThreads;
+};
+
+//------------------------------------------------------------------------
+} // Cairo
+} // VSTGUI
@@ -0,0 +1,166 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "headlessfactory.h"
+#include "headlessframe.h"
+#include "../iplatformbitmap.h"
+#include "../iplatformfont.h"
+#include "../iplatformframe.h"
+#include "../iplatformgradient.h"
+#include "../iplatformresourceinputstream.h"
+#include "../iplatformstring.h"
+#include "../iplatformtimer.h"
+#include "../../coffscreencontext.h"
+#include "../../idatapackage.h"
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+HeadlessFactory::HeadlessFactory (PlatformFactoryPtr&& platformFactory)
+: platformFactory (std::move (platformFactory))
+{
+	runLoop = std::unique_ptr<Headless::RunLoop> (new Headless::RunLoop);
+}
+
+//-----------------------------------------------------------------------------
+Headless::RunLoop& HeadlessFactory::getRunLoop () const noexcept
+{
+	return *runLoop;
+}
+
+//-----------------------------------------------------------------------------
+uint64_t HeadlessFactory::getTicks () const noexcept
+{
+	return runLoop->getTicks ();
+}
+
+//-----------------------------------------------------------------------------
+PlatformFramePtr HeadlessFactory::createFrame (IPlatformFrameCallback* frame, const CRect& size,
+											   void* parent, PlatformType parentType,
+											   IPlatformFrameConfig* config) const noexcept
+{
+	vstgui_assert (parent == runLoop.get (), "the parent must be the run loop of the factory");
+	if (parent != runLoop.get ())
+		return nullptr;
+	return makeOwned<Headless::Frame> (frame, size, *runLoop);
+}
+
+//-----------------------------------------------------------------------------
+PlatformFontPtr HeadlessFactory::createFont (const UTF8String& name, const CCoord& size,
+											 const int32_t& style) const noexcept
+{
+	return platformFactory->createFont (name, size, style);
+}
+
+//-----------------------------------------------------------------------------
+bool HeadlessFactory::getAllFontFamilies (const FontFamilyCallback& callback) const noexcept
+{
+	return platformFactory->getAllFontFamilies (callback);
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr HeadlessFactory::createBitmap (const CPoint& size) const noexcept
+{
+	return platformFactory->createBitmap (size);
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr HeadlessFactory::createBitmap (const CResourceDescription& desc) const noexcept
+{
+	return platformFactory->createBitmap (desc);
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr HeadlessFactory::createBitmapFromPath (UTF8StringPtr absolutePath) const noexcept
+{
+	return platformFactory->createBitmapFromPath (absolutePath);
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr HeadlessFactory::createBitmapFromMemory (const void* ptr,
+														   uint32_t memSize) const noexcept
+{
+	return platformFactory->createBitmapFromMemory (ptr, memSize);
+}
+
+//-----------------------------------------------------------------------------
+PNGBitmapBuffer HeadlessFactory::createBitmapMemoryPNGRepresentation (
+	const PlatformBitmapPtr& bitmap) const noexcept
+{
+	return platformFactory->createBitmapMemoryPNGRepresentation (bitmap);
+}
+
+//-----------------------------------------------------------------------------
+PlatformResourceInputStreamPtr
+	HeadlessFactory::createResourceInputStream (const CResourceDescription& desc) const noexcept
+{
+	return platformFactory->createResourceInputStream (desc);
+}
+
+//-----------------------------------------------------------------------------
+PlatformStringPtr HeadlessFactory::createString (UTF8StringPtr utf8String) const noexcept
+{
+	return platformFactory->createString (utf8String);
+}
+
+//-----------------------------------------------------------------------------
+PlatformTimerPtr HeadlessFactory::createTimer (IPlatformTimerCallback* callback) const noexcept
+{
+	return makeOwned<Headless::Timer> (*runLoop, callback);
+}
+
+//------------------------------------------------------------------------
+bool HeadlessFactory::setClipboard (const DataPackagePtr& data) const noexcept
+{
+	clipboard = data;
+	return true;
+}
+
+//------------------------------------------------------------------------
+auto HeadlessFactory::getClipboard () const noexcept -> DataPackagePtr
+{
+	return clipboard;
+}
+
+//------------------------------------------------------------------------
+auto HeadlessFactory::createOffscreenContext (const CPoint& size, double scaleFactor) const noexcept
+	-> COffscreenContextPtr
+{
+	return platformFactory->createOffscreenContext (size, scaleFactor);
+}
+
+//-----------------------------------------------------------------------------
+PlatformGradientPtr HeadlessFactory::createGradient () const noexcept
+{
+	return platformFactory->createGradient ();
+}
+
+//-----------------------------------------------------------------------------
+PlatformFileSelectorPtr HeadlessFactory::createFileSelector (PlatformFileSelectorStyle style,
+															 IPlatformFrame* frame) const noexcept
+{
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+const LinuxFactory* HeadlessFactory::asLinuxFactory () const noexcept
+{
+	return platformFactory->asLinuxFactory ();
+}
+
+//-----------------------------------------------------------------------------
+const MacFactory* HeadlessFactory::asMacFactory () const noexcept
+{
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+const Win32Factory* HeadlessFactory::asWin32Factory () const noexcept
+{
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,104 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../platformfactory.h"
+#include "headlessrunloop.h"
+
+//-----------------------------------------------------------------------------
+namespace VSTGUI {
+
+//-----------------------------------------------------------------------------
+/** a platform factory which does not need a window system
+
+	Frames are rendered into image surfaces and timers are driven by a manually stepped run loop,
+	so that whole editors can be opened, driven with synthetic events and rendered on machines
+	without a display. Fonts, bitmaps and offscreen contexts are created by the wrapped platform
+	factory.
+
+	@code
+	setPlatformFactory (std::make_unique<HeadlessFactory> (std::make_unique<LinuxFactory> (nullptr)));
+	auto headless = dynamic_cast<const HeadlessFactory*> (&getPlatformFactory ());
+	auto frame = makeOwned<CFrame> (CRect (0, 0, 400, 300), nullptr);
+	frame->open (&headless->getRunLoop ());
+	headless->getRunLoop ().advance (16);
+	auto platformFrame = dynamic_cast<Headless::Frame*> (frame->getPlatformFrame ());
+	auto snapshot = platformFrame->createSnapshot ();
+	@endcode
+ */
+class HeadlessFactory final : public IPlatformFactory
+{
+public:
+	HeadlessFactory (PlatformFactoryPtr&& platformFactory);
+
+	/** the run loop which drives the timers and redraws of this factory */
+	Headless::RunLoop& getRunLoop () const noexcept;
+
+	/** Return the ticks of the run loop (millisecond resolution)
+	 *	@return ticks
+	 */
+	uint64_t getTicks () const noexcept final;
+
+	/** Create a headless platform frame object
+	 *	@param frame callback
+	 *	@param size size
+	 *	@param parent the run loop of this factory
+	 *	@param parentType ignored
+	 *	@param config ignored
+	 *	@return platform frame
+	 */
+	PlatformFramePtr createFrame (IPlatformFrameCallback* frame, const CRect& size, void* parent,
+								  PlatformType parentType,
+								  IPlatformFrameConfig* config = nullptr) const noexcept final;
+
+	PlatformFontPtr createFont (const UTF8String& name, const CCoord& size,
+								const int32_t& style) const noexcept final;
+	bool getAllFontFamilies (const FontFamilyCallback& callback) const noexcept final;
+	PlatformBitmapPtr createBitmap (const CPoint& size) const noexcept final;
+	PlatformBitmapPtr createBitmap (const CResourceDescription& desc) const noexcept final;
+	PlatformBitmapPtr createBitmapFromPath (UTF8StringPtr absolutePath) const noexcept final;
+	PlatformBitmapPtr createBitmapFromMemory (const void* ptr,
+											  uint32_t memSize) const noexcept final;
+	PNGBitmapBuffer
+		createBitmapMemoryPNGRepresentation (const PlatformBitmapPtr& bitmap) const noexcept final;
+	PlatformResourceInputStreamPtr
+		createResourceInputStream (const CResourceDescription& desc) const noexcept final;
+	PlatformStringPtr createString (UTF8StringPtr utf8String = nullptr) const noexcept final;
+
+	/** Create a timer driven by the run loop
+	 *	@param callback timer callback object
+	 *	@return platform timer object
+	 */
+	PlatformTimerPtr createTimer (IPlatformTimerCallback* callback) const noexcept final;
+
+	/** Set the clipboard data. The clipboard is private to this factory.
+	 *	@param data data to put on the clipboard
+	 *	@return true on success
+	 */
+	bool setClipboard (const DataPackagePtr& data) const noexcept final;
+	DataPackagePtr getClipboard () const noexcept final;
+
+	COffscreenContextPtr createOffscreenContext (const CPoint& size,
+												 double scaleFactor = 1.) const noexcept final;
+	PlatformGradientPtr createGradient () const noexcept final;
+
+	/** file selectors are not supported
+	 *	@return nullptr
+	 */
+	PlatformFileSelectorPtr createFileSelector (PlatformFileSelectorStyle style,
+												IPlatformFrame* frame) const noexcept final;
+
+	const LinuxFactory* asLinuxFactory () const noexcept final;
+	const MacFactory* asMacFactory () const noexcept final;
+	const Win32Factory* asWin32Factory () const noexcept final;
+
+private:
+	PlatformFactoryPtr platformFactory;
+	std::unique_ptr<Headless::RunLoop> runLoop;
+	mutable DataPackagePtr clipboard;
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
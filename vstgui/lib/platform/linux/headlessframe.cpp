@@ -0,0 +1,297 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "headlessframe.h"
+#include "headlessrunloop.h"
+#include "cairobitmap.h"
+#include "cairocontext.h"
+#include "cairotiledrenderer.h"
+#include "../iplatformframecallback.h"
+#include "../iplatformtextedit.h"
+#include "../iplatformoptionmenu.h"
+#include "../iplatformviewlayer.h"
+#include "../iplatformopenglview.h"
+#include "../../cframe.h"
+#include "../common/generictextedit.h"
+#include <codecvt>
+#include <locale>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Headless {
+
+//------------------------------------------------------------------------
+Frame::Frame (IPlatformFrameCallback* frame, const CRect& inSize, RunLoop& runLoop)
+: IPlatformFrame (frame), runLoop (&runLoop)
+{
+	size.setSize (inSize.getSize ());
+	createSurface ();
+	runLoop.registerFrame (this);
+	frame->platformOnActivate (true);
+}
+
+//------------------------------------------------------------------------
+Frame::~Frame () noexcept
+{
+	if (runLoop)
+		runLoop->unregisterFrame (this);
+}
+
+//------------------------------------------------------------------------
+void Frame::createSurface ()
+{
+	surface.assign (cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+												static_cast<int> (size.getWidth ()),
+												static_cast<int> (size.getHeight ())));
+	drawContext = makeOwned<Cairo::Context> (size, surface);
+	dirtyRects.clear ();
+	dirtyRects.add (size);
+}
+
+//------------------------------------------------------------------------
+bool Frame::redraw ()
+{
+	if (dirtyRects.data ().empty ())
+		return false;
+	CRect clipRect;
+	for (const auto& rect : dirtyRects)
+	{
+		if (clipRect.isEmpty ())
+			clipRect = rect;
+		else
+			clipRect.unite (rect);
+	}
+	drawContext->beginDraw ();
+	drawContext->setClipRect (clipRect);
+	drawContext->saveGlobalState ();
+	if (tiledRenderer)
+		tiledRenderer->draw (frame, drawContext, surface, dirtyRects.data ());
+	else
+		frame->platformDrawRects (drawContext, dirtyRects.data ());
+	drawContext->restoreGlobalState ();
+	drawContext->endDraw ();
+	dirtyRects.clear ();
+	return true;
+}
+
+//------------------------------------------------------------------------
+void Frame::setDrawThreads (uint32_t numThreads)
+{
+	if (numThreads)
+		tiledRenderer = std::unique_ptr<Cairo::TiledRenderer> (new Cairo::TiledRenderer (numThreads));
+	else
+		tiledRenderer = nullptr;
+}
+
+//------------------------------------------------------------------------
+void Frame::dispatchEvent (Event& event)
+{
+	if (auto modifierEvent = asModifierEvent (event))
+		modifiers = modifierEvent->modifiers;
+	if (auto mouseEvent = asMouseEvent (event))
+	{
+		mousePosition = mouseEvent->mousePosition;
+		if (event.type == EventType::MouseUp)
+			mouseButtons = buttonStateFromEventModifiers (mouseEvent->modifiers);
+		else
+			mouseButtons = buttonStateFromMouseEvent (*mouseEvent);
+	}
+	else if (auto positionEvent = asMousePositionEvent (event))
+		mousePosition = positionEvent->mousePosition;
+
+	currentKeyText.clear ();
+	if (auto keyEvent = asKeyboardEvent (event))
+	{
+		if (keyEvent->character)
+		{
+			std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> conv;
+			currentKeyText = conv.to_bytes (keyEvent->character);
+		}
+	}
+	frame->platformOnEvent (event);
+	currentKeyText.clear ();
+}
+
+//------------------------------------------------------------------------
+PlatformBitmapPtr Frame::createSnapshot () const
+{
+	auto bitmap = makeOwned<Cairo::Bitmap> (size.getSize ());
+	Cairo::ContextHandle context (cairo_create (bitmap->getSurface ()));
+	cairo_set_source_surface (context, surface, 0, 0);
+	cairo_set_operator (context, CAIRO_OPERATOR_SOURCE);
+	cairo_paint (context);
+	cairo_surface_flush (bitmap->getSurface ());
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+bool Frame::getGlobalPosition (CPoint& pos) const
+{
+	pos = {};
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::setSize (const CRect& newSize)
+{
+	size = {};
+	size.setSize (newSize.getSize ());
+	createSurface ();
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::getSize (CRect& outSize) const
+{
+	outSize = size;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::getCurrentMousePosition (CPoint& outMousePosition) const
+{
+	outMousePosition = mousePosition;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::getCurrentMouseButtons (CButtonState& buttons) const
+{
+	buttons = mouseButtons;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::getCurrentModifiers (Modifiers& outModifiers) const
+{
+	outModifiers = modifiers;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::setMouseCursor (CCursorType type)
+{
+	cursor = type;
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::invalidRect (const CRect& rect)
+{
+	auto r = rect;
+	r.normalize ();
+	r.makeIntegral ();
+	r.bound (size);
+	if (!r.isEmpty ())
+		dirtyRects.add (r);
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Frame::scrollRect (const CRect& src, const CPoint& distance)
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool Frame::showTooltip (const CRect& rect, const char* utf8Text)
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+bool Frame::hideTooltip ()
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+void* Frame::getPlatformRepresentation () const
+{
+	return nullptr;
+}
+
+//------------------------------------------------------------------------
+SharedPointer<IPlatformTextEdit> Frame::createPlatformTextEdit (IPlatformTextEditCallback* textEdit)
+{
+	return makeOwned<GenericTextEdit> (textEdit);
+}
+
+//------------------------------------------------------------------------
+SharedPointer<IPlatformOptionMenu> Frame::createPlatformOptionMenu ()
+{
+	auto cFrame = dynamic_cast<CFrame*> (frame);
+	GenericOptionMenuTheme theme;
+	if (genericOptionMenuTheme)
+		theme = *genericOptionMenuTheme.get ();
+	return makeOwned<GenericOptionMenu> (cFrame, MouseEventButtonState (MouseButton::Left), theme);
+}
+
+#if VSTGUI_OPENGL_SUPPORT
+//------------------------------------------------------------------------
+SharedPointer<IPlatformOpenGLView> Frame::createPlatformOpenGLView ()
+{
+	return nullptr;
+}
+#endif
+
+//------------------------------------------------------------------------
+SharedPointer<IPlatformViewLayer> Frame::createPlatformViewLayer (
+	IPlatformViewLayerDelegate* drawDelegate, IPlatformViewLayer* parentLayer)
+{
+	// layered containers draw into the frame surface
+	return nullptr;
+}
+
+#if VSTGUI_ENABLE_DEPRECATED_METHODS
+//------------------------------------------------------------------------
+DragResult Frame::doDrag (IDataPackage* source, const CPoint& offset, CBitmap* dragBitmap)
+{
+	return kDragError;
+}
+#endif
+
+//------------------------------------------------------------------------
+bool Frame::doDrag (const DragDescription& dragDescription,
+					const SharedPointer<IDragCallback>& callback)
+{
+	return false;
+}
+
+//------------------------------------------------------------------------
+PlatformType Frame::getPlatformType () const
+{
+	return PlatformType::kDefaultNative;
+}
+
+//------------------------------------------------------------------------
+void Frame::onFrameClosed ()
+{
+	if (runLoop)
+		runLoop->unregisterFrame (this);
+	runLoop = nullptr;
+}
+
+//------------------------------------------------------------------------
+Optional<UTF8String> Frame::convertCurrentKeyEventToText ()
+{
+	if (currentKeyText.empty ())
+		return {};
+	return Optional<UTF8String> (UTF8String (currentKeyText));
+}
+
+//------------------------------------------------------------------------
+bool Frame::setupGenericOptionMenu (bool use, GenericOptionMenuTheme* theme)
+{
+	if (theme)
+		genericOptionMenuTheme =
+			std::unique_ptr<GenericOptionMenuTheme> (new GenericOptionMenuTheme (*theme));
+	else
+		genericOptionMenuTheme = nullptr;
+	return true;
+}
+
+//------------------------------------------------------------------------
+} // Headless
+} // VSTGUI
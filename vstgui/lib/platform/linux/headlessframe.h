@@ -0,0 +1,104 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../../cinvalidrectlist.h"
+#include "../../cbuttonstate.h"
+#include "../../events.h"
+#include "../iplatformframe.h"
+#include "../common/genericoptionmenu.h"
+#include "cairoutils.h"
+#include <memory>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Cairo {
+class Context;
+class TiledRenderer;
+} // Cairo
+
+namespace Headless {
+
+class RunLoop;
+
+//------------------------------------------------------------------------
+/** a platform frame which renders into an image surface instead of a window
+ *
+ *	Invalid areas are drawn when the run loop is advanced or when redraw () is called. Input is
+ *	injected with dispatchEvent ().
+ */
+class Frame : public IPlatformFrame
+{
+public:
+	Frame (IPlatformFrameCallback* frame, const CRect& size, RunLoop& runLoop);
+	~Frame () noexcept;
+
+	/** draw the invalid areas into the surface
+	 *	@return true if anything was drawn
+	 */
+	bool redraw ();
+	/** dispatch a synthetic event to the frame */
+	void dispatchEvent (Event& event);
+	/** draw the views declaring themselves draw thread safe in tiles on up to numThreads threads
+	 *	of the worker pool, 0 draws everything on the calling thread */
+	void setDrawThreads (uint32_t numThreads);
+
+	const Cairo::SurfaceHandle& getSurface () const { return surface; }
+	/** create a copy of the current surface content */
+	PlatformBitmapPtr createSnapshot () const;
+	bool hasInvalidRects () const { return !dirtyRects.data ().empty (); }
+	CCursorType getMouseCursor () const { return cursor; }
+
+	bool getGlobalPosition (CPoint& pos) const override;
+	bool setSize (const CRect& newSize) override;
+	bool getSize (CRect& size) const override;
+	bool getCurrentMousePosition (CPoint& mousePosition) const override;
+	bool getCurrentMouseButtons (CButtonState& buttons) const override;
+	bool getCurrentModifiers (Modifiers& modifiers) const override;
+	bool setMouseCursor (CCursorType type) override;
+	bool invalidRect (const CRect& rect) override;
+	bool scrollRect (const CRect& src, const CPoint& distance) override;
+	bool showTooltip (const CRect& rect, const char* utf8Text) override;
+	bool hideTooltip () override;
+	void* getPlatformRepresentation () const override;
+	SharedPointer<IPlatformTextEdit>
+	createPlatformTextEdit (IPlatformTextEditCallback* textEdit) override;
+	SharedPointer<IPlatformOptionMenu> createPlatformOptionMenu () override;
+#if VSTGUI_OPENGL_SUPPORT
+	SharedPointer<IPlatformOpenGLView> createPlatformOpenGLView () override;
+#endif
+	SharedPointer<IPlatformViewLayer> createPlatformViewLayer (
+		IPlatformViewLayerDelegate* drawDelegate, IPlatformViewLayer* parentLayer) override;
+#if VSTGUI_ENABLE_DEPRECATED_METHODS
+	DragResult doDrag (IDataPackage* source, const CPoint& offset, CBitmap* dragBitmap) override;
+#endif
+	bool doDrag (const DragDescription& dragDescription,
+				 const SharedPointer<IDragCallback>& callback) override;
+
+	PlatformType getPlatformType () const override;
+	void onFrameClosed () override;
+	Optional<UTF8String> convertCurrentKeyEventToText () override;
+	bool setupGenericOptionMenu (bool use, GenericOptionMenuTheme* theme = nullptr) override;
+
+private:
+	void createSurface ();
+
+	RunLoop* runLoop;
+	CRect size;
+	Cairo::SurfaceHandle surface;
+	SharedPointer<Cairo::Context> drawContext;
+	std::unique_ptr<Cairo::TiledRenderer> tiledRenderer;
+	CInvalidRectList dirtyRects;
+	CPoint mousePosition;
+	CButtonState mouseButtons;
+	Modifiers modifiers;
+	CCursorType cursor {kCursorDefault};
+	std::string currentKeyText;
+	std::unique_ptr<GenericOptionMenuTheme> genericOptionMenuTheme;
+};
+
+//------------------------------------------------------------------------
+} // Headless
+} // VSTGUI
@@ -0,0 +1,126 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "headlessrunloop.h"
+#include "headlessframe.h"
+#include <algorithm>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Headless {
+
+//------------------------------------------------------------------------
+void RunLoop::advance (uint64_t milliseconds)
+{
+	auto end = now + milliseconds;
+	while (true)
+	{
+		// timers may be started or stopped by the callbacks, so search the next one every time
+		auto next = std::min_element (timers.begin (), timers.end (),
+									  [] (const TimerEntry& e1, const TimerEntry& e2) {
+										  if (e1.nextFire == e2.nextFire)
+											  return e1.order < e2.order;
+										  return e1.nextFire < e2.nextFire;
+									  });
+		if (next == timers.end () || next->nextFire > end)
+			break;
+		now = next->nextFire;
+		next->nextFire += next->period;
+		next->timer->fire ();
+	}
+	now = end;
+	redrawFrames ();
+}
+
+//------------------------------------------------------------------------
+bool RunLoop::redrawFrames ()
+{
+	bool result = false;
+	auto framesCopy = frames;
+	for (auto frame : framesCopy)
+	{
+		if (std::find (frames.begin (), frames.end (), frame) == frames.end ())
+			continue;
+		if (frame->redraw ())
+			result = true;
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------
+void RunLoop::registerTimer (Timer* timer, uint32_t periodMs)
+{
+	unregisterTimer (timer);
+	// a zero period timer would fire endlessly without time passing
+	uint64_t period = std::max<uint32_t> (periodMs, 1u);
+	timers.push_back ({timer, period, now + period, timerOrder++});
+}
+
+//------------------------------------------------------------------------
+void RunLoop::unregisterTimer (Timer* timer)
+{
+	auto it = std::find_if (timers.begin (), timers.end (),
+							[timer] (const TimerEntry& e) { return e.timer == timer; });
+	if (it != timers.end ())
+		timers.erase (it);
+}
+
+//------------------------------------------------------------------------
+bool RunLoop::isTimerRegistered (Timer* timer) const
+{
+	return std::find_if (timers.begin (), timers.end (), [timer] (const TimerEntry& e) {
+			   return e.timer == timer;
+		   }) != timers.end ();
+}
+
+//------------------------------------------------------------------------
+void RunLoop::registerFrame (Frame* frame)
+{
+	frames.push_back (frame);
+}
+
+//------------------------------------------------------------------------
+void RunLoop::unregisterFrame (Frame* frame)
+{
+	auto it = std::find (frames.begin (), frames.end (), frame);
+	if (it != frames.end ())
+		frames.erase (it);
+}
+
+//------------------------------------------------------------------------
+Timer::Timer (RunLoop& runLoop, IPlatformTimerCallback* callback)
+: runLoop (runLoop), callback (callback)
+{
+}
+
+//------------------------------------------------------------------------
+Timer::~Timer () noexcept
+{
+	stop ();
+}
+
+//------------------------------------------------------------------------
+bool Timer::start (uint32_t periodMs)
+{
+	runLoop.registerTimer (this, periodMs);
+	return true;
+}
+
+//------------------------------------------------------------------------
+bool Timer::stop ()
+{
+	runLoop.unregisterTimer (this);
+	return true;
+}
+
+//------------------------------------------------------------------------
+void Timer::fire ()
+{
+	if (callback)
+		callback->fire ();
+}
+
+//------------------------------------------------------------------------
+} // Headless
+} // VSTGUI
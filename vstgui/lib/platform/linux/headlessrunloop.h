@@ -0,0 +1,80 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../iplatformtimer.h"
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Headless {
+
+class Frame;
+class Timer;
+
+//------------------------------------------------------------------------
+/** a manually stepped run loop
+ *
+ *	Time only passes when advance () is called, so timers and redraws happen in a deterministic
+ *	order independent of the speed of the machine.
+ */
+class RunLoop
+{
+public:
+	/** the current time of the run loop in milliseconds */
+	uint64_t getTicks () const { return now; }
+
+	/** advance the time, fire all timers which get due on the way in order and redraw the frames
+	 *	afterwards
+	 */
+	void advance (uint64_t milliseconds);
+	/** redraw the dirty areas of all frames
+	 *	@return true if any frame was redrawn
+	 */
+	bool redrawFrames ();
+
+	void registerTimer (Timer* timer, uint32_t periodMs);
+	void unregisterTimer (Timer* timer);
+	bool isTimerRegistered (Timer* timer) const;
+
+	void registerFrame (Frame* frame);
+	void unregisterFrame (Frame* frame);
+
+private:
+	struct TimerEntry
+	{
+		Timer* timer;
+		uint64_t period;
+		uint64_t nextFire;
+		uint64_t order;
+	};
+
+	std::vector<TimerEntry> timers;
+	std::vector<Frame*> frames;
+	uint64_t now {0};
+	uint64_t timerOrder {0};
+};
+
+//------------------------------------------------------------------------
+class Timer : public IPlatformTimer
+{
+public:
+	Timer (RunLoop& runLoop, IPlatformTimerCallback* callback);
+	~Timer () noexcept;
+
+	bool start (uint32_t periodMs) override;
+	bool stop () override;
+
+	void fire ();
+
+private:
+	RunLoop& runLoop;
+	IPlatformTimerCallback* callback {nullptr};
+};
+
+//------------------------------------------------------------------------
+} // Headless
+} // VSTGUI
@@ -20,11 +20,16 @@
 #include "../common/genericoptionmenu.h"
 #include "cairobitmap.h"
 #include "cairocontext.h"
+#include "cairotiledrenderer.h"
 #include "x11platform.h"
 #include "x11utils.h"
+#include "x11viewlayer.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 #include <X11/Xlib.h>
 #include <xcb/xcb.h>
 #include <xcb/xcb_util.h>
@@ -136,39 +141,152 @@ inline Modifiers toModifiers (int state)
 	return mods;
 }
 
+//------------------------------------------------------------------------
+bool hasSharedMemoryExtension (xcb_connection_t* connection)
+{
+	static constexpr char name[] = "MIT-SHM";
+	auto cookie = xcb_query_extension (connection, sizeof (name) - 1, name);
+	auto reply = xcb_query_extension_reply (connection, cookie, nullptr);
+	if (!reply)
+		return false;
+	auto present = reply->present != 0;
+	free (reply);
+	return present;
+}
+
 //------------------------------------------------------------------------
 } // anonymous
 
 //------------------------------------------------------------------------
-struct RedrawTimerHandler
-: ITimerHandler
-, NonAtomicReferenceCounted
+struct IRedrawClient
 {
-	using RedrawCallback = std::function<void ()>;
+	virtual void onRedraw () = 0;
+};
+
+//------------------------------------------------------------------------
+/** Schedules the redraws of all frames on one shared timer.
+ *
+ *	The timer only runs while at least one frame waits for a redraw. Each frame is redrawn at most
+ *	once per its redraw interval. After every change the timer is armed to the earliest due time
+ *	of the waiting frames.
+ */
+struct FrameScheduler : ITimerHandler
+{
+	using Clock = std::chrono::steady_clock;
+	using Milliseconds = std::chrono::milliseconds;
+
+	static FrameScheduler& instance ()
+	{
+		static FrameScheduler gInstance;
+		return gInstance;
+	}
+
+	void schedule (IRedrawClient* client, uint32_t interval, Clock::time_point lastRedraw)
+	{
+		auto it = std::find_if (pending.begin (), pending.end (),
+								[&] (const auto& entry) { return entry.client == client; });
+		if (it != pending.end ())
+			return;
+		pending.push_back ({client, lastRedraw + Milliseconds (interval)});
+		updateTimer (Clock::now ());
+	}
 
-	RedrawTimerHandler (uint64_t delay, RedrawCallback&& redrawCallback)
-	: redrawCallback (std::move (redrawCallback))
+	void unschedule (IRedrawClient* client)
 	{
-		RunLoop::instance ().get ()->registerTimer (delay, this);
+		pending.erase (std::remove_if (pending.begin (), pending.end (),
+									   [&] (const auto& entry) { return entry.client == client; }),
+					   pending.end ());
+		std::replace (dueClients.begin (), dueClients.end (), client,
+					  static_cast<IRedrawClient*> (nullptr));
+		updateTimer (Clock::now ());
 	}
-	~RedrawTimerHandler () noexcept { RunLoop::instance ().get ()->unregisterTimer (this); }
 
 	void onTimer () override
 	{
-		SharedPointer<RedrawTimerHandler> Self (this);
-		Self->redrawCallback ();
+		auto now = Clock::now ();
+		// the run loop timer repeats, its next tick is one interval from now
+		timerDue = now + Milliseconds (timerInterval);
+		dueClients.clear ();
+		pending.erase (std::remove_if (pending.begin (), pending.end (),
+									   [&] (const auto& entry) {
+										   if (entry.due > now)
+											   return false;
+										   dueClients.push_back (entry.client);
+										   return true;
+									   }),
+					   pending.end ());
+		for (auto index = 0u; index < dueClients.size (); ++index)
+		{
+			if (auto client = dueClients[index])
+				client->onRedraw ();
+		}
+		dueClients.clear ();
+		updateTimer (Clock::now ());
+	}
+
+private:
+	struct Entry
+	{
+		IRedrawClient* client;
+		Clock::time_point due;
+	};
+
+	void updateTimer (Clock::time_point now)
+	{
+		if (pending.empty ())
+		{
+			parkTimer ();
+			return;
+		}
+		auto earliest = std::min_element (
+			pending.begin (), pending.end (),
+			[] (const auto& lhs, const auto& rhs) { return lhs.due < rhs.due; });
+		auto delay = std::chrono::ceil<Milliseconds> (earliest->due - now).count ();
+		armTimer (now, static_cast<uint32_t> (std::max<decltype (delay)> (delay, 1)));
+	}
+
+	void armTimer (Clock::time_point now, uint32_t interval)
+	{
+		auto due = now + Milliseconds (interval);
+		// the running timer keeps its phase, so it is only kept if it does not tick after due
+		if (interval == timerInterval && timerDue <= due)
+			return;
+		auto runLoop = RunLoop::get ();
+		if (!runLoop)
+			return;
+		if (timerInterval)
+			runLoop->unregisterTimer (this);
+		timerInterval = interval;
+		timerDue = due;
+		runLoop->registerTimer (timerInterval, this);
+	}
+
+	void parkTimer ()
+	{
+		if (timerInterval == 0)
+			return;
+		if (auto runLoop = RunLoop::get ())
+			runLoop->unregisterTimer (this);
+		timerInterval = 0;
 	}
 
-	RedrawCallback redrawCallback;
+	std::vector<Entry> pending;
+	std::vector<IRedrawClient*> dueClients;
+	uint32_t timerInterval {0};
+	Clock::time_point timerDue {};
 };
 
 //------------------------------------------------------------------------
 struct DrawHandler
 {
-	DrawHandler (const ChildWindow& window)
+	DrawHandler (const ChildWindow& window, uint32_t drawThreads)
 	{
-		auto s = cairo_xcb_surface_create (RunLoop::instance ().getXcbConnection (),
-										   window.getID (), window.getVisual (),
+		if (drawThreads)
+			tiledRenderer = std::unique_ptr<Cairo::TiledRenderer> (
+				new Cairo::TiledRenderer (drawThreads));
+		auto connection = RunLoop::instance ().getXcbConnection ();
+		useImageBackBuffer = hasSharedMemoryExtension (connection);
+		auto s = cairo_xcb_surface_create (connection, window.getID (), window.getVisual (),
 										   window.getSize ().x, window.getSize ().y);
 		windowSurface.assign (s);
 		onSizeChanged (window.getSize ());
@@ -178,47 +296,115 @@ struct DrawHandler
 	void onSizeChanged (const CPoint& size)
 	{
 		cairo_xcb_surface_set_size (windowSurface, size.x, size.y);
-		backBuffer = Cairo::SurfaceHandle (cairo_surface_create_similar (
-			windowSurface, CAIRO_CONTENT_COLOR_ALPHA, size.x, size.y));
+		// with the MIT-SHM extension cairo places an image back buffer in shared memory, so that
+		// blitting it to the window does not copy the pixels over the X connection. Without it
+		// every blit would upload the image, so the back buffer stays on the server.
+		backBuffer.reset ();
+		if (useImageBackBuffer)
+		{
+			backBuffer = Cairo::SurfaceHandle (cairo_surface_create_similar_image (
+				windowSurface, CAIRO_FORMAT_ARGB32, size.x, size.y));
+		}
+		if (!backBuffer || cairo_surface_status (backBuffer) != CAIRO_STATUS_SUCCESS)
+		{
+			backBuffer = Cairo::SurfaceHandle (cairo_surface_create_similar (
+				windowSurface, CAIRO_CONTENT_COLOR_ALPHA, size.x, size.y));
+		}
 		CRect r;
 		r.setSize (size);
 		drawContext = makeOwned<Cairo::Context> (r, backBuffer);
 	}
 
-	template<typename RectList, typename Proc>
-	void draw (const RectList& dirtyRects, Proc proc)
+	template<typename RectList>
+	void draw (const RectList& dirtyRects, IPlatformFrameCallback* frame)
 	{
+		if (dirtyRects.data ().empty ())
+			return;
 		CRect copyRect;
-		drawContext->beginDraw ();
 		for (auto rect : dirtyRects)
 		{
-			drawContext->setClipRect (rect);
-			drawContext->saveGlobalState ();
-			proc (drawContext, rect);
-			drawContext->restoreGlobalState ();
 			if (copyRect.isEmpty ())
 				copyRect = rect;
 			else
 				copyRect.unite (rect);
 		}
+		drawContext->beginDraw ();
+		drawContext->setClipRect (copyRect);
+		drawContext->saveGlobalState ();
+		if (tiledRenderer)
+			tiledRenderer->draw (frame, drawContext, backBuffer, dirtyRects.data ());
+		else
+			frame->platformDrawRects (drawContext, dirtyRects.data ());
+		drawContext->restoreGlobalState ();
 		drawContext->endDraw ();
-		blitBackbufferToWindow (copyRect);
+	}
+
+	template<typename RectList, typename LayerList>
+	void blit (const RectList& rects, const LayerList& layers)
+	{
+		CRect unionRect;
+		for (auto rect : rects)
+		{
+			if (unionRect.isEmpty ())
+				unionRect = rect;
+			else
+				unionRect.unite (rect);
+		}
+		blitBackbufferToWindow (rects, unionRect, layers);
 		xcb_flush (RunLoop::instance ().getXcbConnection ());
 	}
 
 private:
 	Cairo::SurfaceHandle windowSurface;
 	Cairo::SurfaceHandle backBuffer;
+	bool useImageBackBuffer {false};
 	SharedPointer<Cairo::Context> drawContext;
+	std::unique_ptr<Cairo::TiledRenderer> tiledRenderer;
+
+	// the cost of one copy request expressed in pixels
+	static constexpr CCoord kBlitRequestCost = 64. * 64.;
 
-	void blitBackbufferToWindow (const CRect& rect)
+	template<typename RectList, typename LayerList>
+	void blitBackbufferToWindow (const RectList& dirtyRects, const CRect& unionRect,
+								 const LayerList& layers)
 	{
+		// copying the rects one by one needs a request per rect, while copying the union also
+		// copies all the pixels between the rects. Use whichever is cheaper.
+		CCoord rectsCost = 0.;
+		for (const auto& rect : dirtyRects)
+			rectsCost += rect.getWidth () * rect.getHeight () + kBlitRequestCost;
+		auto unionCost = unionRect.getWidth () * unionRect.getHeight () + kBlitRequestCost;
+
 		Cairo::ContextHandle windowContext (cairo_create (windowSurface));
-		cairo_rectangle (windowContext, rect.left, rect.top, rect.getWidth (), rect.getHeight ());
+		if (rectsCost < unionCost)
+		{
+			for (const auto& rect : dirtyRects)
+				cairo_rectangle (windowContext, rect.left, rect.top, rect.getWidth (),
+								 rect.getHeight ());
+		}
+		else
+		{
+			cairo_rectangle (windowContext, unionRect.left, unionRect.top, unionRect.getWidth (),
+							 unionRect.getHeight ());
+		}
 		cairo_clip (windowContext);
-		cairo_set_source_surface (windowContext, backBuffer, 0, 0);
-		cairo_rectangle (windowContext, rect.left, rect.top, rect.getWidth (), rect.getHeight ());
-		cairo_fill (windowContext);
+		if (layers.empty ())
+		{
+			cairo_set_source_surface (windowContext, backBuffer, 0, 0);
+			cairo_paint (windowContext);
+		}
+		else
+		{
+			// composite the view layers on top of the back buffer offscreen, so that the window
+			// never shows the back buffer without its layers
+			cairo_push_group (windowContext);
+			cairo_set_source_surface (windowContext, backBuffer, 0, 0);
+			cairo_paint (windowContext);
+			for (const auto& layer : layers)
+				layer->composite (windowContext);
+			cairo_pop_group_to_source (windowContext);
+			cairo_paint (windowContext);
+		}
 		cairo_surface_flush (windowSurface);
 	}
 };
@@ -309,7 +495,7 @@ private:
 };
 
 //------------------------------------------------------------------------
-struct Frame::Impl : IFrameEventHandler
+struct Frame::Impl : IFrameEventHandler, IRedrawClient
 {
 	using RectList = CInvalidRectList;
 
@@ -318,21 +504,36 @@ struct Frame::Impl : IFrameEventHandler
 	DoubleClickDetector doubleClickDetector;
 	IPlatformFrameCallback* frame;
 	std::unique_ptr<GenericOptionMenuTheme> genericOptionMenuTheme;
-	SharedPointer<RedrawTimerHandler> redrawTimer;
 	RectList dirtyRects;
+	RectList compositeRects;
+	std::vector<ViewLayer*> viewLayers;
+	uint32_t redrawInterval;
+	FrameScheduler::Clock::time_point lastRedraw {};
 	CCursorType currentCursor {kCursorDefault};
 	uint32_t pointerGrabed {0};
 	XdndHandler dndHandler;
 
 	//------------------------------------------------------------------------
-	Impl (::Window parent, CPoint size, IPlatformFrameCallback* frame)
-	: window (parent, size), drawHandler (window), frame (frame), dndHandler (&window, frame)
+	Impl (::Window parent, CPoint size, IPlatformFrameCallback* frame, uint32_t targetFrameRate,
+		  uint32_t drawThreads)
+	: window (parent, size)
+	, drawHandler (window, drawThreads)
+	, frame (frame)
+	, redrawInterval (targetFrameRate ? 1000 / targetFrameRate : 0)
+	, dndHandler (&window, frame)
 	{
 		RunLoop::instance ().registerWindowEventHandler (window.getID (), this);
 	}
 
 	//------------------------------------------------------------------------
-	~Impl () noexcept { RunLoop::instance ().unregisterWindowEventHandler (window.getID ()); }
+	~Impl () noexcept
+	{
+		// the layers may outlive the frame, their callbacks point to this
+		for (auto layer : viewLayers)
+			layer->detach ();
+		FrameScheduler::instance ().unschedule (this);
+		RunLoop::instance ().unregisterWindowEventHandler (window.getID ());
+	}
 
 	//------------------------------------------------------------------------
 	void setSize (const CRect& size)
@@ -366,23 +567,78 @@ struct Frame::Impl : IFrameEventHandler
 	//------------------------------------------------------------------------
 	void redraw ()
 	{
-		drawHandler.draw (dirtyRects, [&] (CDrawContext* context, const CRect& rect) {
-			frame->platformDrawRect (context, rect);
-		});
+		drawHandler.draw (dirtyRects, frame);
+		for (auto layer : viewLayers)
+			layer->drawInvalidRects ();
+		for (const auto& r : dirtyRects)
+			compositeRects.add (r);
+		drawHandler.blit (compositeRects, getSortedViewLayers ());
 		dirtyRects.clear ();
+		compositeRects.clear ();
+	}
+
+	//------------------------------------------------------------------------
+	/** parents before their children, siblings in z-index order */
+	std::vector<ViewLayer*> getSortedViewLayers () const
+	{
+		std::vector<ViewLayer*> result;
+		if (viewLayers.empty ())
+			return result;
+		result.reserve (viewLayers.size ());
+		auto addChildren = [&] (ViewLayer* parent, auto& addChildrenRef) -> void {
+			auto start = result.size ();
+			for (auto layer : viewLayers)
+			{
+				if (layer->getParentLayer () == parent)
+					result.push_back (layer);
+			}
+			auto end = result.size ();
+			std::stable_sort (result.begin () + start, result.end (),
+							  [] (const ViewLayer* l1, const ViewLayer* l2) {
+								  return l1->getZIndex () < l2->getZIndex ();
+							  });
+			for (auto i = start; i < end; ++i)
+				addChildrenRef (result[i], addChildrenRef);
+		};
+		addChildren (nullptr, addChildren);
+		return result;
 	}
 
 	//------------------------------------------------------------------------
 	void invalidRect (CRect r)
 	{
 		dirtyRects.add (r);
-		if (redrawTimer)
+		FrameScheduler::instance ().schedule (this, redrawInterval, lastRedraw);
+	}
+
+	//------------------------------------------------------------------------
+	void invalidLayerRect (CRect r)
+	{
+		compositeRects.add (r);
+		FrameScheduler::instance ().schedule (this, redrawInterval, lastRedraw);
+	}
+
+	//------------------------------------------------------------------------
+	void removeViewLayer (ViewLayer* layer)
+	{
+		auto it = std::find (viewLayers.begin (), viewLayers.end (), layer);
+		vstgui_assert (it != viewLayers.end ());
+		if (it != viewLayers.end ())
+			viewLayers.erase (it);
+		for (auto child : viewLayers)
+		{
+			if (child->getParentLayer () == layer)
+				child->setParentLayer (layer->getParentLayer ());
+		}
+	}
+
+	//------------------------------------------------------------------------
+	void onRedraw () override
+	{
+		if (dirtyRects.data ().empty () && compositeRects.data ().empty ())
 			return;
-		redrawTimer = makeOwned<RedrawTimerHandler> (16, [this] () {
-			if (dirtyRects.data ().empty ())
-				return;
-			redraw ();
-		});
+		lastRedraw = FrameScheduler::Clock::now ();
+		redraw ();
 	}
 
 	//------------------------------------------------------------------------
@@ -643,8 +899,11 @@ Frame::Frame (IPlatformFrameCallback* frame, const CRect& size, uint32_t parent,
 	{
 		RunLoop::init (cfg->runLoop);
 	}
+	uint32_t targetFrameRate = cfg ? cfg->targetFrameRate : FrameConfig ().targetFrameRate;
+	uint32_t drawThreads = cfg ? cfg->drawThreads : FrameConfig ().drawThreads;
 
-	impl = std::unique_ptr<Impl> (new Impl (parent, {size.getWidth (), size.getHeight ()}, frame));
+	impl = std::unique_ptr<Impl> (new Impl (parent, {size.getWidth (), size.getHeight ()}, frame,
+											targetFrameRate, drawThreads));
 
 	frame->platformOnActivate (true);
 }
@@ -796,8 +1055,13 @@ SharedPointer<IPlatformOpenGLView> Frame::createPlatformOpenGLView ()
 SharedPointer<IPlatformViewLayer> Frame::createPlatformViewLayer (
 	IPlatformViewLayerDelegate* drawDelegate, IPlatformViewLayer* parentLayer)
 {
-	// optional
-	return nullptr;
+	auto implPtr = impl.get ();
+	auto layer = makeOwned<ViewLayer> (
+		drawDelegate, dynamic_cast<ViewLayer*> (parentLayer),
+		[implPtr] (const CRect& frameRect) { implPtr->invalidLayerRect (frameRect); },
+		[implPtr] (ViewLayer* layer) { implPtr->removeViewLayer (layer); });
+	impl->viewLayers.push_back (layer);
+	return layer;
 }
 
 #if VSTGUI_ENABLE_DEPRECATED_METHODS
@@ -0,0 +1,188 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "x11viewlayer.h"
+#include "cairocontext.h"
+#include <cmath>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace X11 {
+
+//------------------------------------------------------------------------
+ViewLayer::ViewLayer (IPlatformViewLayerDelegate* inDelegate, ViewLayer* parentLayer,
+					  InvalidCallback&& invalidCallback, DestroyCallback&& destroyCallback)
+: delegate (inDelegate)
+, parentLayer (parentLayer)
+, invalidCallback (std::move (invalidCallback))
+, destroyCallback (std::move (destroyCallback))
+{
+}
+
+//------------------------------------------------------------------------
+ViewLayer::~ViewLayer () noexcept
+{
+	if (surface && invalidCallback)
+		invalidCallback (getFrameRect ());
+	if (destroyCallback)
+		destroyCallback (this);
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::detach ()
+{
+	invalidCallback = nullptr;
+	destroyCallback = nullptr;
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::invalidRect (const CRect& size)
+{
+	auto r = size;
+	r.normalize ();
+	r.makeIntegral ();
+	r.bound (CRect (0, 0, viewSize.getWidth (), viewSize.getHeight ()));
+	if (r.isEmpty ())
+		return;
+	invalidRectList.add (r);
+	r.offset (getFrameRect ().getTopLeft ());
+	if (invalidCallback)
+		invalidCallback (r);
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::setSize (const CRect& size)
+{
+	auto r = size;
+	r.normalize ();
+	r.makeIntegral ();
+	if (r == viewSize)
+		return;
+
+	if (surface && invalidCallback)
+		invalidCallback (getFrameRect ());
+	auto sizeChanged = r.getWidth () != viewSize.getWidth () ||
+					   r.getHeight () != viewSize.getHeight ();
+	viewSize = r;
+	invalidRectList.clear ();
+	if (sizeChanged || !surface)
+	{
+		createSurface ();
+		if (!surface)
+			return;
+	}
+	invalidRect (CRect (0, 0, viewSize.getWidth (), viewSize.getHeight ()));
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::setZIndex (uint32_t newZIndex)
+{
+	if (zIndex == newZIndex)
+		return;
+	zIndex = newZIndex;
+	if (surface && invalidCallback)
+		invalidCallback (getFrameRect ());
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::setAlpha (float newAlpha)
+{
+	if (alpha == newAlpha)
+		return;
+	alpha = newAlpha;
+	if (surface && invalidCallback)
+		invalidCallback (getFrameRect ());
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::draw (CDrawContext* context, const CRect& updateRect) {}
+
+//------------------------------------------------------------------------
+void ViewLayer::onScaleFactorChanged (double newScaleFactor)
+{
+	if (scaleFactor == newScaleFactor)
+		return;
+	scaleFactor = newScaleFactor;
+	invalidRectList.clear ();
+	createSurface ();
+	invalidRect (CRect (0, 0, viewSize.getWidth (), viewSize.getHeight ()));
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::createSurface ()
+{
+	surface.reset ();
+	if (viewSize.isEmpty ())
+		return;
+	// the surface has the pixels of the scale factor, the views draw in logical coordinates
+	surface.assign (cairo_image_surface_create (
+		CAIRO_FORMAT_ARGB32, static_cast<int> (std::ceil (viewSize.getWidth () * scaleFactor)),
+		static_cast<int> (std::ceil (viewSize.getHeight () * scaleFactor))));
+	cairo_surface_set_device_scale (surface, scaleFactor, scaleFactor);
+}
+
+//------------------------------------------------------------------------
+bool ViewLayer::drawInvalidRects ()
+{
+	if (invalidRectList.data ().empty ())
+		return false;
+	if (surface)
+	{
+		auto drawContext =
+			makeOwned<Cairo::Context> (CRect (0, 0, viewSize.getWidth (), viewSize.getHeight ()),
+									   surface);
+		drawContext->beginDraw ();
+		for (const auto& r : invalidRectList)
+		{
+			drawContext->setClipRect (r);
+			drawContext->saveGlobalState ();
+			drawContext->clearRect (r);
+			delegate->drawViewLayer (drawContext, r);
+			drawContext->restoreGlobalState ();
+		}
+		drawContext->endDraw ();
+	}
+	invalidRectList.clear ();
+	return true;
+}
+
+//------------------------------------------------------------------------
+void ViewLayer::composite (cairo_t* context) const
+{
+	if (!surface)
+		return;
+	auto compositeAlpha = getCompositeAlpha ();
+	if (compositeAlpha <= 0.f)
+		return;
+	auto frameRect = getFrameRect ();
+	cairo_save (context);
+	cairo_rectangle (context, frameRect.left, frameRect.top, frameRect.getWidth (),
+					 frameRect.getHeight ());
+	cairo_clip (context);
+	cairo_set_source_surface (context, surface, frameRect.left, frameRect.top);
+	if (compositeAlpha >= 1.f)
+		cairo_paint (context);
+	else
+		cairo_paint_with_alpha (context, compositeAlpha);
+	cairo_restore (context);
+}
+
+//------------------------------------------------------------------------
+CRect ViewLayer::getFrameRect () const
+{
+	auto r = viewSize;
+	if (parentLayer)
+		r.offset (parentLayer->getFrameRect ().getTopLeft ());
+	return r;
+}
+
+//------------------------------------------------------------------------
+float ViewLayer::getCompositeAlpha () const
+{
+	return parentLayer ? alpha * parentLayer->getCompositeAlpha () : alpha;
+}
+
+//------------------------------------------------------------------------
+} // X11
+} // VSTGUI
@@ -0,0 +1,73 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include "../iplatformviewlayer.h"
+#include "../../cinvalidrectlist.h"
+#include "cairoutils.h"
+#include <functional>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace X11 {
+
+//------------------------------------------------------------------------
+/** a view layer which renders into its own cached image surface
+ *
+ *	The layer is only redrawn when it was invalidated. The frame composites the cached surfaces
+ *	of all its layers on top of its back buffer when it blits to the window, so moving a layer or
+ *	changing its alpha does not redraw the views below it. The surface has the size of the layer
+ *	multiplied by the scale factor.
+ */
+class ViewLayer : public IPlatformViewLayer
+{
+public:
+	/** frameRect is in frame coordinates */
+	using InvalidCallback = std::function<void (const CRect& frameRect)>;
+	using DestroyCallback = std::function<void (ViewLayer*)>;
+
+	ViewLayer (IPlatformViewLayerDelegate* inDelegate, ViewLayer* parentLayer,
+			   InvalidCallback&& invalidCallback, DestroyCallback&& destroyCallback);
+	~ViewLayer () noexcept;
+
+	void invalidRect (const CRect& size) override;
+	void setSize (const CRect& size) override;
+	void setZIndex (uint32_t zIndex) override;
+	void setAlpha (float alpha) override;
+	void draw (CDrawContext* context, const CRect& updateRect) override;
+	void onScaleFactorChanged (double newScaleFactor) override;
+
+	/** draw the invalid parts of the layer into its surface */
+	bool drawInvalidRects ();
+	/** paint the layer surface into context which is in frame coordinates */
+	void composite (cairo_t* context) const;
+	/** called by the frame when it is destroyed before the layer, clears the callbacks */
+	void detach ();
+
+	/** the size of the layer in frame coordinates */
+	CRect getFrameRect () const;
+	float getCompositeAlpha () const;
+	uint32_t getZIndex () const { return zIndex; }
+	ViewLayer* getParentLayer () const { return parentLayer; }
+	void setParentLayer (ViewLayer* layer) { parentLayer = layer; }
+
+private:
+	void createSurface ();
+
+	IPlatformViewLayerDelegate* delegate {nullptr};
+	ViewLayer* parentLayer {nullptr};
+	InvalidCallback invalidCallback;
+	DestroyCallback destroyCallback;
+	Cairo::SurfaceHandle surface;
+	CRect viewSize;
+	CInvalidRectList invalidRectList;
+	uint32_t zIndex {0};
+	float alpha {1.f};
+	double scaleFactor {1.};
+};
+
+//------------------------------------------------------------------------
+} // X11
+} // VSTGUI
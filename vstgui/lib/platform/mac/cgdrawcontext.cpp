@@ -93,6 +93,7 @@ void CGDrawContext::endDraw ()
 	{
 		if (auto cgBitmap = bitmap->getPlatformBitmap ().cast<CGBitmap> ())
 			cgBitmap->setDirty ();
+		bitmap->clearScaledVariants ();
 	}
 	bitmapDrawCount.clear ();
 }
@@ -40,6 +40,11 @@ class FrameConfig : public IPlatformFrameConfig
 {
 public:
 	SharedPointer<IRunLoop> runLoop;
+	/** maximum number of redraws per second, 0 redraws as soon as possible */
+	uint32_t targetFrameRate {60};
+	/** maximum number of threads of the worker pool which draw the views declaring themselves
+	 *	draw thread safe in tiles, 0 draws everything on the main thread */
+	uint32_t drawThreads {0};
 };
 
 //------------------------------------------------------------------------
@@ -24,6 +24,14 @@ void initPlatform (PlatformInstanceHandle instance);
 /** exit the platform layer of VSTGUI. */
 void exitPlatform ();
 
+//-----------------------------------------------------------------------------
+/** replace the global platform factory instance.
+
+	initPlatform sets the default factory of the platform. This can be used instead to install
+	a different one, for example a headless factory for rendering without a window system.
+ */
+void setPlatformFactory (PlatformFactoryPtr&& factory);
+
 //-----------------------------------------------------------------------------
 /** get the global platform factory instance */
 const IPlatformFactory& getPlatformFactory ();
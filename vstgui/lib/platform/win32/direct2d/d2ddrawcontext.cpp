@@ -240,6 +240,7 @@ void D2DDrawContext::endDraw ()
 		{
 			D2DBitmap* d2dBitmap = dynamic_cast<D2DBitmap*> (bitmap->getPlatformBitmap ().get ());
 			D2DBitmapCache::removeBitmap (d2dBitmap);
+			bitmap->clearScaledVariants ();
 		}
 	}
 }
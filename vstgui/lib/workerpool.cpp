@@ -0,0 +1,155 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "workerpool.h"
+#include "vstguibase.h"
+#include <algorithm>
+
+#if WINDOWS
+	#include "platform/win32/win32support.h"
+#endif
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+#if WINDOWS
+//------------------------------------------------------------------------
+/** the jobs and tasks can use COM on the worker threads, like WIC decoding a bitmap */
+struct COMThreadScope
+{
+	COMThreadScope () : result (CoInitializeEx (nullptr, COINIT_MULTITHREADED)) {}
+	~COMThreadScope () noexcept
+	{
+		if (SUCCEEDED (result))
+			CoUninitialize ();
+	}
+
+	HRESULT result;
+};
+#endif
+
+} // anonymous
+
+//------------------------------------------------------------------------
+WorkerPool& WorkerPool::instance ()
+{
+	// never destroyed, as joining threads in a static destructor can deadlock in a plugin which
+	// is unloaded under the loader lock on Windows. VSTGUI::exit calls shutdown instead.
+	static auto gInstance = new WorkerPool;
+	return *gInstance;
+}
+
+//------------------------------------------------------------------------
+WorkerPool::WorkerPool ()
+{
+	auto numCPUs = std::max (std::thread::hardware_concurrency (), 2u);
+	numThreads = std::min (numCPUs - 1, kMaxThreads);
+}
+
+//------------------------------------------------------------------------
+void WorkerPool::shutdown ()
+{
+	std::vector<std::thread> runningThreads;
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		quit = true;
+		runningThreads.swap (threads);
+		tasks.clear ();
+	}
+	workCondition.notify_all ();
+	for (auto& thread : runningThreads)
+		thread.join ();
+	std::lock_guard<std::mutex> guard (mutex);
+	quit = false;
+}
+
+//------------------------------------------------------------------------
+void WorkerPool::startThreads ()
+{
+	if (!threads.empty ())
+		return;
+	threads.reserve (numThreads);
+	for (auto i = 0u; i < numThreads; ++i)
+		threads.emplace_back ([this] () { workerLoop (); });
+}
+
+//------------------------------------------------------------------------
+uint32_t WorkerPool::numJobsForPixels (uint64_t numPixels) const
+{
+	return static_cast<uint32_t> (
+		std::max<uint64_t> (std::min<uint64_t> (numPixels / kMinPixelsPerJob, numThreads + 1), 1));
+}
+
+//------------------------------------------------------------------------
+void WorkerPool::perform (uint32_t numJobs, const Job& job)
+{
+	if (numJobs < 2)
+	{
+		if (numJobs)
+			job (0);
+		return;
+	}
+	Batch batch {&job, numJobs};
+	std::unique_lock<std::mutex> lock (mutex);
+	startThreads ();
+	batches.push_back (&batch);
+	workCondition.notify_all ();
+	while (batch.nextJob < batch.numJobs)
+		performNextJob (batch, lock);
+	doneCondition.wait (lock, [&] () { return batch.finishedJobs == batch.numJobs; });
+}
+
+//------------------------------------------------------------------------
+void WorkerPool::async (Task&& task)
+{
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		startThreads ();
+		tasks.push_back (std::move (task));
+	}
+	workCondition.notify_one ();
+}
+
+//------------------------------------------------------------------------
+void WorkerPool::performNextJob (Batch& batch, std::unique_lock<std::mutex>& lock)
+{
+	auto index = batch.nextJob++;
+	if (batch.nextJob == batch.numJobs)
+		batches.erase (std::find (batches.begin (), batches.end (), &batch));
+	lock.unlock ();
+	(*batch.job) (index);
+	lock.lock ();
+	if (++batch.finishedJobs == batch.numJobs)
+		doneCondition.notify_all ();
+}
+
+//------------------------------------------------------------------------
+void WorkerPool::workerLoop ()
+{
+#if WINDOWS
+	COMThreadScope comScope;
+#endif
+	std::unique_lock<std::mutex> lock (mutex);
+	while (true)
+	{
+		workCondition.wait (lock,
+							[this] () { return quit || !batches.empty () || !tasks.empty (); });
+		if (quit)
+			return;
+		if (!batches.empty ())
+		{
+			performNextJob (*batches.front (), lock);
+			continue;
+		}
+		auto task = std::move (tasks.front ());
+		tasks.pop_front ();
+		lock.unlock ();
+		task ();
+		lock.lock ();
+	}
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,85 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+/** process-wide pool of worker threads
+ *
+ *	The threads are created on first use and live until shutdown is called, which VSTGUI::exit
+ *	does. All code which splits work onto several threads uses this pool, so that the number of
+ *	threads stays bounded by the number of CPUs. On Windows the worker threads are initialized for
+ *	COM in the multithreaded apartment.
+ *
+ *	The thread calling perform works on its own jobs, too. So perform can be called from several
+ *	threads at the same time and from within a job or task without blocking the pool.
+ */
+class WorkerPool
+{
+public:
+	using Job = std::function<void (uint32_t index)>;
+	using Task = std::function<void ()>;
+
+	static WorkerPool& instance ();
+
+	/** the number of worker threads, not counting the threads calling perform */
+	uint32_t getNumThreads () const { return numThreads; }
+
+	/** call job for the indices [0, numJobs) and return when all are done */
+	void perform (uint32_t numJobs, const Job& job);
+	/** run task on a worker thread and return immediately */
+	void async (Task&& task);
+	/** join the worker threads and drop the tasks which have not started yet.
+	 *
+	 *	Must not be called while perform is running. The threads are started again on the next
+	 *	use of the pool.
+	 */
+	void shutdown ();
+
+	/** the number of jobs to split an image with numPixels pixels into, so that each job
+	 *	processes at least kMinPixelsPerJob pixels. 1 if the image is too small to be split. */
+	uint32_t numJobsForPixels (uint64_t numPixels) const;
+
+	static constexpr uint64_t kMinPixelsPerJob = 128 * 1024;
+	static constexpr uint32_t kMaxThreads = 7;
+
+private:
+	struct Batch
+	{
+		const Job* job;
+		uint32_t numJobs;
+		uint32_t nextJob {0};
+		uint32_t finishedJobs {0};
+	};
+
+	WorkerPool ();
+
+	void startThreads ();
+	/** must be called with the mutex locked, the mutex is unlocked while the job runs */
+	void performNextJob (Batch& batch, std::unique_lock<std::mutex>& lock);
+	void workerLoop ();
+
+	uint32_t numThreads;
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable workCondition;
+	std::condition_variable doneCondition;
+	std::deque<Batch*> batches;
+	std::deque<Task> tasks;
+	bool quit {false};
+};
+
+//------------------------------------------------------------------------
+} // VSTGUI
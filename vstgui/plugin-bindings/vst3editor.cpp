@@ -453,6 +453,8 @@ void VST3Editor::init ()
 	setIdleRate (300);
 	if (description->parse ())
 	{
+		// decode the bitmaps of the editor view while the host opens the editor
+		description->prefetchBitmaps (viewName.c_str ());
 		// get sizes
 		const auto* attr = description->getViewAttributes (viewName.c_str ());
 		if (attr)
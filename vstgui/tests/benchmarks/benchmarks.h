@@ -0,0 +1,40 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#pragma once
+
+#include <chrono>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Benchmark {
+
+using Func = void (*) ();
+
+//------------------------------------------------------------------------
+struct Registration
+{
+	Registration (const char* name, Func func);
+};
+
+//------------------------------------------------------------------------
+/** returns the time the call of proc took in milliseconds */
+template<typename Proc>
+inline double measure (Proc proc)
+{
+	auto start = std::chrono::high_resolution_clock::now ();
+	proc ();
+	auto end = std::chrono::high_resolution_clock::now ();
+	return std::chrono::duration<double, std::milli> (end - start).count ();
+}
+
+//------------------------------------------------------------------------
+} // Benchmark
+} // VSTGUI
+
+//------------------------------------------------------------------------
+#define BENCHMARK(name)                                                                            \
+	static void name ();                                                                           \
+	static VSTGUI::Benchmark::Registration name##Registration (#name, name);                       \
+	static void name ()
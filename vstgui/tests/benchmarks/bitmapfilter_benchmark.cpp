@@ -0,0 +1,83 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "benchmarks.h"
+#include "vstgui/lib/cbitmap.h"
+#include "vstgui/lib/cbitmapfilter.h"
+
+#include <cstdio>
+#include <random>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> createRandomBitmap (uint32_t width, uint32_t height)
+{
+	auto bitmap = makeOwned<CBitmap> (CPoint (width, height));
+	std::mt19937 random (width * 7 + height);
+	if (auto accessor = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+		{
+			auto value = random ();
+			accessor->setColor (CColor (value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF,
+										(value >> 24) & 0xFF));
+		} while (++(*accessor));
+	}
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+double runBlur (IdStringPtr filterName, IdStringPtr sizeProperty, BitmapFilter::Property size,
+				CBitmap* bitmap)
+{
+	auto filter = owned (BitmapFilter::Factory::getInstance ().createFilter (filterName));
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
+	filter->setProperty (sizeProperty, size);
+	filter->setProperty (BitmapFilter::Standard::Property::kAlphaChannelOnly, 1);
+	return Benchmark::measure ([&] () { filter->run (true); });
+}
+
+//------------------------------------------------------------------------
+double runScale (IdStringPtr filterName, CBitmap* bitmap, uint32_t width, uint32_t height)
+{
+	auto filter = owned (BitmapFilter::Factory::getInstance ().createFilter (filterName));
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
+	filter->setProperty (BitmapFilter::Standard::Property::kOutputRect,
+						 CRect (0, 0, width, height));
+	return Benchmark::measure ([&] () { filter->run (); });
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+BENCHMARK (BitmapFilterBlur)
+{
+	using namespace BitmapFilter::Standard;
+	// the shadow of a large panel
+	auto bitmap = createRandomBitmap (1600, 1000);
+	double boxBlurTime = 0.;
+	for (auto boxSize : {9, 11, 11})
+		boxBlurTime += runBlur (kBoxBlur, Property::kRadius, boxSize, bitmap);
+	auto gaussianBlurTime = runBlur (kGaussianBlur, Property::kStandardDeviation, 5., bitmap);
+	printf ("Blurring 1600x1000 alpha: three box blurs %f ms, gaussian blur %f ms\n", boxBlurTime,
+			gaussianBlurTime);
+}
+
+//------------------------------------------------------------------------
+BENCHMARK (BitmapFilterScale)
+{
+	using namespace BitmapFilter::Standard;
+	auto bitmap = createRandomBitmap (2048, 2048);
+	for (auto filterName : {kScaleBilinear, kScaleAreaAverage, kScaleLanczos})
+	{
+		auto time = runScale (filterName, bitmap, 512, 512);
+		printf ("Scaling 2048x2048 to 512x512 with %s: %f ms\n", filterName, time);
+	}
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,68 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "benchmarks.h"
+#include "vstgui/lib/vstguiinit.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if MAC
+#include <CoreFoundation/CoreFoundation.h>
+#endif
+
+#if WINDOWS
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace Benchmark {
+
+//------------------------------------------------------------------------
+static std::vector<std::pair<const char*, Func>>& getBenchmarks ()
+{
+	static std::vector<std::pair<const char*, Func>> benchmarks;
+	return benchmarks;
+}
+
+//------------------------------------------------------------------------
+Registration::Registration (const char* name, Func func)
+{
+	getBenchmarks ().emplace_back (name, func);
+}
+
+//------------------------------------------------------------------------
+} // Benchmark
+} // VSTGUI
+
+//------------------------------------------------------------------------
+/** runs all benchmarks or only the ones whose names are passed as arguments */
+int main (int argc, char* argv[])
+{
+#if MAC
+	VSTGUI::init (CFBundleGetMainBundle ());
+#elif WINDOWS
+	VSTGUI::init (GetModuleHandle (nullptr));
+#elif LINUX
+	VSTGUI::init (nullptr);
+#endif
+	for (auto& benchmark : VSTGUI::Benchmark::getBenchmarks ())
+	{
+		auto selected = argc < 2;
+		for (auto i = 1; i < argc && !selected; ++i)
+			selected = std::strcmp (argv[i], benchmark.first) == 0;
+		if (!selected)
+			continue;
+		printf ("%s\n", benchmark.first);
+		benchmark.second ();
+	}
+	VSTGUI::exit ();
+	return 0;
+}
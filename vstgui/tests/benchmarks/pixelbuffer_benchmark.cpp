@@ -0,0 +1,41 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "benchmarks.h"
+#include "vstgui/lib/pixelbuffer.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+BENCHMARK (PixelBufferConvert)
+{
+	using namespace PixelBuffer;
+
+	constexpr uint32_t width = 2048;
+	constexpr uint32_t height = 1024;
+	constexpr uint32_t bytesPerRow = width * 4;
+	constexpr auto count = 10;
+
+	std::vector<uint8_t> data (bytesPerRow * height);
+	std::mt19937 random (width * 31 + height);
+	for (auto& byte : data)
+		byte = static_cast<uint8_t> (random ());
+
+	auto time = Benchmark::measure ([&] () {
+					for (auto i = 0; i < count; ++i)
+						convert (Format::ARGB, Format::BGRA, data.data (), bytesPerRow, width,
+								 height);
+				}) /
+				count;
+	printf ("Converting %ux%u pixels: %f ms (%f MPixel/s)\n", width, height, time,
+			width * height / (time * 1000.));
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
@@ -0,0 +1,57 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "benchmarks.h"
+#include "vstgui/lib/platform/linux/cairocontext.h"
+#include "vstgui/lib/platform/linux/cairofont.h"
+#include "vstgui/lib/cfont.h"
+#include "vstgui/lib/cstring.h"
+
+#include <cstdio>
+#include <string>
+
+//------------------------------------------------------------------------
+namespace VSTGUI {
+namespace {
+
+//------------------------------------------------------------------------
+double drawValueStrings (Cairo::Font* font, uint32_t count, bool fastPath)
+{
+	auto oldState = Cairo::Font::isSimpleTextFastPathEnabled ();
+	Cairo::Font::setSimpleTextFastPathEnabled (fastPath);
+	Cairo::Font::clearLayoutCache ();
+
+	auto surface = Cairo::SurfaceHandle (cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 200, 20));
+	auto context = makeOwned<Cairo::Context> (CRect (0, 0, 200, 20), surface);
+	context->beginDraw ();
+	auto time = Benchmark::measure ([&] () {
+		for (auto i = 0u; i < count; ++i)
+		{
+			UTF8String text (std::to_string (i * 0.01) + " dB");
+			font->drawString (context, text.getPlatformString (), CPoint (2, 14), true);
+		}
+	});
+	context->endDraw ();
+
+	Cairo::Font::clearLayoutCache ();
+	Cairo::Font::setSimpleTextFastPathEnabled (oldState);
+	return time;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+BENCHMARK (CairoSimpleTextFastPath)
+{
+	// more strings than the layout cache can hold, like the values of a moving control
+	constexpr auto count = static_cast<uint32_t> (Cairo::Font::kLayoutCacheCapacity * 4);
+	auto font = makeOwned<Cairo::Font> ("Sans", 12., kNormalFace);
+	auto pangoTime = drawValueStrings (font, count, false);
+	auto fastPathTime = drawValueStrings (font, count, true);
+	printf ("Drawing %u value strings: Pango %f ms, glyph fast path %f ms\n", count, pangoTime,
+			fastPathTime);
+}
+
+//------------------------------------------------------------------------
+} // VSTGUI
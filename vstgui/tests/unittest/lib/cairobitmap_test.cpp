@@ -0,0 +1,174 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/platform/linux/cairobitmap.h"
+#include "../../../lib/platform/linux/cairocontext.h"
+#include "../../../lib/cbitmap.h"
+#include "../../../lib/cbitmapfilter.h"
+#include "../unittests.h"
+#include <cstring>
+
+namespace VSTGUI {
+
+TEST_CASE (CairoBitmapTest, PatternIsCachedPerFilter)
+{
+	auto bitmap = makeOwned<Cairo::Bitmap> (CPoint (4, 4));
+	auto pattern = bitmap->getPattern (CAIRO_FILTER_GOOD);
+	EXPECT_TRUE (pattern);
+	EXPECT_EQ (static_cast<cairo_pattern_t*> (bitmap->getPattern (CAIRO_FILTER_GOOD)),
+			   static_cast<cairo_pattern_t*> (pattern));
+	EXPECT_NE (static_cast<cairo_pattern_t*> (bitmap->getPattern (CAIRO_FILTER_NEAREST)),
+			   static_cast<cairo_pattern_t*> (pattern));
+}
+
+TEST_CASE (CairoBitmapTest, LockPixelsClearsCache)
+{
+	auto bitmap = makeOwned<Cairo::Bitmap> (CPoint (4, 4));
+	auto pattern = bitmap->getPattern (CAIRO_FILTER_GOOD);
+	{
+		auto pixelAccess = bitmap->lockPixels (true);
+		EXPECT_TRUE (pixelAccess);
+		EXPECT_FALSE (bitmap->getPattern (CAIRO_FILTER_GOOD));
+	}
+	EXPECT_NE (static_cast<cairo_pattern_t*> (bitmap->getPattern (CAIRO_FILTER_GOOD)),
+			   static_cast<cairo_pattern_t*> (pattern));
+}
+
+TEST_CASE (CairoBitmapTest, DrawWithOffset)
+{
+	auto platformBitmap = makeOwned<Cairo::Bitmap> (CPoint (4, 4));
+	{
+		auto pixelAccess = platformBitmap->lockPixels (true);
+		auto address = pixelAccess->getAddress ();
+		auto bytesPerRow = pixelAccess->getBytesPerRow ();
+		memset (address, 0, bytesPerRow * 4);
+		// a red pixel at 2, 1
+		uint8_t red[] = {0, 0, 255, 255};
+		memcpy (address + bytesPerRow + 2 * 4, red, 4);
+	}
+	auto bitmap = makeOwned<CBitmap> (platformBitmap);
+
+	auto drawContext = makeOwned<Cairo::Context> (CRect (0, 0, 4, 4), target);
+	drawContext->beginDraw ();
+	drawContext->setBitmapInterpolationQuality (BitmapInterpolationQuality::kLow);
+	drawContext->drawBitmap (bitmap, CRect (1, 1, 3, 3), CPoint (2, 1), 1.f);
+	// draw a second time to use the cached pattern
+	drawContext->drawBitmap (bitmap, CRect (1, 1, 3, 3), CPoint (2, 1), 1.f);
+	drawContext->endDraw ();
+
+	auto data = cairo_image_surface_get_data (target);
+	auto stride = cairo_image_surface_get_stride (target);
+	for (auto y = 0; y < 4; ++y)
+	{
+		for (auto x = 0; x < 4; ++x)
+		{
+			auto pixel = data + y * stride + x * 4;
+			if (x == 1 && y == 1)
+			{
+				EXPECT_EQ (pixel[2], 255);
+			}
+			else
+			{
+				EXPECT_EQ (pixel[3], 0);
+			}
+		}
+	}
+}
+
+TEST_CASE (CairoBitmapTest, StraightAlphaPixelAccess)
+{
+	auto bitmap = makeOwned<Cairo::Bitmap> (CPoint (4, 3));
+	// BGRA with premultiplied alpha
+	uint8_t premultiplied[] = {20, 40, 60, 128};
+	{
+		auto pixelAccess = bitmap->lockPixels (true);
+		auto address = pixelAccess->getAddress ();
+		auto bytesPerRow = pixelAccess->getBytesPerRow ();
+		for (auto y = 0u; y < 3u; ++y)
+		{
+			for (auto x = 0u; x < 4u; ++x)
+				memcpy (address + y * bytesPerRow + x * 4, premultiplied, 4);
+		}
+	}
+	{
+		// all rows are valid without prepareRows
+		auto pixelAccess = bitmap->lockPixels (false);
+		auto address = pixelAccess->getAddress ();
+		auto bytesPerRow = pixelAccess->getBytesPerRow ();
+		EXPECT_EQ (address[0], 40);
+		EXPECT_EQ (address[1], 80);
+		EXPECT_EQ (address[2], 120);
+		EXPECT_EQ (address[3], 128);
+		EXPECT_EQ (address[2 * bytesPerRow + 12], 40);
+		EXPECT_EQ (address[2 * bytesPerRow + 15], 128);
+		uint8_t straight[] = {255, 0, 0, 64};
+		memcpy (address + bytesPerRow, straight, 4);
+	}
+	auto pixelAccess = bitmap->lockPixels (true);
+	auto address = pixelAccess->getAddress ();
+	auto bytesPerRow = pixelAccess->getBytesPerRow ();
+	uint8_t changed[] = {64, 0, 0, 64};
+	EXPECT_EQ (memcmp (address + bytesPerRow, changed, 4), 0);
+	for (auto y = 0u; y < 3u; ++y)
+	{
+		for (auto x = 0u; x < 4u; ++x)
+		{
+			if (x == 0 && y == 1)
+				continue;
+			EXPECT_EQ (memcmp (address + y * bytesPerRow + x * 4, premultiplied, 4), 0);
+		}
+	}
+}
+
+TEST_CASE (CairoBitmapTest, StraightAlphaKeepsUnpreparedRows)
+{
+	auto bitmap = makeOwned<Cairo::Bitmap> (CPoint (2, 2));
+	// not a valid premultiplied pixel, so converting it would change it
+	uint8_t invalid[] = {200, 200, 200, 100};
+	{
+		auto pixelAccess = bitmap->lockPixels (true);
+		auto address = pixelAccess->getAddress ();
+		auto bytesPerRow = pixelAccess->getBytesPerRow ();
+		memcpy (address + bytesPerRow, invalid, 4);
+	}
+	{
+		auto pixelAccess = bitmap->lockPixelsOnDemand (false);
+		pixelAccess->prepareRows (0, 1);
+		uint8_t straight[] = {255, 255, 255, 255};
+		memcpy (pixelAccess->getAddress (), straight, 4);
+	}
+	auto pixelAccess = bitmap->lockPixels (true);
+	auto address = pixelAccess->getAddress ();
+	auto bytesPerRow = pixelAccess->getBytesPerRow ();
+	EXPECT_EQ (address[0], 255);
+	EXPECT_EQ (address[3], 255);
+	EXPECT_EQ (memcmp (address + bytesPerRow, invalid, 4), 0);
+}
+
+TEST_CASE (CairoBitmapTest, ReplaceColorUsesStraightAlpha)
+{
+	auto bitmap = makeOwned<CBitmap> (makeOwned<Cairo::Bitmap> (CPoint (4, 3)));
+	// survives the premultiplication in the surface unchanged
+	CColor color (255, 0, 255, 128);
+	if (auto access = owned (CBitmapPixelAccess::create (bitmap, false)))
+	{
+		do
+		{
+			access->setColor (color);
+		} while (++*access);
+	}
+	auto filter = owned (BitmapFilter::Factory::getInstance ().createFilter (
+		BitmapFilter::Standard::kReplaceColor));
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap.get ());
+	filter->setProperty (BitmapFilter::Standard::Property::kInputColor, color);
+	filter->setProperty (BitmapFilter::Standard::Property::kOutputColor, kBlueCColor);
+	EXPECT_TRUE (filter->run (true));
+	auto access = owned (CBitmapPixelAccess::create (bitmap, false));
+	access->setPosition (2, 1);
+	CColor result;
+	access->getColor (result);
+	EXPECT_EQ (result, kBlueCColor);
+}
+
+} // VSTGUI
@@ -0,0 +1,140 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/platform/linux/cairocontext.h"
+#include "../../../lib/platform/linux/cairofont.h"
+#include "../../../lib/cfont.h"
+#include "../../../lib/cstring.h"
+#include "../unittests.h"
+#include <string>
+#include <vector>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+struct SimpleTextFastPathScope
+{
+	explicit SimpleTextFastPathScope (bool state)
+	: oldState (Cairo::Font::isSimpleTextFastPathEnabled ())
+	{
+		Cairo::Font::setSimpleTextFastPathEnabled (state);
+	}
+	~SimpleTextFastPathScope () noexcept { Cairo::Font::setSimpleTextFastPathEnabled (oldState); }
+
+	bool oldState;
+};
+
+} // anonymous
+
+TEST_CASE (CairoFontTest, LayoutCacheServesRepeatedMeasuring)
+{
+	SimpleTextFastPathScope fastPath (false);
+	auto font = makeOwned<Cairo::Font> ("Sans", 12., kNormalFace);
+	Cairo::Font::clearLayoutCache ();
+	auto before = Cairo::Font::getLayoutCacheStatistics ();
+	EXPECT_EQ (before.entries, 0u);
+
+	UTF8String text ("Cutoff");
+	auto width = font->getStringWidth (nullptr, text.getPlatformString ());
+	auto afterFirst = Cairo::Font::getLayoutCacheStatistics ();
+	EXPECT_EQ (afterFirst.misses, before.misses + 1);
+	EXPECT_EQ (afterFirst.entries, 1u);
+
+	EXPECT_EQ (font->getStringWidth (nullptr, text.getPlatformString ()), width);
+	auto afterSecond = Cairo::Font::getLayoutCacheStatistics ();
+	EXPECT_EQ (afterSecond.hits, afterFirst.hits + 1);
+	EXPECT_EQ (afterSecond.misses, afterFirst.misses);
+
+	auto boldFont = makeOwned<Cairo::Font> ("Sans", 12., kBoldFace);
+	boldFont->getStringWidth (nullptr, text.getPlatformString ());
+	EXPECT_EQ (Cairo::Font::getLayoutCacheStatistics ().entries, 2u);
+}
+
+TEST_CASE (CairoFontTest, LayoutCacheIsBounded)
+{
+	SimpleTextFastPathScope fastPath (false);
+	auto font = makeOwned<Cairo::Font> ("Sans", 12., kNormalFace);
+	Cairo::Font::clearLayoutCache ();
+	for (auto i = 0u; i < Cairo::Font::kLayoutCacheCapacity + 10; ++i)
+	{
+		UTF8String text (std::to_string (i));
+		font->getStringWidth (nullptr, text.getPlatformString ());
+	}
+	EXPECT_EQ (Cairo::Font::getLayoutCacheStatistics ().entries,
+			   Cairo::Font::kLayoutCacheCapacity);
+	// the oldest strings were removed
+	auto misses = Cairo::Font::getLayoutCacheStatistics ().misses;
+	UTF8String text ("0");
+	font->getStringWidth (nullptr, text.getPlatformString ());
+	EXPECT_EQ (Cairo::Font::getLayoutCacheStatistics ().misses, misses + 1);
+	Cairo::Font::clearLayoutCache ();
+}
+
+TEST_CASE (CairoFontTest, SimpleTextBypassesLayoutCache)
+{
+	SimpleTextFastPathScope fastPath (true);
+	auto font = makeOwned<Cairo::Font> ("Sans", 12., kNormalFace);
+	Cairo::Font::clearLayoutCache ();
+	UTF8String simpleText ("-12.5 dB");
+	EXPECT_TRUE (font->getStringWidth (nullptr, simpleText.getPlatformString ()) > 0.);
+	EXPECT_EQ (Cairo::Font::getLayoutCacheStatistics ().entries, 0u);
+
+	UTF8String complexText ("Gr\xC3\xB6\xC3\x9F" "e");
+	font->getStringWidth (nullptr, complexText.getPlatformString ());
+	EXPECT_EQ (Cairo::Font::getLayoutCacheStatistics ().entries, 1u);
+
+	auto underlineFont = makeOwned<Cairo::Font> ("Sans", 12., kUnderlineFace);
+	underlineFont->getStringWidth (nullptr, simpleText.getPlatformString ());
+	EXPECT_EQ (Cairo::Font::getLayoutCacheStatistics ().entries, 2u);
+	Cairo::Font::clearLayoutCache ();
+}
+
+TEST_CASE (CairoFontTest, SimpleTextWidthMatchesPango)
+{
+	auto font = makeOwned<Cairo::Font> ("Sans", 12., kNormalFace);
+	for (std::string str : {"0.000", "-48.0 dB", "100 %", "AVATAR", "To, Ty. Wa", "Office"})
+	{
+		// every prefix, so that each advance is compared
+		for (size_t length = 1; length <= str.size (); ++length)
+		{
+			UTF8String text (str.substr (0, length));
+			CCoord fastWidth;
+			CCoord pangoWidth;
+			{
+				SimpleTextFastPathScope fastPath (true);
+				fastWidth = font->getStringWidth (nullptr, text.getPlatformString ());
+			}
+			{
+				SimpleTextFastPathScope fastPath (false);
+				pangoWidth = font->getStringWidth (nullptr, text.getPlatformString ());
+			}
+			EXPECT_EQ (fastWidth, pangoWidth);
+		}
+	}
+	Cairo::Font::clearLayoutCache ();
+}
+
+TEST_CASE (CairoFontTest, DrawnSimpleTextMatchesPango)
+{
+	auto font = makeOwned<Cairo::Font> ("Sans", 12., kNormalFace);
+	UTF8String text ("AVATAR -12.5 dB");
+	auto draw = [&] (bool fastPath) {
+		SimpleTextFastPathScope scope (fastPath);
+		Cairo::SurfaceHandle surface (cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 120, 20));
+		auto context = makeOwned<Cairo::Context> (CRect (0, 0, 120, 20), surface);
+		context->beginDraw ();
+		context->setFontColor (kBlackCColor);
+		font->drawString (context, text.getPlatformString (), CPoint (2, 15));
+		context->endDraw ();
+		auto data = cairo_image_surface_get_data (surface);
+		auto size = static_cast<size_t> (cairo_image_surface_get_stride (surface)) * 20;
+		return std::vector<uint8_t> (data, data + size);
+	};
+	EXPECT_TRUE (draw (true) == draw (false));
+	Cairo::Font::clearLayoutCache ();
+}
+
+} // VSTGUI
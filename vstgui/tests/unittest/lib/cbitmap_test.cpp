@@ -4,9 +4,13 @@
 
 #include "../../../lib/cbitmap.h"
 #include "../../../lib/ccolor.h"
+#include "../../../lib/coffscreencontext.h"
 #include "../../../lib/platform/iplatformbitmap.h"
 #include "../../../lib/platform/platformfactory.h"
 #include "../unittests.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace VSTGUI {
 
@@ -33,6 +37,112 @@ TEST_CASE (CBitmap, ScaleFactor)
 	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (2.6), b2);
 }
 
+//------------------------------------------------------------------------
+namespace {
+
+//------------------------------------------------------------------------
+struct ScaledVariantsScope
+{
+	ScaledVariantsScope (bool state) : previous (CBitmap::isScaledVariantsEnabled ())
+	{
+		CBitmap::setScaledVariantsEnabled (state);
+	}
+	~ScaledVariantsScope () noexcept { CBitmap::setScaledVariantsEnabled (previous); }
+
+	bool previous;
+};
+
+//------------------------------------------------------------------------
+/** a platform bitmap which counts how often its pixels are locked */
+struct LockCountingBitmap : IPlatformBitmap
+{
+	LockCountingBitmap (const PlatformBitmapPtr& bitmap) : bitmap (bitmap) {}
+
+	const CPoint& getSize () const override { return bitmap->getSize (); }
+	SharedPointer<IPlatformBitmapPixelAccess> lockPixels (bool alphaPremultiplied) override
+	{
+		++numLocks;
+		return bitmap->lockPixels (alphaPremultiplied);
+	}
+	void setScaleFactor (double factor) override { bitmap->setScaleFactor (factor); }
+	double getScaleFactor () const override { return bitmap->getScaleFactor (); }
+
+	PlatformBitmapPtr bitmap;
+	uint32_t numLocks {0};
+};
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmap, ScaledVariants)
+{
+	auto b1 = getPlatformFactory ().createBitmap ({10, 10});
+	CBitmap bitmap (b1);
+	auto b2 = makeOwned<LockCountingBitmap> (getPlatformFactory ().createBitmap ({20, 20}));
+	b2->setScaleFactor (2.);
+	EXPECT_TRUE (bitmap.addBitmap (b2));
+
+	ScaledVariantsScope scope (true);
+	auto variant = bitmap.getBestPlatformBitmapForScaleFactor (1.5);
+	EXPECT_TRUE (variant);
+	EXPECT_EQ (variant->getScaleFactor (), 1.5);
+	EXPECT_EQ (variant->getSize (), CPoint (15, 15));
+	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (1.5), variant);
+	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (2.), b2);
+	// the source may be drawn on other threads while the variant is created
+	EXPECT_EQ (b2->numLocks, 0u);
+
+	CBitmap::clearAllScaledVariants ();
+	auto newVariant = bitmap.getBestPlatformBitmapForScaleFactor (1.5);
+	EXPECT_NE (newVariant, variant);
+	bitmap.clearScaledVariants ();
+	EXPECT_NE (bitmap.getBestPlatformBitmapForScaleFactor (1.5), newVariant);
+
+	// scale factors near a variant share it
+	newVariant = bitmap.getBestPlatformBitmapForScaleFactor (1.5);
+	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (1.45), newVariant);
+	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (1.55), newVariant);
+	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (1.95), b2);
+
+	CBitmap::setScaledVariantsEnabled (false);
+	EXPECT_EQ (bitmap.getBestPlatformBitmapForScaleFactor (1.5), b2);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmap, ScaledVariantPixels)
+{
+	auto b1 = getPlatformFactory ().createBitmap ({10, 10});
+	CBitmap bitmap (b1);
+	auto b2 = getPlatformFactory ().createBitmap ({20, 20});
+	b2->setScaleFactor (2.);
+	EXPECT_TRUE (bitmap.addBitmap (b2));
+	{
+		CBitmap source (b2);
+		auto accessor = owned (CBitmapPixelAccess::create (&source));
+		EXPECT (accessor);
+		do
+		{
+			accessor->setColor (kRedCColor);
+		} while (++(*accessor));
+	}
+
+	ScaledVariantsScope scope (true);
+	auto variant = bitmap.getBestPlatformBitmapForScaleFactor (1.5);
+	EXPECT_TRUE (variant);
+	EXPECT_NE (variant, b2);
+	CBitmap variantBitmap (variant);
+	auto accessor = owned (CBitmapPixelAccess::create (&variantBitmap));
+	EXPECT (accessor);
+	CColor color;
+	do
+	{
+		accessor->getColor (color);
+		// the filter weights may not add up to exactly one
+		EXPECT (color.red >= 254 && color.green <= 1 && color.blue <= 1 && color.alpha >= 254);
+	} while (++(*accessor));
+}
+
 //------------------------------------------------------------------------
 TEST_CASE (CBitmap, PixelAccess)
 {
@@ -91,6 +201,194 @@ TEST_CASE (CBitmap, PixelAccess2)
 	}
 }
 
+//------------------------------------------------------------------------
+TEST_CASE (CBitmap, PixelAccessRows)
+{
+	CBitmap bitmap (7, 5);
+	if (auto accessor = owned (CBitmapPixelAccess::create (&bitmap)))
+	{
+		for (auto y = 0u; y < accessor->getBitmapHeight (); ++y)
+		{
+			auto row = accessor->getRow (y);
+			EXPECT_EQ (row.getY (), y);
+			EXPECT_EQ (row.getWidth (), 7u);
+			EXPECT_EQ (row.end () - row.begin (), 7);
+			for (auto x = 0u; x < row.getWidth (); ++x)
+				row.setColor (x, CColor (static_cast<uint8_t> (x), static_cast<uint8_t> (y), 3, 200));
+		}
+	}
+	if (auto accessor = owned (CBitmapPixelAccess::create (&bitmap)))
+	{
+		do
+		{
+			CColor color;
+			accessor->getColor (color);
+			EXPECT_EQ (color, CColor (static_cast<uint8_t> (accessor->getX ()),
+									  static_cast<uint8_t> (accessor->getY ()), 3, 200));
+			uint32_t value;
+			accessor->getValue (value);
+			EXPECT_EQ (value, accessor->getRow (accessor->getY ()).begin ()[accessor->getX ()]);
+			CColor rowColor;
+			accessor->getRow (accessor->getY ()).getColor (accessor->getX (), rowColor);
+			EXPECT_EQ (rowColor, color);
+		} while (++(*accessor));
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CBitmap, PixelAccessForEachRow)
+{
+	// large enough for several threads
+	CBitmap bitmap (700, 600);
+	auto accessor = owned (CBitmapPixelAccess::create (&bitmap));
+	EXPECT_TRUE (accessor);
+	std::vector<std::atomic<uint32_t>> rowCalls (600);
+	accessor->forEachRow ([&] (const CBitmapPixelAccess::Row& row) {
+		++rowCalls[row.getY ()];
+		for (auto& pixel : row)
+			pixel = row.getY ();
+	});
+	EXPECT_TRUE (std::all_of (rowCalls.begin (), rowCalls.end (),
+							  [] (const std::atomic<uint32_t>& calls) { return calls == 1u; }));
+	bool allSet = true;
+	accessor->forEachRow (
+		[&] (const CBitmapPixelAccess::Row& row) {
+			for (auto pixel : row)
+			{
+				if (pixel != row.getY ())
+					allSet = false;
+			}
+		},
+		false);
+	EXPECT_TRUE (allSet);
+}
+
+//------------------------------------------------------------------------
+//------------------------------------------------------------------------
+//------------------------------------------------------------------------
+namespace {
+
+//------------------------------------------------------------------------
+void fillNinePartBitmap (CBitmap& bitmap, uint8_t value)
+{
+	if (auto accessor = owned (CBitmapPixelAccess::create (&bitmap)))
+	{
+		do
+		{
+			auto x = static_cast<uint8_t> (accessor->getX ());
+			auto y = static_cast<uint8_t> (accessor->getY ());
+			accessor->setColor (CColor (x * 20, y * 20, value, 255));
+		} while (++(*accessor));
+	}
+}
+
+//------------------------------------------------------------------------
+struct RenderCacheScope
+{
+	RenderCacheScope (bool state) : previous (CNinePartTiledBitmap::isRenderCacheEnabled ())
+	{
+		CNinePartTiledBitmap::setRenderCacheEnabled (state);
+	}
+	~RenderCacheScope () noexcept { CNinePartTiledBitmap::setRenderCacheEnabled (previous); }
+
+	bool previous;
+};
+
+//------------------------------------------------------------------------
+struct RenderCachePixelBudgetScope
+{
+	RenderCachePixelBudgetScope (CCoord numPixels)
+	: previous (CNinePartTiledBitmap::getRenderCachePixelBudget ())
+	{
+		CNinePartTiledBitmap::setRenderCachePixelBudget (numPixels);
+	}
+	~RenderCachePixelBudgetScope () noexcept
+	{
+		CNinePartTiledBitmap::setRenderCachePixelBudget (previous);
+	}
+
+	CCoord previous;
+};
+
+//------------------------------------------------------------------------
+std::vector<CColor> drawNinePartBitmap (CNinePartTiledBitmap& bitmap, const CRect& rect,
+										bool renderCache)
+{
+	std::vector<CColor> result;
+	auto drawContext = COffscreenContext::create ({rect.right, rect.bottom});
+	if (!drawContext)
+		return result;
+	RenderCacheScope scope (renderCache);
+	drawContext->beginDraw ();
+	bitmap.draw (drawContext, rect);
+	drawContext->endDraw ();
+	if (auto accessor = owned (CBitmapPixelAccess::create (drawContext->getBitmap ())))
+	{
+		do
+		{
+			CColor c;
+			accessor->getColor (c);
+			result.emplace_back (c);
+		} while (++(*accessor));
+	}
+	return result;
+}
+
+//------------------------------------------------------------------------
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CNinePartTiledBitmap, RenderCacheDrawsLikeParts)
+{
+	CNinePartTiledBitmap bitmap (getPlatformFactory ().createBitmap ({9, 9}),
+								 CNinePartTiledDescription (3, 3, 3, 3));
+	fillNinePartBitmap (bitmap, 0);
+	for (auto rect : {CRect (0, 0, 20, 14), CRect (5, 2, 40, 30), CRect (0, 0, 20, 14)})
+	{
+		EXPECT_TRUE (drawNinePartBitmap (bitmap, rect, true) ==
+					 drawNinePartBitmap (bitmap, rect, false));
+	}
+	// the cache is dropped when the pixels change
+	fillNinePartBitmap (bitmap, 100);
+	EXPECT_TRUE (drawNinePartBitmap (bitmap, CRect (0, 0, 20, 14), true) ==
+				 drawNinePartBitmap (bitmap, CRect (0, 0, 20, 14), false));
+	// and when the part offsets change
+	bitmap.setPartOffsets (CNinePartTiledDescription (2, 4, 4, 2));
+	EXPECT_TRUE (drawNinePartBitmap (bitmap, CRect (0, 0, 20, 14), true) ==
+				 drawNinePartBitmap (bitmap, CRect (0, 0, 20, 14), false));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CNinePartTiledBitmap, RenderCacheSharesPixelBudget)
+{
+	RenderCachePixelBudgetScope budgetScope (1000.);
+	CBitmap::clearAllScaledVariants ();
+	auto createBitmap = [] () {
+		auto bitmap = makeOwned<CNinePartTiledBitmap> (getPlatformFactory ().createBitmap ({9, 9}),
+													   CNinePartTiledDescription (3, 3, 3, 3));
+		fillNinePartBitmap (*bitmap, 0);
+		return bitmap;
+	};
+	auto bitmap1 = createBitmap ();
+	auto bitmap2 = createBitmap ();
+	drawNinePartBitmap (*bitmap1, CRect (0, 0, 10, 20), true);
+	drawNinePartBitmap (*bitmap2, CRect (0, 0, 10, 20), true);
+	drawNinePartBitmap (*bitmap2, CRect (0, 0, 10, 25), true);
+	drawNinePartBitmap (*bitmap1, CRect (0, 0, 10, 20), true);
+	drawNinePartBitmap (*bitmap1, CRect (0, 0, 10, 24), true);
+	EXPECT_EQ (CNinePartTiledBitmap::getRenderCachePixelCount (), 890.);
+	// evicts the least recently used size, which belongs to the other bitmap
+	drawNinePartBitmap (*bitmap1, CRect (0, 0, 10, 15), true);
+	EXPECT_EQ (CNinePartTiledBitmap::getRenderCachePixelCount (), 840.);
+	// a single size may only use a quarter of the budget
+	drawNinePartBitmap (*bitmap1, CRect (0, 0, 10, 26), true);
+	EXPECT_EQ (CNinePartTiledBitmap::getRenderCachePixelCount (), 840.);
+	bitmap2 = nullptr;
+	EXPECT_EQ (CNinePartTiledBitmap::getRenderCachePixelCount (), 590.);
+	bitmap1 = nullptr;
+	EXPECT_EQ (CNinePartTiledBitmap::getRenderCachePixelCount (), 0.);
+}
+
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
@@ -0,0 +1,355 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cbitmap.h"
+#include "../../../lib/cbitmapfilter.h"
+#include "../../../lib/ccolor.h"
+#include "../unittests.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace VSTGUI {
+
+namespace {
+
+using Plane = std::vector<uint8_t>;
+
+//------------------------------------------------------------------------
+/** box blur with the edge values repeated */
+void blurReference (Plane& plane, int32_t width, int32_t height, int32_t radius, bool rows)
+{
+	Plane result (plane.size ());
+	auto length = rows ? width : height;
+	auto count = rows ? height : width;
+	for (auto i = 0; i < count; ++i)
+	{
+		auto value = [&] (int32_t pos) {
+			pos = std::min (std::max (pos, 0), length - 1);
+			return rows ? plane[i * width + pos] : plane[pos * width + i];
+		};
+		for (auto pos = 0; pos < length; ++pos)
+		{
+			int32_t sum = 0;
+			for (auto j = pos - radius; j <= pos + radius; ++j)
+				sum += value (j);
+			auto& output = rows ? result[i * width + pos] : result[pos * width + i];
+			output = static_cast<uint8_t> (sum / (radius * 2 + 1));
+		}
+	}
+	plane = std::move (result);
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> createRandomBitmap (uint32_t width, uint32_t height)
+{
+	auto bitmap = makeOwned<CBitmap> (CPoint (width, height));
+	std::mt19937 random (width * 7 + height);
+	if (auto accessor = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+		{
+			auto value = random ();
+			accessor->setColor (CColor (value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF,
+										(value >> 24) & 0xFF));
+		} while (++(*accessor));
+	}
+	return bitmap;
+}
+
+//------------------------------------------------------------------------
+std::vector<Plane> getPlanes (CBitmap* bitmap)
+{
+	auto width = static_cast<uint32_t> (bitmap->getWidth ());
+	auto height = static_cast<uint32_t> (bitmap->getHeight ());
+	std::vector<Plane> planes (4, Plane (width * height));
+	if (auto accessor = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+		{
+			CColor color;
+			accessor->getColor (color);
+			auto index = accessor->getY () * width + accessor->getX ();
+			planes[0][index] = color.red;
+			planes[1][index] = color.green;
+			planes[2][index] = color.blue;
+			planes[3][index] = color.alpha;
+		} while (++(*accessor));
+	}
+	return planes;
+}
+
+//------------------------------------------------------------------------
+bool blurMatchesReference (IdStringPtr filterName, IdStringPtr sizeProperty,
+						   BitmapFilter::Property size, const std::vector<int32_t>& radii,
+						   uint32_t width, uint32_t height)
+{
+	auto bitmap = createRandomBitmap (width, height);
+	auto expected = getPlanes (bitmap);
+	for (auto& plane : expected)
+	{
+		for (auto radius : radii)
+			blurReference (plane, width, height, radius, true);
+		for (auto radius : radii)
+			blurReference (plane, width, height, radius, false);
+	}
+	auto filter = owned (BitmapFilter::Factory::getInstance ().createFilter (filterName));
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap.get ());
+	filter->setProperty (sizeProperty, size);
+	if (!filter->run (true))
+		return false;
+	return getPlanes (bitmap) == expected;
+}
+
+//------------------------------------------------------------------------
+/** the filters of a skin bitmap, the scale needs a new bitmap */
+std::vector<SharedPointer<BitmapFilter::IFilter>> createFilterChain ()
+{
+	using namespace BitmapFilter::Standard;
+	auto& factory = BitmapFilter::Factory::getInstance ();
+	std::vector<SharedPointer<BitmapFilter::IFilter>> filters;
+	filters.push_back (owned (factory.createFilter (kGrayscale)));
+	filters.push_back (owned (factory.createFilter (kReplaceColor)));
+	filters.back ()->setProperty (Property::kInputColor, CColor (0x80, 0x80, 0x80, 0x80));
+	filters.push_back (owned (factory.createFilter (kGaussianBlur)));
+	filters.push_back (owned (factory.createFilter (kSetColor)));
+	filters.back ()->setProperty (Property::kInputColor, CColor (10, 20, 30, 40));
+	filters.push_back (owned (factory.createFilter (kScaleBilinear)));
+	filters.back ()->setProperty (Property::kOutputRect, CRect (0, 0, 50, 30));
+	filters.push_back (owned (factory.createFilter (kGrayscale)));
+	return filters;
+}
+
+//------------------------------------------------------------------------
+/** the scale filters expect premultiplied colors */
+void limitColorsToAlpha (CBitmap* bitmap)
+{
+	if (auto accessor = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+		{
+			CColor color;
+			accessor->getColor (color);
+			color.red = std::min (color.red, color.alpha);
+			color.green = std::min (color.green, color.alpha);
+			color.blue = std::min (color.blue, color.alpha);
+			accessor->setColor (color);
+		} while (++(*accessor));
+	}
+}
+
+//------------------------------------------------------------------------
+SharedPointer<CBitmap> runScale (IdStringPtr filterName, CBitmap* bitmap, uint32_t width,
+								 uint32_t height)
+{
+	auto filter = owned (BitmapFilter::Factory::getInstance ().createFilter (filterName));
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
+	filter->setProperty (BitmapFilter::Standard::Property::kOutputRect,
+						 CRect (0, 0, width, height));
+	if (!filter->run ())
+		return nullptr;
+	return dynamic_cast<CBitmap*> (
+		filter->getProperty (BitmapFilter::Standard::Property::kOutputBitmap).getObject ());
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, BoxBlur)
+{
+	using namespace BitmapFilter::Standard;
+	EXPECT_TRUE (blurMatchesReference (kBoxBlur, Property::kRadius, 11, {5}, 37, 23));
+	EXPECT_TRUE (blurMatchesReference (kBoxBlur, Property::kRadius, 4, {2}, 3, 50));
+	// larger than the image
+	EXPECT_TRUE (blurMatchesReference (kBoxBlur, Property::kRadius, 40, {20}, 10, 7));
+	// large enough for several threads
+	EXPECT_TRUE (blurMatchesReference (kBoxBlur, Property::kRadius, 6, {3}, 701, 400));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, GaussianBlur)
+{
+	using namespace BitmapFilter::Standard;
+	// the box sizes for a standard deviation of 5 are 9, 11 and 11
+	EXPECT_TRUE (
+		blurMatchesReference (kGaussianBlur, Property::kStandardDeviation, 5., {4, 5, 5}, 61, 42));
+	EXPECT_TRUE (blurMatchesReference (kGaussianBlur, Property::kStandardDeviation, 5., {4, 5, 5},
+									   701, 400));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, BlurAlphaChannelOnly)
+{
+	auto bitmap = createRandomBitmap (20, 20);
+	auto before = getPlanes (bitmap);
+	auto filter = owned (
+		BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kGaussianBlur));
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap.get ());
+	filter->setProperty (BitmapFilter::Standard::Property::kAlphaChannelOnly, 1);
+	EXPECT_TRUE (filter->run (true));
+	auto after = getPlanes (bitmap);
+	EXPECT_TRUE (after[0] == before[0]);
+	EXPECT_TRUE (after[1] == before[1]);
+	EXPECT_TRUE (after[2] == before[2]);
+	EXPECT_TRUE (after[3] != before[3]);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, BlurOutputBitmap)
+{
+	auto bitmap = createRandomBitmap (20, 10);
+	auto before = getPlanes (bitmap);
+	auto filter = owned (
+		BitmapFilter::Factory::getInstance ().createFilter (BitmapFilter::Standard::kBoxBlur));
+	filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap.get ());
+	filter->setProperty (BitmapFilter::Standard::Property::kRadius, 4);
+	EXPECT_TRUE (filter->run (false));
+	auto output = dynamic_cast<CBitmap*> (
+		filter->getProperty (BitmapFilter::Standard::Property::kOutputBitmap).getObject ());
+	EXPECT_TRUE (output);
+	EXPECT_NE (output, bitmap.get ());
+	EXPECT_EQ (output->getSize (), bitmap->getSize ());
+	EXPECT_TRUE (getPlanes (bitmap) == before);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, PipelineMatchesSingleFilters)
+{
+	auto bitmap = createRandomBitmap (64, 48);
+	auto before = getPlanes (bitmap);
+
+	SharedPointer<CBitmap> expected = bitmap;
+	for (auto& filter : createFilterChain ())
+	{
+		filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, expected.get ());
+		EXPECT_TRUE (filter->run (false));
+		expected = dynamic_cast<CBitmap*> (
+			filter->getProperty (BitmapFilter::Standard::Property::kOutputBitmap).getObject ());
+	}
+
+	BitmapFilter::Pipeline pipeline;
+	for (auto& filter : createFilterChain ())
+		pipeline.addFilter (filter);
+	auto result = pipeline.run (bitmap);
+	EXPECT_TRUE (result);
+	EXPECT_EQ (result->getSize (), CPoint (50, 30));
+	EXPECT_TRUE (getPlanes (result) == getPlanes (expected));
+	EXPECT_TRUE (getPlanes (bitmap) == before);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, PipelineSkipsFailingFilters)
+{
+	using namespace BitmapFilter::Standard;
+	auto bitmap = createRandomBitmap (20, 10);
+	auto& factory = BitmapFilter::Factory::getInstance ();
+	auto scale = owned (factory.createFilter (kScaleLinear));
+	scale->setProperty (Property::kOutputRect, CRect ());
+
+	BitmapFilter::Pipeline pipeline;
+	pipeline.addFilter (scale);
+	EXPECT_FALSE (pipeline.run (bitmap));
+
+	auto grayscale = owned (factory.createFilter (kGrayscale));
+	pipeline.addFilter (grayscale);
+	auto result = pipeline.run (bitmap);
+	EXPECT_TRUE (result);
+	grayscale->setProperty (Property::kInputBitmap, bitmap.get ());
+	EXPECT_TRUE (grayscale->run (false));
+	auto expected = dynamic_cast<CBitmap*> (grayscale->getProperty (Property::kOutputBitmap).getObject ());
+	EXPECT_TRUE (getPlanes (result) == getPlanes (expected));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, ScaleAreaAverage)
+{
+	auto bitmap = createRandomBitmap (40, 20);
+	limitColorsToAlpha (bitmap);
+	auto input = getPlanes (bitmap);
+	auto output = runScale (BitmapFilter::Standard::kScaleAreaAverage, bitmap, 10, 5);
+	EXPECT_TRUE (output);
+	EXPECT_EQ (output->getSize (), CPoint (10, 5));
+	auto planes = getPlanes (output);
+	bool averaged = true;
+	for (auto channel = 0u; channel < 4; ++channel)
+	{
+		for (auto y = 0u; y < 5; ++y)
+		{
+			for (auto x = 0u; x < 10; ++x)
+			{
+				uint32_t sum = 0;
+				for (auto i = 0u; i < 16; ++i)
+					sum += input[channel][(y * 4 + i / 4) * 40 + x * 4 + i % 4];
+				int32_t difference = planes[channel][y * 10 + x] - static_cast<int32_t> ((sum + 8) / 16);
+				if (std::abs (difference) > 1)
+					averaged = false;
+			}
+		}
+	}
+	EXPECT_TRUE (averaged);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, ScaleKeepsConstantColors)
+{
+	using namespace BitmapFilter::Standard;
+	CColor color (20, 40, 60, 200);
+	auto bitmap = makeOwned<CBitmap> (CPoint (33, 17));
+	if (auto accessor = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+			accessor->setColor (color);
+		while (++(*accessor));
+	}
+	for (auto filterName : {kScaleAreaAverage, kScaleLanczos})
+	{
+		for (auto size : {CPoint (10, 3), CPoint (1, 1), CPoint (70, 40)})
+		{
+			auto output = runScale (filterName, bitmap, static_cast<uint32_t> (size.x),
+									static_cast<uint32_t> (size.y));
+			EXPECT_TRUE (output);
+			EXPECT_EQ (output->getSize (), size);
+			auto planes = getPlanes (output);
+			auto isConstant = [] (const Plane& plane, uint8_t value) {
+				return std::all_of (plane.begin (), plane.end (),
+									[value] (uint8_t v) { return v == value; });
+			};
+			EXPECT_TRUE (isConstant (planes[0], color.red));
+			EXPECT_TRUE (isConstant (planes[1], color.green));
+			EXPECT_TRUE (isConstant (planes[2], color.blue));
+			EXPECT_TRUE (isConstant (planes[3], color.alpha));
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (BitmapFilterTest, ScaleKeepsGradients)
+{
+	using namespace BitmapFilter::Standard;
+	auto bitmap = makeOwned<CBitmap> (CPoint (256, 8));
+	if (auto accessor = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		do
+		{
+			auto value = static_cast<uint8_t> (accessor->getX ());
+			accessor->setColor (CColor (value, value, value, 255));
+		} while (++(*accessor));
+	}
+	for (auto filterName : {kScaleAreaAverage, kScaleLanczos})
+	{
+		auto output = runScale (filterName, bitmap, 64, 2);
+		EXPECT_TRUE (output);
+		auto red = getPlanes (output)[0];
+		bool linear = true;
+		// away from the edges, where the lanczos filter sees the repeated edge pixels
+		for (auto x = 3; x < 61; ++x)
+		{
+			if (std::abs (red[x] - (x * 4 + 1.5)) > 1.)
+				linear = false;
+		}
+		EXPECT_TRUE (linear);
+	}
+}
+
+} // VSTGUI
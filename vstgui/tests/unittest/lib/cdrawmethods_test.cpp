@@ -0,0 +1,101 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cdrawmethods.h"
+#include "../../../lib/cfont.h"
+#include "../../../lib/cstring.h"
+#include "../../../lib/platform/iplatformfont.h"
+#include "../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+constexpr auto kTestText = "The quick brown fox jumps over the lazy dog";
+
+//------------------------------------------------------------------------
+CCoord getStringWidth (CFontRef font, const UTF8String& text)
+{
+	auto painter = font->getPlatformFont ()->getPainter ();
+	return painter->getStringWidth (nullptr, text.getPlatformString (), true);
+}
+
+//------------------------------------------------------------------------
+bool hasPainter (CFontRef font)
+{
+	auto platformFont = font->getPlatformFont ();
+	return platformFont && platformFont->getPainter ();
+}
+
+} // anonymous
+
+TEST_CASE (CDrawMethodsTest, TextNotTruncatedIfItFits)
+{
+	auto font = makeOwned<CFontDesc> ("Arial", 12);
+	if (!hasPainter (font))
+		return;
+	UTF8String text (kTestText);
+	auto result = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, text,
+	                                                 font, getStringWidth (font, text));
+	EXPECT_EQ (result, text);
+}
+
+TEST_CASE (CDrawMethodsTest, TruncateHeadTailAndMiddle)
+{
+	auto font = makeOwned<CFontDesc> ("Arial", 12);
+	if (!hasPainter (font))
+		return;
+	UTF8String text (kTestText);
+	auto maxWidth = getStringWidth (font, text) / 2.;
+
+	auto head = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateHead, text,
+	                                               font, maxWidth);
+	EXPECT_TRUE (getStringWidth (font, head) <= maxWidth);
+	EXPECT_TRUE (head.getString ().find ("..") == 0);
+	EXPECT_TRUE (head.getString ().back () == 'g');
+
+	auto tail = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, text,
+	                                               font, maxWidth);
+	EXPECT_TRUE (getStringWidth (font, tail) <= maxWidth);
+	EXPECT_TRUE (tail.getString ().front () == 'T');
+	EXPECT_TRUE (tail.getString ().rfind ("..") == tail.length () - 2);
+
+	auto middle = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateMiddle, text,
+	                                                 font, maxWidth);
+	EXPECT_TRUE (getStringWidth (font, middle) <= maxWidth);
+	EXPECT_TRUE (middle.getString ().front () == 'T');
+	EXPECT_TRUE (middle.getString ().back () == 'g');
+	EXPECT_TRUE (middle.getString ().find ("..") != std::string::npos);
+}
+
+TEST_CASE (CDrawMethodsTest, TruncationKeepsAsManyCharactersAsFit)
+{
+	auto font = makeOwned<CFontDesc> ("Arial", 12);
+	if (!hasPainter (font))
+		return;
+	UTF8String text (kTestText);
+	auto maxWidth = getStringWidth (font, text) / 2.;
+	auto tail = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, text,
+	                                               font, maxWidth);
+	auto numKept = tail.length () - 2;
+	UTF8String oneMore (text.getString ().substr (0, numKept + 1) + "..");
+	EXPECT_TRUE (getStringWidth (font, oneMore) > maxWidth);
+}
+
+TEST_CASE (CDrawMethodsTest, PlaceholderOnly)
+{
+	auto font = makeOwned<CFontDesc> ("Arial", 12);
+	if (!hasPainter (font))
+		return;
+	UTF8String text (kTestText);
+	auto result = CDrawMethods::createTruncatedText (CDrawMethods::kTextTruncateTail, text,
+	                                                 font, 1.);
+	EXPECT_EQ (result, "..");
+	result = CDrawMethods::createTruncatedText (
+	    CDrawMethods::kTextTruncateTail, text, font, 1., CPoint (0, 0),
+	    CDrawMethods::kReturnEmptyIfTruncationIsPlaceholderOnly);
+	EXPECT_TRUE (result.empty ());
+}
+
+} // VSTGUI
@@ -4,6 +4,7 @@
 
 #include "../../../lib/ccolor.h"
 #include "../../../lib/cframe.h"
+#include "../../../lib/coffscreencontext.h"
 #include "../../../lib/events.h"
 #include "../unittests.h"
 #include "eventhelpers.h"
@@ -161,6 +162,30 @@ public:
 	}
 };
 
+class DrawRectView : public CView
+{
+public:
+	std::vector<CRect> drawRects;
+
+	DrawRectView (const CRect& r) : CView (r) {}
+
+	void drawRect (CDrawContext* c, const CRect& r) override { drawRects.emplace_back (r); }
+};
+
+class DrawThreadSafeView : public CView
+{
+public:
+	DrawThreadSafeView (const CRect& r) : CView (r) {}
+
+	bool isDrawThreadSafe () const override { return true; }
+};
+
+class DerivedContainer : public CViewContainer
+{
+public:
+	DerivedContainer (const CRect& r) : CViewContainer (r) {}
+};
+
 } // anonymouse
 
 TEST_CASE (CFrameTest, SetZoom)
@@ -688,6 +713,65 @@ TEST_CASE (CFrameTest, SetPosition)
 	frame->close ();
 }
 
+TEST_CASE (CFrameTest, PlatformDrawRectsSkipsViewsOutsideRegion)
+{
+	auto frame = owned (new CFrame (CRect (0, 0, 100, 100), nullptr));
+	auto container = new CViewContainer (CRect (0, 0, 100, 100));
+	auto v1 = new DrawRectView (CRect (0, 0, 10, 10));
+	auto v2 = new DrawRectView (CRect (90, 90, 100, 100));
+	auto v3 = new DrawRectView (CRect (40, 40, 60, 60));
+	auto v4 = new DrawRectView (CRect (0, 0, 100, 100));
+	container->addView (v1);
+	container->addView (v2);
+	container->addView (v3);
+	container->addView (v4);
+	frame->addView (container);
+
+	auto drawContext = COffscreenContext::create ({100, 100});
+	EXPECT (drawContext);
+	auto platformFrameCallback = dynamic_cast<IPlatformFrameCallback*> (frame.get ());
+	drawContext->beginDraw ();
+	EXPECT (platformFrameCallback->platformDrawRects (
+		drawContext, {CRect (0, 0, 10, 10), CRect (90, 90, 100, 100)}));
+	drawContext->endDraw ();
+	EXPECT (drawContext->hasDrawRegion () == false);
+
+	EXPECT (v1->drawRects.size () == 1);
+	EXPECT (v1->drawRects[0] == CRect (0, 0, 10, 10));
+	EXPECT (v2->drawRects.size () == 1);
+	EXPECT (v2->drawRects[0] == CRect (90, 90, 100, 100));
+	EXPECT (v3->drawRects.empty ());
+	EXPECT (v4->drawRects.size () == 2);
+}
+
+TEST_CASE (CFrameTest, PlatformPrepareConcurrentDraw)
+{
+	auto frame = owned (new CFrame (CRect (0, 0, 100, 100), nullptr));
+	auto container = new CViewContainer (CRect (0, 0, 100, 50));
+	auto derivedContainer = new DerivedContainer (CRect (0, 50, 100, 100));
+	auto v1 = new DrawThreadSafeView (CRect (0, 0, 40, 40));
+	auto v2 = new DrawRectView (CRect (60, 0, 100, 40));
+	auto v3 = new DrawThreadSafeView (CRect (0, 0, 40, 40));
+	container->addView (v1);
+	container->addView (v2);
+	derivedContainer->addView (v3);
+	frame->addView (container);
+	frame->addView (derivedContainer);
+	frame->attached (frame);
+	v1->setDirty ();
+
+	auto drawContext = COffscreenContext::create ({100, 100});
+	EXPECT (drawContext);
+	auto platformFrameCallback = dynamic_cast<IPlatformFrameCallback*> (frame.get ());
+	drawContext->beginDraw ();
+	EXPECT (platformFrameCallback->platformPrepareConcurrentDraw (drawContext, CRect (0, 0, 50, 50)));
+	EXPECT (v1->isDirty () == false);
+	EXPECT (platformFrameCallback->platformPrepareConcurrentDraw (drawContext, CRect (40, 0, 60, 50)));
+	EXPECT (platformFrameCallback->platformPrepareConcurrentDraw (drawContext, CRect (50, 0, 70, 50)) == false);
+	EXPECT (platformFrameCallback->platformPrepareConcurrentDraw (drawContext, CRect (0, 50, 40, 90)) == false);
+	drawContext->endDraw ();
+}
+
 #if 0
 TEST_CASE (CFrameTest, CollectInvalidRectsOnMouseDown)
 {
@@ -47,4 +47,98 @@ TEST_CASE (CInvalidRectListTest, AddMulti)
 	EXPECT_EQ (list.data ().size (), 2u);
 }
 
+TEST_CASE (CInvalidRectListTest, AddAdjacentMerges)
+{
+	CInvalidRectList list;
+	EXPECT_TRUE (list.add ({0, 0, 10, 10}));
+	EXPECT_TRUE (list.add ({20, 20, 30, 30}));
+	EXPECT_TRUE (list.add ({0, 10, 10, 20}));
+	EXPECT_EQ (list.size (), 2u);
+	EXPECT_TRUE (list.add ({0, 20, 10, 30}));
+	EXPECT_EQ (list.size (), 2u);
+	EXPECT_TRUE (list.add ({10, 0, 20, 30}));
+	EXPECT_TRUE (list.add ({20, 0, 30, 20}));
+	EXPECT_EQ (list.size (), 1u);
+	EXPECT_EQ (list.data ().front (), CRect (0, 0, 30, 30));
+}
+
+TEST_CASE (CInvalidRectListTest, AddContainingMultiple)
+{
+	CInvalidRectList list;
+	EXPECT_TRUE (list.add ({0, 0, 10, 10}));
+	EXPECT_TRUE (list.add ({50, 50, 60, 60}));
+	EXPECT_TRUE (list.add ({0, 90, 10, 100}));
+	EXPECT_EQ (list.size (), 3u);
+	EXPECT_TRUE (list.add ({0, 0, 100, 100}));
+	EXPECT_EQ (list.size (), 1u);
+}
+
+TEST_CASE (CInvalidRectListTest, AreaOverhead)
+{
+	CInvalidRectList list;
+	EXPECT_TRUE (list.add ({0, 0, 10, 10}));
+	EXPECT_TRUE (list.add ({0, 15, 10, 25}));
+	EXPECT_EQ (list.size (), 2u);
+
+	CInvalidRectList::MergePolicy policy;
+	policy.areaOverhead = 0.25;
+	CInvalidRectList list2 (policy);
+	EXPECT_TRUE (list2.add ({0, 0, 10, 10}));
+	EXPECT_TRUE (list2.add ({0, 15, 10, 25}));
+	EXPECT_EQ (list2.size (), 1u);
+	EXPECT_EQ (list2.data ().front (), CRect (0, 0, 10, 25));
+}
+
+TEST_CASE (CInvalidRectListTest, MaxRects)
+{
+	CInvalidRectList::MergePolicy policy;
+	policy.maxRects = 2;
+	CInvalidRectList list (policy);
+	EXPECT_TRUE (list.add ({0, 0, 10, 10}));
+	EXPECT_TRUE (list.add ({100, 0, 110, 10}));
+	EXPECT_TRUE (list.add ({0, 20, 10, 30}));
+	EXPECT_EQ (list.size (), 2u);
+	EXPECT_TRUE (list.data ()[0] == CRect (0, 0, 10, 30) ||
+				 list.data ()[1] == CRect (0, 0, 10, 30));
+}
+
+TEST_CASE (CInvalidRectListTest, MergeOverlapping)
+{
+	CInvalidRectList list;
+	EXPECT_TRUE (list.add ({0, 0, 100, 10}));
+	EXPECT_TRUE (list.add ({50, 5, 60, 100}));
+	EXPECT_EQ (list.size (), 2u);
+
+	CInvalidRectList::MergePolicy policy;
+	policy.mergeOverlapping = true;
+	CInvalidRectList list2 (policy);
+	EXPECT_TRUE (list2.add ({0, 0, 100, 10}));
+	EXPECT_TRUE (list2.add ({200, 0, 210, 100}));
+	EXPECT_TRUE (list2.add ({50, 5, 60, 100}));
+	EXPECT_EQ (list2.size (), 2u);
+	// bridges both rectangles in the list
+	EXPECT_TRUE (list2.add ({55, 50, 205, 60}));
+	EXPECT_EQ (list2.size (), 1u);
+	EXPECT_EQ (list2.data ().front (), CRect (0, 0, 210, 100));
+	// touching rectangles do not overlap
+	EXPECT_TRUE (list2.add ({210, 0, 220, 5}));
+	EXPECT_EQ (list2.size (), 2u);
+}
+
+TEST_CASE (CInvalidRectListTest, JoinNearby)
+{
+	CInvalidRectList list;
+	EXPECT_TRUE (list.add ({0, 0, 10, 10}));
+	EXPECT_TRUE (list.add ({0, 20, 10, 30}));
+	EXPECT_TRUE (list.add ({20, 0, 30, 10}));
+	EXPECT_TRUE (list.add ({100, 100, 110, 110}));
+	EXPECT_EQ (list.size (), 4u);
+	joinNearbyInvalidRects (list, 5.);
+	EXPECT_EQ (list.size (), 4u);
+	joinNearbyInvalidRects (list, 10.);
+	EXPECT_EQ (list.size (), 3u);
+	EXPECT_FALSE (list.add ({0, 0, 10, 30}));
+	EXPECT_FALSE (list.add ({105, 105, 110, 110}));
+}
+
 } // VSTGUI
@@ -0,0 +1,100 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../../lib/controls/ctextlabel.h"
+#include "../../../../lib/platform/iplatformfont.h"
+#include "../../unittests.h"
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+SharedPointer<CMultiLineTextLabel> createWrappingLabel (UTF8StringPtr text)
+{
+	auto label = makeOwned<CMultiLineTextLabel> (CRect (0, 0, 100, 20));
+	label->setFont (makeOwned<CFontDesc> ("Arial", 12));
+	label->setTextInset (CPoint (0, 0));
+	label->setLineLayout (CMultiLineTextLabel::LineLayout::wrap);
+	label->setText (text);
+	return label;
+}
+
+//------------------------------------------------------------------------
+CCoord getLineHeight (CTextLabel* label)
+{
+	auto font = label->getFont ()->getPlatformFont ();
+	if (!font || !font->getPainter ())
+		return 0.;
+	return font->getAscent () + font->getDescent () + font->getLeading ();
+}
+
+} // anonymous
+
+TEST_CASE (CMultiLineTextLabelTest, ContentHeightOfParagraphs)
+{
+	auto label = createWrappingLabel ("First\nSecond\n\nFourth");
+	auto lineHeight = getLineHeight (label);
+	if (lineHeight <= 0.)
+		return;
+	EXPECT_EQ (label->calculateContentHeight (1000.), lineHeight * 4.);
+	EXPECT_EQ (label->getHeight (), 20.);
+}
+
+TEST_CASE (CMultiLineTextLabelTest, WrapLongText)
+{
+	auto label = createWrappingLabel (
+	    "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog.");
+	auto lineHeight = getLineHeight (label);
+	if (lineHeight <= 0.)
+		return;
+	auto oneLine = label->calculateContentHeight (10000.);
+	EXPECT_EQ (oneLine, lineHeight);
+	auto wrapped = label->calculateContentHeight (100.);
+	EXPECT_TRUE (wrapped > lineHeight);
+	auto narrow = label->calculateContentHeight (50.);
+	EXPECT_TRUE (narrow >= wrapped);
+	// the cached line breaks give the same result
+	EXPECT_EQ (label->calculateContentHeight (100.), wrapped);
+}
+
+TEST_CASE (CMultiLineTextLabelTest, WrapWordWiderThanLine)
+{
+	auto label = createWrappingLabel ("Supercalifragilisticexpialidocious");
+	auto lineHeight = getLineHeight (label);
+	if (lineHeight <= 0.)
+		return;
+	EXPECT_TRUE (label->calculateContentHeight (30.) > lineHeight);
+	// at least one character is put on each line
+	auto height = label->calculateContentHeight (1.);
+	EXPECT_EQ (height, lineHeight * 34.);
+}
+
+TEST_CASE (CMultiLineTextLabelTest, TextChangeReflowsChangedParagraph)
+{
+	auto label = createWrappingLabel ("Short\nShort");
+	auto lineHeight = getLineHeight (label);
+	if (lineHeight <= 0.)
+		return;
+	EXPECT_EQ (label->calculateContentHeight (100.), lineHeight * 2.);
+	label->setText ("Short\nThe quick brown fox jumps over the lazy dog");
+	EXPECT_TRUE (label->calculateContentHeight (100.) > lineHeight * 2.);
+	label->setText ("Short\nShort");
+	EXPECT_EQ (label->calculateContentHeight (100.), lineHeight * 2.);
+}
+
+TEST_CASE (CMultiLineTextLabelTest, ClipLayoutDoesNotWrap)
+{
+	auto label = createWrappingLabel (
+	    "The quick brown fox jumps over the lazy dog. The quick brown fox jumps over the lazy dog.");
+	auto lineHeight = getLineHeight (label);
+	if (lineHeight <= 0.)
+		return;
+	label->setLineLayout (CMultiLineTextLabel::LineLayout::clip);
+	EXPECT_EQ (label->calculateContentHeight (100.), lineHeight);
+	label->setLineLayout (CMultiLineTextLabel::LineLayout::wrap);
+	EXPECT_TRUE (label->calculateContentHeight (100.) > lineHeight);
+}
+
+} // VSTGUI
@@ -0,0 +1,142 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/cshadowviewcontainer.h"
+#include "../../../lib/cbitmap.h"
+#include "../../../lib/ccolor.h"
+#include "../../../lib/cdrawcontext.h"
+#include "../../../lib/cframe.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../../../lib/platform/iplatformbitmap.h"
+#include "../unittests.h"
+#include <cstring>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+class FilledView : public CView
+{
+public:
+	FilledView (const CRect& size) : CView (size) {}
+
+	void draw (CDrawContext* pContext) override
+	{
+		pContext->setFillColor (kRedCColor);
+		pContext->drawRect (getViewSize (), kDrawFilled);
+		++drawCount;
+		CView::draw (pContext);
+	}
+
+	int drawCount {0};
+};
+
+//------------------------------------------------------------------------
+struct ShadowTestSetup
+{
+	ShadowTestSetup ()
+	{
+		container = new CShadowViewContainer (CRect (0, 0, 400, 100));
+		container->setShadowOffset (CPoint (2, 2));
+		container->setShadowBlurSize (2.);
+		view1 = new FilledView (CRect (10, 10, 30, 30));
+		view2 = new FilledView (CRect (300, 10, 320, 30));
+		container->addView (view1);
+		container->addView (view2);
+		frame = new CFrame (CRect (0, 0, 400, 100), nullptr);
+		frame->addView (container);
+		frame->attached (frame);
+		drawContext = COffscreenContext::create ({400, 100});
+	}
+
+	~ShadowTestSetup () noexcept { frame->close (); }
+
+	void draw (const CRect& updateRect)
+	{
+		drawContext->beginDraw ();
+		container->drawRect (drawContext, updateRect);
+		drawContext->endDraw ();
+	}
+
+	CFrame* frame;
+	CShadowViewContainer* container;
+	FilledView* view1;
+	FilledView* view2;
+	SharedPointer<COffscreenContext> drawContext;
+};
+
+//------------------------------------------------------------------------
+bool equalPixels (CBitmap* bitmap1, CBitmap* bitmap2)
+{
+	if (!bitmap1 || !bitmap2)
+		return false;
+	auto platformBitmap1 = bitmap1->getPlatformBitmap ();
+	auto platformBitmap2 = bitmap2->getPlatformBitmap ();
+	if (platformBitmap1->getSize () != platformBitmap2->getSize ())
+		return false;
+	auto access1 = platformBitmap1->lockPixels (true);
+	auto access2 = platformBitmap2->lockPixels (true);
+	auto width = static_cast<uint32_t> (platformBitmap1->getSize ().x);
+	auto height = static_cast<uint32_t> (platformBitmap1->getSize ().y);
+	for (auto y = 0u; y < height; ++y)
+	{
+		if (memcmp (access1->getAddress () + y * access1->getBytesPerRow (),
+					access2->getAddress () + y * access2->getBytesPerRow (), width * 4) != 0)
+			return false;
+	}
+	return true;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (CShadowViewContainerTest, UpdateRendersOnlyDirtyPart)
+{
+	ShadowTestSetup setup;
+	setup.draw (CRect (0, 0, 400, 100));
+	// once for the shadow and once for the container
+	EXPECT_EQ (setup.view1->drawCount, 2);
+	EXPECT_EQ (setup.view2->drawCount, 2);
+	auto shadowBitmap = setup.container->getBackground ();
+	EXPECT_NE (shadowBitmap, nullptr);
+
+	setup.view1->invalid ();
+	setup.draw (CRect (0, 0, 40, 40));
+	EXPECT_EQ (setup.view1->drawCount, 4);
+	EXPECT_EQ (setup.view2->drawCount, 2);
+	EXPECT_EQ (setup.container->getBackground (), shadowBitmap);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CShadowViewContainerTest, UpdateMatchesRebuild)
+{
+	ShadowTestSetup setup;
+	setup.draw (CRect (0, 0, 400, 100));
+	auto shadowBitmap = setup.container->getBackground ();
+	setup.view1->setViewSize (CRect (40, 20, 70, 60));
+	setup.view2->invalid ();
+	setup.draw (CRect (0, 0, 400, 100));
+	EXPECT_EQ (setup.container->getBackground (), shadowBitmap);
+
+	ShadowTestSetup rebuildSetup;
+	rebuildSetup.view1->setViewSize (CRect (40, 20, 70, 60));
+	rebuildSetup.draw (CRect (0, 0, 400, 100));
+	EXPECT_TRUE (equalPixels (shadowBitmap, rebuildSetup.container->getBackground ()));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (CShadowViewContainerTest, ChangedSettingsRebuildShadow)
+{
+	ShadowTestSetup setup;
+	setup.draw (CRect (0, 0, 400, 100));
+	auto shadowBitmap = setup.container->getBackground ();
+	setup.container->setShadowBlurSize (3.);
+	setup.draw (CRect (0, 0, 400, 100));
+	EXPECT_NE (setup.container->getBackground (), shadowBitmap);
+	EXPECT_EQ (setup.view1->drawCount, 4);
+	EXPECT_EQ (setup.view2->drawCount, 4);
+}
+
+} // VSTGUI
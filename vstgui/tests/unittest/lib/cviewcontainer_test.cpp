@@ -7,6 +7,8 @@
 #include "../../../lib/ccolor.h"
 #include "../../../lib/dragging.h"
 #include "../../../lib/events.h"
+#include "../../../lib/coffscreencontext.h"
+#include "../../../lib/crowcolumnview.h"
 #include "../unittests.h"
 #include "eventhelpers.h"
 #include <vector>
@@ -109,6 +111,16 @@ public:
 	
  };
 
+class DrawRectView : public CView
+{
+public:
+	std::vector<CRect> drawRects;
+
+	DrawRectView (const CRect& r) : CView (r) {}
+
+	void drawRect (CDrawContext* c, const CRect& r) override { drawRects.emplace_back (r); }
+};
+
 } // anonymous
 
 TEST_SUITE_SETUP (CViewContainerTest)
@@ -430,6 +442,33 @@ TEST_CASE (CViewContainerTest, ReverseIterator)
 	EXPECT (*it == nullptr);
 }
 
+TEST_CASE (CViewContainerTest, IteratorIsNotAffectedByChanges)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+
+	auto v1 = new TestView1 ();
+	auto v2 = new TestView1 ();
+	auto v3 = new TestView1 ();
+	auto v4 = new TestView1 ();
+	container->addView (v1);
+	container->addView (v2);
+	container->addView (v3);
+	ViewIterator it (container);
+	EXPECT (*it == v1);
+	container->removeView (v2);
+	container->addView (v4, v1);
+	++it;
+	EXPECT (*it == v2);
+	++it;
+	EXPECT (*it == v3);
+	++it;
+	EXPECT (*it == nullptr);
+	EXPECT (container->getNbViews () == 3);
+	EXPECT (container->getView (0) == v4);
+	EXPECT (container->getView (1) == v1);
+	EXPECT (container->getView (2) == v3);
+}
+
 TEST_CASE (CViewContainerTest, MouseEventsInEmptyContainer)
 {
 	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
@@ -638,4 +677,381 @@ TEST_CASE (CViewContainerTest, GetContainerAt)
 	EXPECT (res == c1);
 }
 
+TEST_CASE (CViewContainerTest, Opaque)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+
+	auto view = makeOwned<CView> (CRect (0, 0, 10, 10));
+	EXPECT (view->isOpaque () == false);
+	view->setOpaque (true);
+	EXPECT (view->isOpaque ());
+
+	container->setBackgroundColor (kGreenCColor);
+	container->setBackgroundColorDrawStyle (kDrawFilled);
+	EXPECT (container->isOpaque ());
+	container->setBackgroundColorDrawStyle (kDrawStroked);
+	EXPECT (container->isOpaque () == false);
+	container->setBackgroundColorDrawStyle (kDrawFilledAndStroked);
+	EXPECT (container->isOpaque ());
+	container->setBackgroundColor (CColor (0, 255, 0, 128));
+	EXPECT (container->isOpaque () == false);
+	container->setBackgroundColor (kGreenCColor);
+	container->setTransparency (true);
+	EXPECT (container->isOpaque () == false);
+	container->setOpaque (true);
+	EXPECT (container->isOpaque ());
+	container->setOpaque (false);
+	container->setTransparency (false);
+
+	struct DerivedContainer : CViewContainer
+	{
+		using CViewContainer::CViewContainer;
+	};
+	auto derived = makeOwned<DerivedContainer> (CRect (0, 0, 10, 10));
+	derived->setBackgroundColor (kGreenCColor);
+	derived->setBackgroundColorDrawStyle (kDrawFilled);
+	EXPECT (derived->isOpaque () == false);
+	derived->setOpaque (true);
+	EXPECT (derived->isOpaque ());
+
+	auto rowColumnView = makeOwned<CRowColumnView> (CRect (0, 0, 10, 10));
+	rowColumnView->setBackgroundColor (kGreenCColor);
+	rowColumnView->setBackgroundColorDrawStyle (kDrawFilled);
+	EXPECT (rowColumnView->isOpaque ());
+}
+
+TEST_CASE (CViewContainerTest, OccludedViewsAreNotDrawn)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	container->setTransparency (true);
+
+	auto v1 = new DrawRectView (CRect (0, 0, 50, 50));
+	auto v2 = new DrawRectView (CRect (0, 0, 200, 100));
+	auto v3 = new DrawRectView (CRect (0, 0, 200, 200));
+	auto v4 = new DrawRectView (CRect (150, 150, 200, 200));
+	v2->setOpaque (true);
+	v4->setOpaque (true);
+	container->addView (v1);
+	container->addView (v2);
+	container->addView (v3);
+	container->addView (v4);
+
+	auto drawContext = COffscreenContext::create ({200, 200});
+	drawContext->beginDraw ();
+	container->drawRect (drawContext, CRect (0, 0, 200, 200));
+	drawContext->endDraw ();
+
+	EXPECT (v1->drawRects.empty ());
+	EXPECT (v2->drawRects.size () == 1);
+	EXPECT (v2->drawRects[0] == CRect (0, 0, 200, 100));
+	EXPECT (v3->drawRects.size () == 1);
+	EXPECT (v3->drawRects[0] == CRect (0, 0, 200, 200));
+	EXPECT (v4->drawRects.size () == 1);
+}
+
+TEST_CASE (CViewContainerTest, PartiallyOccludedViewsDrawVisiblePart)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	container->setTransparency (true);
+
+	auto v1 = new DrawRectView (CRect (0, 0, 200, 200));
+	auto v2 = new DrawRectView (CRect (0, 0, 200, 120));
+	auto v3 = new DrawRectView (CRect (0, 0, 100, 200));
+	auto v4 = new DrawRectView (CRect (100, 100, 200, 200));
+	v2->setOpaque (true);
+	v3->setOpaque (true);
+	v3->setAlphaValue (0.5f);
+	container->addView (v1);
+	container->addView (v2);
+	container->addView (v3);
+	container->addView (v4);
+
+	auto drawContext = COffscreenContext::create ({200, 200});
+	drawContext->beginDraw ();
+	container->drawRect (drawContext, CRect (0, 0, 200, 200));
+	drawContext->endDraw ();
+
+	EXPECT (v1->drawRects.size () == 1);
+	EXPECT (v1->drawRects[0] == CRect (0, 120, 200, 200));
+	EXPECT (v2->drawRects.size () == 1);
+	EXPECT (v2->drawRects[0] == CRect (0, 0, 200, 120));
+	EXPECT (v3->drawRects.size () == 1);
+	EXPECT (v4->drawRects.size () == 1);
+}
+
+TEST_CASE (CViewContainerTest, SpatialIndexQueries)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	container->setSpatialIndexEnabled (true);
+	EXPECT (container->isSpatialIndexEnabled ());
+
+	std::vector<CView*> views;
+	for (auto y = 0; y < 10; ++y)
+	{
+		for (auto x = 0; x < 10; ++x)
+		{
+			auto view = new CView (CRect (0, 0, 20, 20).offset (x * 20, y * 20));
+			views.push_back (view);
+			container->addView (view);
+		}
+	}
+	auto top = new CViewContainer (CRect (50, 50, 150, 150));
+	container->addView (top);
+
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	frame->addView (container);
+	container->remember ();
+	frame->attached (frame);
+
+	auto options = GetViewOptions ().includeViewContainer ();
+	EXPECT (container->getViewAt (CPoint (5, 5), options) == views[0]);
+	EXPECT (container->getViewAt (CPoint (195, 195), options) == views[99]);
+	EXPECT (container->getViewAt (CPoint (100, 100), options) == top);
+	EXPECT (container->getContainerAt (CPoint (100, 100)) == top);
+	CViewContainer::ViewList viewsAt;
+	container->getViewsAt (CPoint (60, 60), viewsAt, options);
+	EXPECT (viewsAt.size () == 2);
+	EXPECT (viewsAt.front () == top);
+	EXPECT (viewsAt.back () == views[33]);
+
+	// geometry changes are picked up without a rebuild
+	views[0]->setViewSize (CRect (160, 0, 180, 20));
+	EXPECT (container->getViewAt (CPoint (5, 5), options) == nullptr);
+	EXPECT (container->getViewAt (CPoint (165, 5), options) == views[8]);
+	container->changeViewZOrder (views[0], container->getNbViews () - 1);
+	EXPECT (container->getViewAt (CPoint (165, 5), options) == views[0]);
+	views[1]->setMouseableArea (CRect (0, 0, 40, 20));
+	EXPECT (container->getViewAt (CPoint (5, 5), options) == views[1]);
+
+	container->removeView (top);
+	EXPECT (container->getViewAt (CPoint (100, 100), options) == views[55]);
+	EXPECT (container->hitTestSubViews (CPoint (100, 100), noEvent ()));
+
+	container->setSpatialIndexEnabled (false);
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, SpatialIndexDrawsOnlyViewsInUpdateRect)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	container->setTransparency (true);
+	container->setSpatialIndexEnabled (true);
+
+	std::vector<DrawRectView*> views;
+	for (auto i = 0; i < 10; ++i)
+	{
+		auto view = new DrawRectView (CRect (0, 0, 20, 200).offset (i * 20, 0));
+		views.push_back (view);
+		container->addView (view);
+	}
+
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	frame->addView (container);
+	container->remember ();
+	frame->attached (frame);
+
+	views[9]->setViewSize (CRect (30, 0, 50, 200));
+
+	auto drawContext = COffscreenContext::create ({200, 200});
+	drawContext->beginDraw ();
+	container->drawRect (drawContext, CRect (25, 10, 35, 20));
+	drawContext->endDraw ();
+
+	for (auto i = 0; i < 9; ++i)
+		EXPECT (views[i]->drawRects.empty () == (i != 1));
+	EXPECT (views[1]->drawRects[0] == CRect (25, 10, 35, 20));
+	EXPECT (views[9]->drawRects.size () == 1);
+	EXPECT (views[9]->drawRects[0] == CRect (30, 10, 35, 20));
+
+	container->setSpatialIndexEnabled (false);
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, HiddenChildrenAreNotDrawn)
+{
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	container->setTransparency (true);
+
+	auto v1 = new DrawRectView (CRect (0, 0, 100, 100));
+	auto v2 = new DrawRectView (CRect (0, 0, 100, 100));
+	auto v3 = new DrawRectView (CRect (0, 0, 100, 100));
+	auto v4 = new DrawRectView (CRect (0, 0, 100, 100));
+	container->addView (v1);
+	container->addView (v2);
+	container->addView (v3);
+	container->addView (v4);
+	v1->setVisible (false);
+
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	frame->addView (container);
+	container->remember ();
+	frame->attached (frame);
+
+	v2->setAlphaValue (0.f);
+	v3->setViewSize (CRect (100, 100, 200, 200));
+
+	auto drawContext = COffscreenContext::create ({200, 200});
+	drawContext->beginDraw ();
+	container->drawRect (drawContext, CRect (0, 0, 100, 100));
+	drawContext->endDraw ();
+
+	EXPECT (v1->drawRects.empty ());
+	EXPECT (v2->drawRects.empty ());
+	EXPECT (v3->drawRects.empty ());
+	EXPECT (v4->drawRects.size () == 1);
+
+	v1->setVisible (true);
+	drawContext->beginDraw ();
+	container->drawRect (drawContext, CRect (0, 0, 100, 100));
+	drawContext->endDraw ();
+	EXPECT (v1->drawRects.size () == 1);
+
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, DrawRegionPartsForDerivedContainers)
+{
+	struct CountingContainer : CViewContainer
+	{
+		using CViewContainer::CViewContainer;
+		void drawRect (CDrawContext* context, const CRect& updateRect) override
+		{
+			drawRects.emplace_back (updateRect);
+			CViewContainer::drawRect (context, updateRect);
+		}
+		std::vector<CRect> drawRects;
+	};
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	container->setTransparency (true);
+	auto derived = new CountingContainer (CRect (0, 0, 100, 100));
+	derived->setTransparency (true);
+	auto plain = new CViewContainer (CRect (0, 0, 100, 100));
+	plain->setTransparency (true);
+	auto plainChild = new DrawRectView (CRect (0, 0, 100, 100));
+	plain->addView (plainChild);
+	container->addView (derived);
+	container->addView (plain);
+
+	auto frame = new CFrame (CRect (0, 0, 200, 200), nullptr);
+	frame->addView (container);
+	container->remember ();
+	frame->attached (frame);
+
+	auto drawContext = COffscreenContext::create ({200, 200});
+	drawContext->beginDraw ();
+	drawContext->setDrawRegion ({CRect (0, 0, 10, 10), CRect (50, 50, 60, 60)});
+	container->drawRect (drawContext, CRect (0, 0, 60, 60));
+	drawContext->clearDrawRegion ();
+	drawContext->endDraw ();
+
+	// the derived container may not honor the region, so it only gets the parts
+	EXPECT (derived->drawRects.size () == 2);
+	EXPECT (derived->drawRects[0] == CRect (0, 0, 10, 10));
+	EXPECT (derived->drawRects[1] == CRect (50, 50, 60, 60));
+	EXPECT (plainChild->drawRects.size () == 2);
+
+	frame->close ();
+}
+
+TEST_CASE (CViewContainerTest, RemoveAllNotifiesForEveryView)
+{
+	struct CountingListener : TestViewContainerListener
+	{
+		void viewContainerViewRemoved (CViewContainer* container, CView* view) override
+		{
+			EXPECT (container->hasChildren () == false);
+			++removedCount;
+		}
+		int removedCount {0};
+	};
+	auto& container = TEST_SUITE_GET_STORAGE (SharedPointer<CViewContainer>);
+	CountingListener listener;
+	container->registerViewContainerListener (&listener);
+	for (auto i = 0; i < 5; ++i)
+		container->addView (new CView (CRect (0, 0, 10, 10)));
+	container->removeAll ();
+	EXPECT (listener.removedCount == 5);
+	EXPECT (container->hasChildren () == false);
+	container->unregisterViewContainerListener (&listener);
+}
+
+TEST_CASE (CViewContainerTest, RemoveViewsWhileIteratingSnapshot)
+{
+	struct ListContainer : CViewContainer
+	{
+		ListContainer () : CViewContainer (CRect (0, 0, 100, 100)) {}
+		using CViewContainer::getChildViews;
+	};
+	auto container = makeOwned<ListContainer> ();
+	auto view1 = new CView (CRect (0, 0, 10, 10));
+	auto view2 = new CView (CRect (0, 0, 10, 10));
+	container->addView (view1);
+	container->addView (view2);
+	std::vector<CView*> iterated;
+	for (const auto& view : container->getChildViews ().snapshot ())
+	{
+		iterated.push_back (view);
+		container->removeView (view);
+	}
+	EXPECT (iterated.size () == 2);
+	EXPECT (iterated[0] == view1);
+	EXPECT (iterated[1] == view2);
+	EXPECT (container->getChildViews ().empty ());
+	// iterators compare by position, so a changed list compares equal to its new end
+	container->addView (new CView (CRect (0, 0, 10, 10)));
+	auto it = container->getChildViews ().begin ();
+	++it;
+	EXPECT (it == container->getChildViews ().end ());
+}
+
+TEST_CASE (CViewContainerTest, RemoveViewsWhileIteratingChildViews)
+{
+	struct ListContainer : CViewContainer
+	{
+		ListContainer () : CViewContainer (CRect (0, 0, 100, 100)) {}
+		using CViewContainer::getChildViews;
+	};
+	auto container = makeOwned<ListContainer> ();
+	auto view1 = new CView (CRect (0, 0, 10, 10));
+	auto view2 = new CView (CRect (0, 0, 10, 10));
+	container->addView (view1);
+	container->addView (view2);
+	std::vector<CView*> iterated;
+	// the iterators keep the views they were created from
+	for (const auto& view : container->getChildViews ())
+	{
+		iterated.push_back (view);
+		container->removeView (view);
+	}
+	EXPECT (iterated.size () == 2);
+	EXPECT (iterated[0] == view1);
+	EXPECT (iterated[1] == view2);
+	EXPECT (container->getChildViews ().empty ());
+}
+
+TEST_CASE (CViewContainerTest, ChildrenAsList)
+{
+	struct ListContainer : CViewContainer
+	{
+		ListContainer () : CViewContainer (CRect (0, 0, 100, 100)) {}
+		using CViewContainer::getChildren;
+	};
+	auto container = makeOwned<ListContainer> ();
+	auto view1 = new CView (CRect (0, 0, 10, 10));
+	auto view2 = new CView (CRect (0, 0, 10, 10));
+	container->addView (view1);
+	container->addView (view2);
+	const CViewContainer::ViewList& list = container->getChildren ();
+	EXPECT (list.size () == 2);
+	EXPECT (list.front () == view1);
+	EXPECT (list.back () == view2);
+	EXPECT (&container->getChildren () == &list);
+	container->changeViewZOrder (view2, 0);
+	// the list is updated on the next call
+	EXPECT (list.front () == view1);
+	EXPECT (container->getChildren ().front () == view2);
+	container->removeView (view1);
+	EXPECT (container->getChildren ().size () == 1);
+}
+
 } // namespaces
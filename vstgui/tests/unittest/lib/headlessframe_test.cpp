@@ -0,0 +1,189 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/platform/linux/headlessfactory.h"
+#include "../../../lib/platform/linux/headlessframe.h"
+#include "../../../lib/platform/linux/linuxfactory.h"
+#include "../../../lib/cbitmap.h"
+#include "../../../lib/cdrawcontext.h"
+#include "../../../lib/cframe.h"
+#include "../../../lib/events.h"
+#include "../../../lib/cviewcontainer.h"
+#include "../../../lib/platform/iplatformbitmap.h"
+#include "../unittests.h"
+#include <cstring>
+
+namespace VSTGUI {
+
+namespace {
+
+//------------------------------------------------------------------------
+/** installs a headless factory and restores the default platform factory afterwards */
+struct HeadlessFactoryScope
+{
+	HeadlessFactoryScope ()
+	{
+		setPlatformFactory (
+			std::make_unique<HeadlessFactory> (PlatformFactoryPtr (new LinuxFactory (nullptr))));
+		factory = dynamic_cast<const HeadlessFactory*> (&getPlatformFactory ());
+	}
+	~HeadlessFactoryScope () noexcept
+	{
+		exitPlatform ();
+		initPlatform (nullptr);
+	}
+
+	Headless::RunLoop& getRunLoop () const { return factory->getRunLoop (); }
+
+	const HeadlessFactory* factory;
+};
+
+//------------------------------------------------------------------------
+class ClickView : public CView
+{
+public:
+	ClickView (const CRect& size) : CView (size) {}
+
+	void draw (CDrawContext* context) override
+	{
+		context->setFillColor (clicked ? kGreenCColor : kRedCColor);
+		context->drawRect (getViewSize (), kDrawFilled);
+		setDirty (false);
+	}
+
+	void onMouseDownEvent (MouseDownEvent& event) override
+	{
+		clicked = true;
+		invalid ();
+		event.consumed = true;
+	}
+
+	bool clicked {false};
+};
+
+//------------------------------------------------------------------------
+CColor getPixel (const PlatformBitmapPtr& platformBitmap, uint32_t x, uint32_t y)
+{
+	CColor color;
+	auto bitmap = makeOwned<CBitmap> (platformBitmap);
+	if (auto access = owned (CBitmapPixelAccess::create (bitmap)))
+	{
+		access->setPosition (x, y);
+		access->getColor (color);
+	}
+	return color;
+}
+
+//------------------------------------------------------------------------
+bool equalPixels (const PlatformBitmapPtr& bitmap1, const PlatformBitmapPtr& bitmap2)
+{
+	if (bitmap1->getSize () != bitmap2->getSize ())
+		return false;
+	auto access1 = bitmap1->lockPixels (true);
+	auto access2 = bitmap2->lockPixels (true);
+	auto width = static_cast<uint32_t> (bitmap1->getSize ().x);
+	auto height = static_cast<uint32_t> (bitmap1->getSize ().y);
+	for (auto y = 0u; y < height; ++y)
+	{
+		if (memcmp (access1->getAddress () + y * access1->getBytesPerRow (),
+					access2->getAddress () + y * access2->getBytesPerRow (), width * 4) != 0)
+			return false;
+	}
+	return true;
+}
+
+//------------------------------------------------------------------------
+/** a frame with thread safe containers spanning several tiles and a view drawn on the main
+ *	thread */
+PlatformBitmapPtr renderTestFrame (const HeadlessFactoryScope& headless, uint32_t numThreads)
+{
+	auto frame = new CFrame (CRect (0, 0, 300, 200), nullptr);
+	frame->setBackgroundColor (kBlueCColor);
+	auto container = new CViewContainer (CRect (20, 20, 280, 180));
+	container->setBackgroundColor (kGreyCColor);
+	auto child = new CViewContainer (CRect (100, 30, 200, 120));
+	child->setBackgroundColor (CColor (200, 100, 50, 128));
+	container->addView (child);
+	frame->addView (container);
+	frame->addView (new ClickView (CRect (120, 120, 140, 140)));
+	PlatformBitmapPtr snapshot;
+	if (frame->open (&headless.getRunLoop ()))
+	{
+		if (auto platformFrame = dynamic_cast<Headless::Frame*> (frame->getPlatformFrame ()))
+		{
+			platformFrame->setDrawThreads (numThreads);
+			headless.getRunLoop ().advance (16);
+			child->invalid ();
+			headless.getRunLoop ().advance (16);
+			snapshot = platformFrame->createSnapshot ();
+		}
+	}
+	frame->close ();
+	return snapshot;
+}
+
+} // anonymous
+
+//------------------------------------------------------------------------
+TEST_CASE (HeadlessFrameTest, RendersViewsIntoSnapshot)
+{
+	HeadlessFactoryScope headless;
+	auto frame = new CFrame (CRect (0, 0, 40, 30), nullptr);
+	frame->setBackgroundColor (kBlueCColor);
+	frame->addView (new ClickView (CRect (10, 10, 20, 20)));
+	EXPECT_TRUE (frame->open (&headless.getRunLoop ()));
+	headless.getRunLoop ().advance (16);
+
+	auto platformFrame = dynamic_cast<Headless::Frame*> (frame->getPlatformFrame ());
+	EXPECT_TRUE (platformFrame);
+	if (platformFrame)
+	{
+		EXPECT_FALSE (platformFrame->hasInvalidRects ());
+		auto snapshot = platformFrame->createSnapshot ();
+		EXPECT_EQ (getPixel (snapshot, 15, 15), kRedCColor);
+		EXPECT_EQ (getPixel (snapshot, 5, 5), kBlueCColor);
+		EXPECT_EQ (getPixel (snapshot, 25, 25), kBlueCColor);
+	}
+	frame->close ();
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (HeadlessFrameTest, DispatchesSyntheticEvents)
+{
+	HeadlessFactoryScope headless;
+	auto frame = new CFrame (CRect (0, 0, 40, 30), nullptr);
+	auto view = new ClickView (CRect (10, 10, 20, 20));
+	frame->addView (view);
+	EXPECT_TRUE (frame->open (&headless.getRunLoop ()));
+	headless.getRunLoop ().advance (16);
+
+	auto platformFrame = dynamic_cast<Headless::Frame*> (frame->getPlatformFrame ());
+	EXPECT_TRUE (platformFrame);
+	if (platformFrame)
+	{
+		MouseDownEvent event;
+		event.mousePosition = CPoint (15, 15);
+		event.buttonState.add (MouseButton::Left);
+		platformFrame->dispatchEvent (event);
+		EXPECT_TRUE (view->clicked);
+		EXPECT_TRUE (platformFrame->hasInvalidRects ());
+		headless.getRunLoop ().advance (16);
+		EXPECT_EQ (getPixel (platformFrame->createSnapshot (), 15, 15), kGreenCColor);
+	}
+	frame->close ();
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (HeadlessFrameTest, TiledRenderMatchesSequentialRender)
+{
+	HeadlessFactoryScope headless;
+	auto sequential = renderTestFrame (headless, 0);
+	auto tiled = renderTestFrame (headless, 2);
+	EXPECT_TRUE (sequential);
+	EXPECT_TRUE (tiled);
+	if (sequential && tiled)
+		EXPECT_TRUE (equalPixels (sequential, tiled));
+}
+
+} // VSTGUI
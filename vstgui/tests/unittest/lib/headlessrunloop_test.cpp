@@ -0,0 +1,104 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/platform/linux/headlessrunloop.h"
+#include "../unittests.h"
+#include <functional>
+#include <vector>
+
+namespace VSTGUI {
+
+namespace {
+
+struct RecordingTimerCallback : IPlatformTimerCallback
+{
+	RecordingTimerCallback (int id, std::vector<std::pair<int, uint64_t>>& log,
+							Headless::RunLoop& runLoop)
+	: id (id), log (log), runLoop (runLoop)
+	{
+	}
+
+	void fire () override
+	{
+		log.emplace_back (id, runLoop.getTicks ());
+		if (onFire)
+			onFire ();
+	}
+
+	int id;
+	std::vector<std::pair<int, uint64_t>>& log;
+	Headless::RunLoop& runLoop;
+	std::function<void ()> onFire;
+};
+
+} // anonymous
+
+TEST_CASE (HeadlessRunLoopTest, TimeOnlyPassesOnAdvance)
+{
+	Headless::RunLoop runLoop;
+	EXPECT_EQ (runLoop.getTicks (), 0u);
+	runLoop.advance (25);
+	EXPECT_EQ (runLoop.getTicks (), 25u);
+}
+
+TEST_CASE (HeadlessRunLoopTest, TimersFireInDueOrder)
+{
+	Headless::RunLoop runLoop;
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimerCallback callback1 (1, log, runLoop);
+	RecordingTimerCallback callback2 (2, log, runLoop);
+	Headless::Timer timer1 (runLoop, &callback1);
+	Headless::Timer timer2 (runLoop, &callback2);
+	timer1.start (10);
+	timer2.start (15);
+	runLoop.advance (30);
+	std::vector<std::pair<int, uint64_t>> expected {{1, 10}, {2, 15}, {1, 20}, {1, 30}, {2, 30}};
+	EXPECT_TRUE (log == expected);
+	EXPECT_EQ (runLoop.getTicks (), 30u);
+}
+
+TEST_CASE (HeadlessRunLoopTest, StopInsideCallback)
+{
+	Headless::RunLoop runLoop;
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimerCallback callback (1, log, runLoop);
+	Headless::Timer timer (runLoop, &callback);
+	callback.onFire = [&] () { timer.stop (); };
+	timer.start (10);
+	runLoop.advance (100);
+	EXPECT_EQ (log.size (), 1u);
+	EXPECT_FALSE (runLoop.isTimerRegistered (&timer));
+}
+
+TEST_CASE (HeadlessRunLoopTest, RestartResetsDueTime)
+{
+	Headless::RunLoop runLoop;
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimerCallback callback (1, log, runLoop);
+	Headless::Timer timer (runLoop, &callback);
+	timer.start (10);
+	runLoop.advance (5);
+	timer.start (10);
+	runLoop.advance (9);
+	EXPECT_TRUE (log.empty ());
+	runLoop.advance (1);
+	EXPECT_EQ (log.size (), 1u);
+	EXPECT_EQ (log[0].second, 15u);
+}
+
+TEST_CASE (HeadlessRunLoopTest, TimerUnregistersOnDestruction)
+{
+	Headless::RunLoop runLoop;
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimerCallback callback (1, log, runLoop);
+	{
+		Headless::Timer timer (runLoop, &callback);
+		timer.start (10);
+		EXPECT_TRUE (runLoop.isTimerRegistered (&timer));
+	}
+	runLoop.advance (20);
+	EXPECT_TRUE (log.empty ());
+}
+
+} // VSTGUI
@@ -4,10 +4,65 @@
 
 #include "../../../lib/pixelbuffer.h"
 #include "../unittests.h"
+#include <algorithm>
+#include <random>
+#include <vector>
 
 namespace VSTGUI {
 using namespace PixelBuffer;
 
+namespace {
+
+constexpr Format allFormats[] = {Format::ARGB, Format::RGBA, Format::ABGR, Format::BGRA};
+
+struct TestBuffer
+{
+	TestBuffer (uint32_t width, uint32_t height, uint32_t padding)
+	: width (width), height (height), bytesPerRow (width * 4 + padding), data (bytesPerRow * height)
+	{
+		std::mt19937 random (width * 31 + height);
+		for (auto& byte : data)
+			byte = static_cast<uint8_t> (random ());
+	}
+
+	uint8_t* pixel (uint32_t x, uint32_t y) { return data.data () + y * bytesPerRow + x * 4; }
+
+	uint32_t width;
+	uint32_t height;
+	uint32_t bytesPerRow;
+	std::vector<uint8_t> data;
+};
+
+/** converts every pixel on its own, which takes the scalar path */
+TestBuffer convertPixelByPixel (Format srcFormat, Format dstFormat, TestBuffer buffer)
+{
+	for (auto y = 0u; y < buffer.height; ++y)
+	{
+		for (auto x = 0u; x < buffer.width; ++x)
+			convert (srcFormat, dstFormat, buffer.pixel (x, y), 4, 1, 1);
+	}
+	return buffer;
+}
+
+bool convertMatchesPixelByPixel (uint32_t width, uint32_t height, uint32_t padding)
+{
+	for (auto srcFormat : allFormats)
+	{
+		for (auto dstFormat : allFormats)
+		{
+			TestBuffer buffer (width, height, padding);
+			auto expected = convertPixelByPixel (srcFormat, dstFormat, buffer);
+			convert (srcFormat, dstFormat, buffer.data.data (), buffer.bytesPerRow, width, height);
+			// this includes that the padding bytes are untouched
+			if (buffer.data != expected.data)
+				return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous
+
 TEST_CASE (PixelBufferTest, ARGB_2_RGBA)
 {
 	uint32_t pixel = 0x11223344;
@@ -92,4 +147,112 @@ TEST_CASE (PixelBufferTest, BGRA_2_ARGB)
 	EXPECT (pixel == 0x44332211);
 }
 
+TEST_CASE (PixelBufferTest, OddWidths)
+{
+	for (auto width = 1u; width <= 33u; ++width)
+		EXPECT_TRUE (convertMatchesPixelByPixel (width, 3, 0));
+	EXPECT_TRUE (convertMatchesPixelByPixel (127, 5, 0));
+}
+
+TEST_CASE (PixelBufferTest, PaddedStrides)
+{
+	for (auto padding : {4u, 12u, 64u})
+	{
+		for (auto width : {1u, 3u, 7u, 8u, 9u, 17u, 100u})
+			EXPECT_TRUE (convertMatchesPixelByPixel (width, 4, padding));
+	}
+}
+
+TEST_CASE (PixelBufferTest, LargeImages)
+{
+	// big enough to be converted on several threads
+	EXPECT_TRUE (convertMatchesPixelByPixel (701, 803, 20));
+	EXPECT_TRUE (convertMatchesPixelByPixel (3, 200003, 4));
+}
+
+TEST_CASE (PixelBufferTest, PremultiplyAlpha)
+{
+	uint8_t pixel[] = {100, 200, 255, 128};
+	premultiplyAlpha (Format::BGRA, pixel, 4, 1, 1);
+	EXPECT_EQ (pixel[0], 50);
+	EXPECT_EQ (pixel[1], 100);
+	EXPECT_EQ (pixel[2], 128);
+	EXPECT_EQ (pixel[3], 128);
+	uint8_t pixel2[] = {0, 255, 51, 0};
+	premultiplyAlpha (Format::ARGB, pixel2, 4, 1, 1);
+	EXPECT_EQ (pixel2[0], 0);
+	EXPECT_EQ (pixel2[1], 0);
+	EXPECT_EQ (pixel2[2], 0);
+	EXPECT_EQ (pixel2[3], 0);
+}
+
+TEST_CASE (PixelBufferTest, UnpremultiplyAlpha)
+{
+	uint8_t pixel[] = {50, 100, 128, 128};
+	unpremultiplyAlpha (Format::BGRA, pixel, 4, 1, 1);
+	EXPECT_EQ (pixel[0], 100);
+	EXPECT_EQ (pixel[1], 199);
+	EXPECT_EQ (pixel[2], 255);
+	EXPECT_EQ (pixel[3], 128);
+	uint8_t pixel2[] = {0, 10, 20, 30};
+	unpremultiplyAlpha (Format::ABGR, pixel2, 4, 1, 1);
+	EXPECT_EQ (pixel2[1], 10);
+	EXPECT_EQ (pixel2[2], 20);
+	EXPECT_EQ (pixel2[3], 30);
+}
+
+TEST_CASE (PixelBufferTest, AlphaRoundTrip)
+{
+	// every valid premultiplied pixel, the alpha is in the last byte
+	TestBuffer buffer (256, 256, 0);
+	for (auto alpha = 0u; alpha < 256u; ++alpha)
+	{
+		for (auto color = 0u; color < 256u; ++color)
+		{
+			auto pixel = buffer.pixel (color, alpha);
+			auto value = static_cast<uint8_t> (std::min (color, alpha));
+			pixel[0] = value;
+			pixel[1] = value / 2;
+			pixel[2] = static_cast<uint8_t> (alpha - value);
+			pixel[3] = static_cast<uint8_t> (alpha);
+		}
+	}
+	auto premultiplied = buffer;
+	unpremultiplyAlpha (Format::RGBA, buffer.data.data (), buffer.bytesPerRow, 256, 256);
+	premultiplyAlpha (Format::RGBA, buffer.data.data (), buffer.bytesPerRow, 256, 256);
+	EXPECT_TRUE (buffer.data == premultiplied.data);
+}
+
+TEST_CASE (PixelBufferTest, AlphaMatchesPixelByPixel)
+{
+	for (auto format : allFormats)
+	{
+		for (auto width : {1u, 5u, 16u, 255u})
+		{
+			TestBuffer premultiplied (width, 300, 8);
+			auto expected = premultiplied;
+			for (auto y = 0u; y < expected.height; ++y)
+			{
+				for (auto x = 0u; x < expected.width; ++x)
+					premultiplyAlpha (format, expected.pixel (x, y), 4, 1, 1);
+			}
+			premultiplyAlpha (format, premultiplied.data.data (), premultiplied.bytesPerRow, width,
+							  premultiplied.height);
+			EXPECT_TRUE (premultiplied.data == expected.data);
+
+			// random data has color channels larger than alpha, too
+			TestBuffer unpremultiplied (width, 300, 8);
+			expected = unpremultiplied;
+			for (auto y = 0u; y < expected.height; ++y)
+			{
+				for (auto x = 0u; x < expected.width; ++x)
+					unpremultiplyAlpha (format, expected.pixel (x, y), 4, 1, 1);
+			}
+			unpremultiplyAlpha (format, unpremultiplied.data.data (),
+								unpremultiplied.bytesPerRow, width, unpremultiplied.height);
+			EXPECT_TRUE (unpremultiplied.data == expected.data);
+		}
+	}
+}
+
 } // namespace VSTGUI
@@ -0,0 +1,66 @@
+// This file is part of VSTGUI. It is subject to the license terms
+// in the LICENSE file found in the top-level directory of this
+// distribution and at http://github.com/steinbergmedia/vstgui/LICENSE
+
+#include "../../../lib/workerpool.h"
+#include "../unittests.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <vector>
+
+namespace VSTGUI {
+
+//------------------------------------------------------------------------
+TEST_CASE (WorkerPoolTest, PerformCallsEveryJobOnce)
+{
+	std::vector<std::atomic<uint32_t>> calls (100);
+	WorkerPool::instance ().perform (100, [&] (uint32_t index) { ++calls[index]; });
+	EXPECT_TRUE (std::all_of (calls.begin (), calls.end (),
+							  [] (const std::atomic<uint32_t>& c) { return c == 1u; }));
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (WorkerPoolTest, NestedPerform)
+{
+	std::atomic<uint32_t> numCalls {0};
+	WorkerPool::instance ().perform (8, [&] (uint32_t) {
+		WorkerPool::instance ().perform (8, [&] (uint32_t) { ++numCalls; });
+	});
+	EXPECT_EQ (numCalls, 64u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (WorkerPoolTest, AsyncRunsOnWorkerThread)
+{
+	std::promise<std::thread::id> promise;
+	auto future = promise.get_future ();
+	WorkerPool::instance ().async ([&] () { promise.set_value (std::this_thread::get_id ()); });
+	EXPECT_NE (future.get (), std::this_thread::get_id ());
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (WorkerPoolTest, UsableAfterShutdown)
+{
+	auto& pool = WorkerPool::instance ();
+	pool.shutdown ();
+	std::promise<void> promise;
+	auto future = promise.get_future ();
+	pool.async ([&] () { promise.set_value (); });
+	future.wait ();
+	std::atomic<uint32_t> numCalls {0};
+	pool.perform (16, [&] (uint32_t) { ++numCalls; });
+	EXPECT_EQ (numCalls, 16u);
+}
+
+//------------------------------------------------------------------------
+TEST_CASE (WorkerPoolTest, NumJobsForPixels)
+{
+	auto& pool = WorkerPool::instance ();
+	EXPECT_EQ (pool.numJobsForPixels (0), 1u);
+	EXPECT_EQ (pool.numJobsForPixels (WorkerPool::kMinPixelsPerJob * 2 - 1), 1u);
+	EXPECT_EQ (pool.numJobsForPixels (WorkerPool::kMinPixelsPerJob * 1000),
+			   pool.getNumThreads () + 1);
+}
+
+} // VSTGUI
@@ -151,6 +151,20 @@ constexpr auto withAllNodesUIDesc = R"(<?xml version="1.0" encoding="UTF-8"?>
 </vstgui-ui-description>
 )";
 
+constexpr auto prefetchBitmapsUIDesc = R"(
+<vstgui-ui-description version="1">
+	<bitmaps>
+		<bitmap name="b1" path="b1.png"/>
+		<bitmap name="b2" nineparttiled-offsets="1, 2, 3, 4" path="b2.png"/>
+		<bitmap name="b3" path="b3.png"/>
+	</bitmaps>
+	<template bitmap="b1" class="CViewContainer" name="view" origin="0, 0" size="100, 100">
+		<view class="UIViewSwitchContainer" origin="0, 0" size="100, 100" template-names="sub"/>
+	</template>
+	<template bitmap="b2" class="CViewContainer" name="sub" origin="0, 0" size="100, 100"/>
+</vstgui-ui-description>
+)";
+
 constexpr auto createViewUIDesc = R"(
 <vstgui-ui-description version="1">
 	<template background-color="~ TransparentCColor" background-color-draw-style="filled and stroked" class="CViewContainer" mouse-enabled="true" name="view" opacity="1" origin="0, 0" size="400, 235" transparent="false">
@@ -436,6 +450,46 @@ TEST_CASE (UIDescriptionXMLTests, Bitmaps)
 	EXPECT (dynamic_cast<CNinePartTiledBitmap*> (bitmap) == nullptr);
 }
 
+TEST_CASE (UIDescriptionXMLTests, PrefetchBitmaps)
+{
+	MemoryContentProvider provider (withAllNodesUIDesc,
+	                                static_cast<uint32_t> (strlen (withAllNodesUIDesc)));
+	UIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	desc.prefetchBitmaps ();
+	auto bitmap = desc.getBitmap ("b1");
+	EXPECT (bitmap);
+	EXPECT (bitmap->getResourceDescription ().u.name == std::string ("b1.png"));
+
+	MemoryContentProvider provider2 (withAllNodesUIDesc,
+	                                 static_cast<uint32_t> (strlen (withAllNodesUIDesc)));
+	UIDescription desc2 (&provider2);
+	EXPECT (desc2.parse () == true);
+	auto bitmap2 = desc2.getBitmap ("b1");
+	EXPECT (bitmap2);
+	EXPECT ((bitmap->getPlatformBitmap () == nullptr) == (bitmap2->getPlatformBitmap () == nullptr));
+	EXPECT (bitmap->getSize () == bitmap2->getSize ());
+}
+
+TEST_CASE (UIDescriptionXMLTests, PrefetchTemplateBitmaps)
+{
+	MemoryContentProvider provider (prefetchBitmapsUIDesc,
+	                                static_cast<uint32_t> (strlen (prefetchBitmapsUIDesc)));
+	UIDescription desc (&provider);
+	EXPECT (desc.parse () == true);
+	desc.prefetchBitmaps ("view");
+	auto b1 = desc.getBitmap ("b1");
+	EXPECT (b1);
+	EXPECT (b1->getResourceDescription ().u.name == std::string ("b1.png"));
+	auto b2 = dynamic_cast<CNinePartTiledBitmap*> (desc.getBitmap ("b2"));
+	EXPECT (b2);
+	EXPECT (b2->getPartOffsets ().left == 1 && b2->getPartOffsets ().bottom == 4);
+	EXPECT (desc.getBitmap ("b3"));
+	desc.freePlatformResources ();
+	desc.prefetchBitmaps ();
+	EXPECT (desc.getBitmap ("b3"));
+}
+
 TEST_CASE (UIDescriptionXMLTests, Tags)
 {
 	MemoryContentProvider provider (tagNodesUIDesc,
@@ -157,6 +157,10 @@ TEST_CASE (CSegmentButtonCreatorTest, TruncateMode)
 	    kCSegmentButton, kAttrTruncateMode, "tail", &uidesc, [] (CSegmentButton* v) {
 		    return v->getTextTruncateMode () == CDrawMethods::kTextTruncateTail;
 	    });
+	testAttribute<CSegmentButton> (
+	    kCSegmentButton, kAttrTruncateMode, "middle", &uidesc, [] (CSegmentButton* v) {
+		    return v->getTextTruncateMode () == CDrawMethods::kTextTruncateMiddle;
+	    });
 	testAttribute<CSegmentButton> (
 	    kCSegmentButton, kAttrTruncateMode, "", &uidesc, [] (CSegmentButton* v) {
 		    return v->getTextTruncateMode () == CDrawMethods::kTextTruncateNone;
@@ -166,7 +170,7 @@ TEST_CASE (CSegmentButtonCreatorTest, TruncateMode)
 TEST_CASE (CSegmentButtonCreatorTest, TruncateModeValues)
 {
 	DummyUIDescription uidesc;
-	testPossibleValues (kCSegmentButton, kAttrTruncateMode, &uidesc, {"head", "tail", "none"});
+	testPossibleValues (kCSegmentButton, kAttrTruncateMode, &uidesc, {"head", "tail", "middle", "none"});
 }
 
 TEST_CASE (CSegmentButtonCreatorTest, OrientationValues)
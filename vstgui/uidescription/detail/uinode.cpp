@@ -213,6 +213,44 @@ void UIControlTagNode::setTagString (const std::string& str)
 	tag = -1;
 }
 
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+PlatformBitmapDecoder::PlatformBitmapDecoder (DecodeFunc&& func) : func (std::move (func))
+{
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapDecoder::~PlatformBitmapDecoder () noexcept = default;
+
+//-----------------------------------------------------------------------------
+void PlatformBitmapDecoder::decode ()
+{
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		if (state != State::Pending)
+			return;
+		state = State::Decoding;
+	}
+	auto platformBitmap = func ();
+	{
+		std::lock_guard<std::mutex> guard (mutex);
+		result = platformBitmap;
+		func = nullptr;
+		state = State::Done;
+	}
+	doneCondition.notify_all ();
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr PlatformBitmapDecoder::get ()
+{
+	decode ();
+	std::unique_lock<std::mutex> lock (mutex);
+	doneCondition.wait (lock, [this] () { return state == State::Done; });
+	return result;
+}
+
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
@@ -234,6 +272,7 @@ void UIBitmapNode::freePlatformResources ()
 	if (bitmap)
 		bitmap->forget ();
 	bitmap = nullptr;
+	decoder = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -333,14 +372,87 @@ void UIBitmapNode::removeXMLData ()
 }
 
 //-----------------------------------------------------------------------------
-CBitmap* UIBitmapNode::createBitmap (const std::string& str, const BitmapVariant& variant) const
+auto UIBitmapNode::getBitmapVariant () const -> BitmapVariant
 {
+	int32_t tmpValue {};
+	CRect offsets;
+	if (attributes->getRectAttribute ("nineparttiled-offsets", offsets))
+	{
+		return CNinePartTiledDescription (offsets.left, offsets.top, offsets.right,
+										  offsets.bottom);
+	}
+	else if (attributes->getIntegerAttribute ("multiframe-num-frames", tmpValue))
+	{
+		CMultiFrameBitmapDescription multiFrameDesc {};
+		multiFrameDesc.numFrames = static_cast<uint16_t> (tmpValue);
+		if (attributes->getIntegerAttribute ("mulitframe-frames-per-row", tmpValue))
+			multiFrameDesc.framesPerRow = static_cast<uint16_t> (tmpValue);
+		attributes->getPointAttribute ("multiframe-size", multiFrameDesc.frameSize);
+		return multiFrameDesc;
+	}
+	return {};
+}
 
+//-----------------------------------------------------------------------------
+CBitmap* UIBitmapNode::createBitmap (const std::string& str, const BitmapVariant& variant,
+									 const PlatformBitmapPtr& platformBitmap) const
+{
 	if (auto partDesc = std::get_if<CNinePartTiledDescription> (&variant))
-		return new CNinePartTiledBitmap (CResourceDescription (str.data ()), *partDesc);
+		return new CNinePartTiledBitmap (CResourceDescription (str.data ()), platformBitmap,
+										 *partDesc);
 	else if (auto multiFrameDesc = std::get_if<CMultiFrameBitmapDescription> (&variant))
-		return new CMultiFrameBitmap (CResourceDescription (str.data ()), *multiFrameDesc);
-	return new CBitmap (CResourceDescription (str.c_str ()));
+		return new CMultiFrameBitmap (CResourceDescription (str.data ()), platformBitmap,
+									  *multiFrameDesc);
+	return new CBitmap (CResourceDescription (str.c_str ()), platformBitmap);
+}
+
+//-----------------------------------------------------------------------------
+auto UIBitmapNode::getBitmapSource (const std::string& pathHint, bool withData) const
+	-> BitmapSource
+{
+	BitmapSource source;
+	if (auto path = attributes->getAttributeValue ("path"))
+	{
+		source.path = *path;
+		if (pathIsAbsolute (pathHint))
+		{
+			std::string absPath = pathHint;
+			if (removeLastPathComponent (absPath))
+				source.absolutePath = absPath + "/" + *path;
+		}
+	}
+	if (withData)
+	{
+		if (auto node = dataNode ())
+		{
+			auto codecStr = node->getAttributes ()->getAttributeValue ("encoding");
+			if (codecStr && *codecStr == "base64")
+			{
+				source.base64Data = node->getData ();
+				attributes->getDoubleAttribute ("scale-factor", source.scaleFactor);
+			}
+		}
+	}
+	return source;
+}
+
+//-----------------------------------------------------------------------------
+PlatformBitmapPtr UIBitmapNode::decodePlatformBitmap (const BitmapSource& source)
+{
+	// only uses the copied source, so that it can run on any thread
+	auto platformBitmap =
+		getPlatformFactory ().createBitmap (CResourceDescription (source.path.data ()));
+	if (platformBitmap == nullptr && !source.absolutePath.empty ())
+		platformBitmap = getPlatformFactory ().createBitmapFromPath (source.absolutePath.data ());
+	if (platformBitmap == nullptr && !source.base64Data.empty ())
+	{
+		auto result = Base64Codec::decode (source.base64Data);
+		platformBitmap =
+			getPlatformFactory ().createBitmapFromMemory (result.data.get (), result.dataSize);
+		if (platformBitmap)
+			platformBitmap->setScaleFactor (source.scaleFactor);
+	}
+	return platformBitmap;
 }
 
 //------------------------------------------------------------------------
@@ -372,6 +484,16 @@ PlatformBitmapPtr UIBitmapNode::createBitmapFromDataNode () const
 	return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+auto UIBitmapNode::prefetchBitmap (const std::string& pathHint) -> DecoderPtr
+{
+	if (bitmap || decoder || !attributes->hasAttribute ("path"))
+		return nullptr;
+	decoder = std::make_shared<PlatformBitmapDecoder> (
+		[source = getBitmapSource (pathHint, true)] () { return decodePlatformBitmap (source); });
+	return decoder;
+}
+
 //-----------------------------------------------------------------------------
 CBitmap* UIBitmapNode::getBitmap (const std::string& pathHint)
 {
@@ -380,37 +502,16 @@ CBitmap* UIBitmapNode::getBitmap (const std::string& pathHint)
 		const std::string* path = attributes->getAttributeValue ("path");
 		if (path)
 		{
-			BitmapVariant bitmapVariant;
-			int32_t tmpValue {};
-			CRect offsets;
-			if (attributes->getRectAttribute ("nineparttiled-offsets", offsets))
-			{
-				bitmapVariant = CNinePartTiledDescription (offsets.left, offsets.top, offsets.right,
-														   offsets.bottom);
-			}
-			else if (attributes->getIntegerAttribute ("multiframe-num-frames", tmpValue))
-			{
-				CMultiFrameBitmapDescription multiFrameDesc {};
-				multiFrameDesc.numFrames = static_cast<uint16_t> (tmpValue);
-				if (attributes->getIntegerAttribute ("mulitframe-frames-per-row", tmpValue))
-					multiFrameDesc.framesPerRow = static_cast<uint16_t> (tmpValue);
-				attributes->getPointAttribute ("multiframe-size", multiFrameDesc.frameSize);
-				bitmapVariant = multiFrameDesc;
-			}
-			bitmap = createBitmap (*path, bitmapVariant);
-			if (bitmap->getPlatformBitmap () == nullptr && pathIsAbsolute (pathHint))
+			PlatformBitmapPtr platformBitmap;
+			if (decoder)
 			{
-				std::string absPath = pathHint;
-				if (removeLastPathComponent (absPath))
-				{
-					absPath += "/" + *path;
-					if (auto platformBitmap =
-					        getPlatformFactory ().createBitmapFromPath (absPath.c_str ()))
-					{
-						bitmap->setPlatformBitmap (platformBitmap);
-					}
-				}
+				platformBitmap = decoder->get ();
+				decoder = nullptr;
 			}
+			// the platform may not be able to decode on a worker thread, so try again here
+			if (platformBitmap == nullptr)
+				platformBitmap = decodePlatformBitmap (getBitmapSource (pathHint, false));
+			bitmap = createBitmap (*path, getBitmapVariant (), platformBitmap);
 		}
 		if (bitmap && bitmap->getPlatformBitmap () == nullptr)
 		{
@@ -439,6 +540,7 @@ void UIBitmapNode::setBitmap (UTF8StringPtr bitmapName)
 	if (bitmap)
 		bitmap->forget ();
 	bitmap = nullptr;
+	decoder = nullptr;
 	double scaleFactor = 1.;
 	if (Detail::decodeScaleFactorFromName (name, scaleFactor))
 		attributes->setDoubleAttribute ("scale-factor", scaleFactor);
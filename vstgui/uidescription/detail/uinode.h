@@ -9,6 +9,10 @@
 #include "../../lib/ccolor.h"
 #include "uidesclist.h"
 
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <variant>
 
 //------------------------------------------------------------------------
@@ -119,12 +123,50 @@ protected:
 	int32_t tag;
 };
 
+//-----------------------------------------------------------------------------
+/** decodes a platform bitmap once, either on a worker thread or on the first thread asking for it
+ */
+class PlatformBitmapDecoder
+{
+public:
+	using DecodeFunc = std::function<PlatformBitmapPtr ()>;
+
+	explicit PlatformBitmapDecoder (DecodeFunc&& func);
+	~PlatformBitmapDecoder () noexcept;
+
+	/** decode the bitmap if no other thread has started it yet */
+	void decode ();
+	/** decode the bitmap or wait until another thread has decoded it */
+	PlatformBitmapPtr get ();
+
+private:
+	enum class State
+	{
+		Pending,
+		Decoding,
+		Done
+	};
+
+	std::mutex mutex;
+	std::condition_variable doneCondition;
+	State state {State::Pending};
+	DecodeFunc func;
+	PlatformBitmapPtr result;
+};
+
 //-----------------------------------------------------------------------------
 class UIBitmapNode : public UINode
 {
 public:
+	using DecoderPtr = std::shared_ptr<PlatformBitmapDecoder>;
+
 	UIBitmapNode (const std::string& name, const SharedPointer<UIAttributes>& attributes);
 	CBitmap* getBitmap (const std::string& pathHint);
+	/** create a decoder for the platform bitmap which getBitmap waits for or takes over
+	 *
+	 *	@return the decoder to run on a worker thread or nullptr if there is nothing to decode
+	 */
+	DecoderPtr prefetchBitmap (const std::string& pathHint);
 	void setBitmap (UTF8StringPtr bitmapName);
 	void setMultiFrameDesc (const CMultiFrameBitmapDescription* desc);
 	void setNinePartTiledOffset (const CRect* offsets);
@@ -144,11 +186,23 @@ protected:
 	~UIBitmapNode () noexcept override;
 	using BitmapVariant =
 		std::variant<uint32_t, CNinePartTiledDescription, CMultiFrameBitmapDescription>;
-	CBitmap* createBitmap (const std::string& str, const BitmapVariant& variant) const;
+	struct BitmapSource
+	{
+		std::string path;
+		std::string absolutePath;
+		std::string base64Data;
+		double scaleFactor {1.};
+	};
+	BitmapVariant getBitmapVariant () const;
+	CBitmap* createBitmap (const std::string& str, const BitmapVariant& variant,
+						   const PlatformBitmapPtr& platformBitmap) const;
+	BitmapSource getBitmapSource (const std::string& pathHint, bool withData) const;
+	static PlatformBitmapPtr decodePlatformBitmap (const BitmapSource& source);
 	PlatformBitmapPtr createBitmapFromDataNode () const;
 	static bool imagesEqual (IPlatformBitmap* b1, IPlatformBitmap* b2);
 	UINode* dataNode () const;
 	CBitmap* bitmap;
+	DecoderPtr decoder;
 	bool filterProcessed;
 	bool scaledBitmapsAdded;
 };
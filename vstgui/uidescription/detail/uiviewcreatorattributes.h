@@ -333,6 +333,7 @@ static constexpr auto strVerticalInverse = "vertical-inverse";
 static constexpr auto strNone = "none";
 static constexpr auto strHead = "head";
 static constexpr auto strTail = "tail";
+static constexpr auto strMiddle = "middle";
 
 static constexpr auto strLeft = "left";
 static constexpr auto strRight = "right";
@@ -33,11 +33,14 @@
 #include "detail/uinode.h"
 #include "detail/uiviewcreatorattributes.h"
 #include "detail/uixmlpersistence.h"
+#include "../lib/workerpool.h"
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <deque>
+#include <unordered_set>
 
 namespace VSTGUI {
 
@@ -99,6 +102,18 @@ struct UIDescription::Impl : ListenerProvider<Impl, UIDescriptionListener>
 	
 	Optional<UINode*> variableBaseNode;
 
+	/** shared with the prefetch tasks on the worker pool, which stop decoding when it is set */
+	std::shared_ptr<std::atomic<bool>> cancelPrefetch {std::make_shared<std::atomic<bool>> (false)};
+
+	~Impl () noexcept { stopPrefetch (); }
+
+	/** a bitmap which is decoding while this is called finishes on its worker */
+	void stopPrefetch ()
+	{
+		*cancelPrefetch = true;
+		cancelPrefetch = std::make_shared<std::atomic<bool>> (false);
+	}
+
 	UINode* getVariableBaseNode ()
 	{
 		if (!variableBaseNode)
@@ -356,10 +371,95 @@ static void FreeNodePlatformResources (Detail::UINode* node)
 //-----------------------------------------------------------------------------
 void UIDescription::freePlatformResources ()
 {
+	impl->stopPrefetch ();
 	if (impl->nodes)
 		FreeNodePlatformResources (impl->nodes);
 }
 
+//-----------------------------------------------------------------------------
+static void CollectAttributeValues (Detail::UINode* node, std::unordered_set<std::string>& values)
+{
+	UIAttributes::StringArray names;
+	for (const auto& attribute : *node->getAttributes ())
+	{
+		// lists of names like the template-names of a view switch container are separated by commas
+		if (UIAttributes::stringToStringArray (attribute.second, names))
+			values.insert (names.begin (), names.end ());
+		names.clear ();
+	}
+	for (auto& child : node->getChildren ())
+		CollectAttributeValues (child, values);
+}
+
+//-----------------------------------------------------------------------------
+void UIDescription::prefetchBitmaps (UTF8StringPtr templateName)
+{
+	auto bitmapsNode = getBaseNode (Detail::MainNodeNames::kBitmap);
+	if (bitmapsNode == nullptr)
+		return;
+	// the bitmaps of a template are all names used as an attribute value in it or in a template it
+	// refers to
+	std::unordered_set<std::string> usedNames;
+	if (templateName)
+	{
+		std::unordered_set<const UINode*> visitedTemplates;
+		std::vector<UINode*> templates;
+		if (auto templateNode = findChildNodeByNameAttribute (impl->nodes, templateName))
+			templates.push_back (templateNode);
+		while (!templates.empty ())
+		{
+			auto templateNode = templates.back ();
+			templates.pop_back ();
+			if (!visitedTemplates.insert (templateNode).second)
+				continue;
+			std::unordered_set<std::string> values;
+			CollectAttributeValues (templateNode, values);
+			for (const auto& value : values)
+			{
+				auto node = findChildNodeByNameAttribute (impl->nodes, value.data ());
+				if (node && node->getName () == Detail::MainNodeNames::kTemplate)
+					templates.push_back (node);
+			}
+			usedNames.insert (values.begin (), values.end ());
+		}
+	}
+
+	auto decoders = std::make_shared<std::vector<Detail::UIBitmapNode::DecoderPtr>> ();
+	for (auto& child : bitmapsNode->getChildren ())
+	{
+		auto bitmapNode = dynamic_cast<Detail::UIBitmapNode*> (child);
+		if (bitmapNode == nullptr)
+			continue;
+		if (templateName)
+		{
+			auto name = bitmapNode->getAttributes ()->getAttributeValue ("name");
+			if (name == nullptr || usedNames.find (*name) == usedNames.end ())
+				continue;
+		}
+		if (auto decoder = bitmapNode->prefetchBitmap (impl->filePath))
+			decoders->push_back (decoder);
+	}
+	if (decoders->empty ())
+		return;
+
+	auto& pool = WorkerPool::instance ();
+	auto numTasks = std::min<size_t> (pool.getNumThreads (), decoders->size ());
+	auto nextDecoder = std::make_shared<std::atomic<size_t>> (0);
+	auto cancel = impl->cancelPrefetch;
+	for (auto i = 0u; i < numTasks; ++i)
+	{
+		pool.async ([decoders, nextDecoder, cancel] () {
+			while (!*cancel)
+			{
+				auto index = (*nextDecoder)++;
+				if (index >= decoders->size ())
+					break;
+				(*decoders)[index]->decode ();
+			}
+		});
+	}
+}
+
 //------------------------------------------------------------------------
 auto UIDescription::getRootNode () const -> SharedPointer<UINode>
 {
@@ -940,7 +1040,7 @@ CBitmap* UIDescription::getBitmap (UTF8StringPtr name) const
 		}
 		if (bitmap && bitmapNode->getFilterProcessed () == false)
 		{
-			std::list<SharedPointer<BitmapFilter::IFilter> > filters;
+			BitmapFilter::Pipeline filters;
 			for (auto& childNode : bitmapNode->getChildren ())
 			{
 				const std::string* filterName = nullptr;
@@ -949,7 +1049,7 @@ CBitmap* UIDescription::getBitmap (UTF8StringPtr name) const
 					auto filter = owned (BitmapFilter::Factory::getInstance().createFilter (filterName->c_str ()));
 					if (filter == nullptr)
 						continue;
-					filters.emplace_back (filter);
+					filters.addFilter (filter);
 					for (auto& propertyNode : childNode->getChildren ())
 					{
 						if (propertyNode->getName () != "property")
@@ -1010,17 +1110,10 @@ CBitmap* UIDescription::getBitmap (UTF8StringPtr name) const
 					}
 				}
 			}
-			for (auto& filter : filters)
+			if (!filters.empty ())
 			{
-				filter->setProperty (BitmapFilter::Standard::Property::kInputBitmap, bitmap);
-				if (filter->run ())
-				{
-					auto obj = filter->getProperty (BitmapFilter::Standard::Property::kOutputBitmap).getObject ();
-					if (auto* outputBitmap = dynamic_cast<CBitmap*>(obj))
-					{
-						bitmap->setPlatformBitmap (outputBitmap->getPlatformBitmap ());
-					}
-				}
+				if (auto outputBitmap = filters.run (bitmap))
+					bitmap->setPlatformBitmap (outputBitmap->getPlatformBitmap ());
 			}
 			bitmapNode->setFilterProcessed ();
 		}
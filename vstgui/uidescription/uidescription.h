@@ -150,6 +150,16 @@ public:
 	
 	void freePlatformResources ();
 
+	/** decode the bitmaps on worker threads
+	 *
+	 *	Call this after parse to move the decoding of the bitmaps out of the first createView.
+	 *	getBitmap takes over the decoding of a bitmap which was not started yet and waits for a
+	 *	bitmap which is still being decoded.
+	 *	@param templateName only decode the bitmaps used by this template and the templates it
+	 *	refers to, all bitmaps if nullptr
+	 */
+	void prefetchBitmaps (UTF8StringPtr templateName = nullptr);
+
 	static CViewAttributeID kTemplateNameAttributeID;
 
 	SharedPointer<UINode> getRootNode () const; // for testing
@@ -250,7 +250,7 @@ Attributes:
 - \b gradient [string]
 - \b gradient-highlighted [string]
 - \b segment-names [string array]
-- \b truncate-mode [head/tail/none]
+- \b truncate-mode [head/tail/middle/none]
 
 @section cslider CSlider
 Declaration:
@@ -517,10 +517,12 @@ bool getStandardAttributeListValues (const std::string& attributeName, std::list
 		static std::string kNone = strNone;
 		static std::string kHead = strHead;
 		static std::string kTail = strTail;
+		static std::string kMiddle = strMiddle;
 		
 		values.emplace_back (&kNone);
 		values.emplace_back (&kHead);
 		values.emplace_back (&kTail);
+		values.emplace_back (&kMiddle);
 		return true;
 	}
 	return false;
@@ -164,6 +164,8 @@ bool SegmentButtonCreator::apply (CView* view, const UIAttributes& attributes,
 			button->setTextTruncateMode (CDrawMethods::kTextTruncateHead);
 		else if (*attr == strTail)
 			button->setTextTruncateMode (CDrawMethods::kTextTruncateTail);
+		else if (*attr == strMiddle)
+			button->setTextTruncateMode (CDrawMethods::kTextTruncateMiddle);
 		else
 			button->setTextTruncateMode (CDrawMethods::kTextTruncateNone);
 	}
@@ -385,6 +387,7 @@ bool SegmentButtonCreator::getAttributeValue (CView* view, const string& attribu
 		{
 			case CDrawMethods::kTextTruncateHead: stringValue = strHead; break;
 			case CDrawMethods::kTextTruncateTail: stringValue = strTail; break;
+			case CDrawMethods::kTextTruncateMiddle: stringValue = strMiddle; break;
 			case CDrawMethods::kTextTruncateNone: stringValue = ""; break;
 		}
 		return true;
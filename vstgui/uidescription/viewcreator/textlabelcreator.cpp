@@ -77,6 +77,8 @@ bool TextLabelCreator::apply (CView* view, const UIAttributes& attributes,
 			label->setTextTruncateMode (CTextLabel::kTruncateHead);
 		else if (*attr == strTail)
 			label->setTextTruncateMode (CTextLabel::kTruncateTail);
+		else if (*attr == strMiddle)
+			label->setTextTruncateMode (CTextLabel::kTruncateMiddle);
 		else
 			label->setTextTruncateMode (CTextLabel::kTruncateNone);
 	}
@@ -126,6 +128,7 @@ bool TextLabelCreator::getAttributeValue (CView* view, const string& attributeNa
 		{
 			case CTextLabel::kTruncateHead: stringValue = strHead; break;
 			case CTextLabel::kTruncateTail: stringValue = strTail; break;
+			case CTextLabel::kTruncateMiddle: stringValue = strMiddle; break;
 			case CTextLabel::kTruncateNone: stringValue = ""; break;
 		}
 		return true;
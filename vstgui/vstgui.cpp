@@ -37,6 +37,7 @@
 #include "lib/pixelbuffer.cpp"
 #include "lib/vstguidebug.cpp"
 #include "lib/vstguiinit.cpp"
+#include "lib/workerpool.cpp"
 
 #include "lib/controls/cautoanimation.cpp"
 #include "lib/controls/cbuttons.cpp"